@@ -221,9 +221,26 @@ while(0)
 /* Round the kernel object size to the entry slot size */
 #define RME_KOM_ROUND(X)                            RME_ROUND_UP(X,RME_KOM_SLOT_ORDER)
 
+/* Whether a range is known to be zero before creation - never if deferred zeroing is off */
+#if(RME_KOT_ZERO_NUM!=0U)
+#define RME_KOT_CLEAN_CHK(KADDR,SIZE)               _RME_Kot_Clean_Chk((rme_ptr_t)(KADDR),(SIZE))
+#else
+#define RME_KOT_CLEAN_CHK(KADDR,SIZE)               (0U)
+#endif
+
 /* Capability Table **********************************************************/
-/* Capability size macro - always 8 full machine words */
+/* Capability size macro - always 8 full machine words, plus 2 for derivation tracking */
+#if(RME_CPT_DRV_ENABLE==0U)
 #define RME_CAP_SIZE                                (RME_WORD_BYTE*8U)
+#else
+#define RME_CAP_SIZE                                (RME_WORD_BYTE*10U)
+/* Derivation tracking relies on single-core kernel entry serialization */
+#if(RME_QUIE_TIME!=0U)
+#error Derivation tracking is not supported on multi-core systems.
+#endif
+/* Get the capability from its derivation list node */
+#define RME_CAP_DRV2CAP(X)                          ((struct RME_Cap_Struct*)(((rme_ptr_t)(X))-RME_WORD_BYTE*5U))
+#endif
 /* Capability table size calculation macro */
 #define RME_CPT_SIZE(NUM)                           (sizeof(struct RME_Cap_Struct)*(NUM))
 /* The operation inline macros on the capabilities */
@@ -465,6 +482,14 @@ do \
 } \
 while(0)
 
+/* Initialize the derivation list of a capability slot.
+ * CAP - The pointer to the capability slot. */
+#if(RME_CPT_DRV_ENABLE!=0U)
+#define RME_CAP_DRV_INIT(CAP)                       _RME_List_Crt(&((CAP)->Head.Drv))
+#else
+#define RME_CAP_DRV_INIT(CAP)
+#endif
+
 /* Check if we can take the slot, if we can, just take it. This also updates the timestamp,
  * so that we can enforce creation-freezing quiescence. We must update the counter after we
  * freeze the slot to ensure that we obtain exclusive access to it, and we must ensure that
@@ -480,6 +505,8 @@ do \
         return RME_ERR_CPT_EXIST; \
     /* We have taken the slot. Now log the quiescence counter in. No barrier needed as our atomics are serializing */ \
     (CAP)->Head.Timestamp=RME_TIMESTAMP; \
+    /* Start with an empty derivation list; leaves will be linked into their root's list */ \
+    RME_CAP_DRV_INIT(CAP); \
 } \
 while(0)
 
@@ -501,6 +528,83 @@ do \
 } \
 while(0)
 
+/* Walk a 2-level capability number down to the capability slot in the child table.
+ * This will not check the validity of the final slot; the caller shall do that.
+ * CPT - The current master capability table.
+ * CAP_NUM - The capability number. Only allows 2-level encoding.
+ * TYPE - When assigning the pointer to the PARAM, what struct pointer type should I cast it into?
+ * PARAM - The parameter to receive the pointer to the found capability slot.
+ * TEMP - A temporary variable, used to atomically keep a snapshot of Type_Ref when checking. */
+#define RME_CPT_WALK_2L(CPT,CAP_NUM,TYPE,PARAM,TEMP) \
+do \
+{ \
+    /* Check if the cap to potential captbl is over range */ \
+    if(RME_UNLIKELY(RME_CAP_H(CAP_NUM)>=((CPT)->Entry_Num))) \
+        return RME_ERR_CPT_RANGE; \
+    /* Get the cap slot */ \
+    (PARAM)=(TYPE)(&RME_CAP_GETOBJ(CPT,struct RME_Cap_Cpt*)[RME_CAP_H(CAP_NUM)]); \
+    /* Atomic read - Need a read acquire barrier here to avoid stale reads below */ \
+    (TEMP)=RME_READ_ACQUIRE(&((PARAM)->Head.Type_Stat)); \
+    /* See if the capability table is frozen for deletion or removal */ \
+    if(RME_UNLIKELY(RME_CAP_STAT(TEMP)==RME_CAP_STAT_FROZEN)) \
+        return RME_ERR_CPT_FROZEN; \
+    /* See if this is a captbl */ \
+    if(RME_UNLIKELY(RME_CAP_TYPE(TEMP)!=RME_CAP_TYPE_CPT)) \
+        return RME_ERR_CPT_TYPE; \
+    /* Check if the 2nd-layer captbl is over range */ \
+    if(RME_UNLIKELY(RME_CAP_L(CAP_NUM)>=(((struct RME_Cap_Cpt*)(PARAM))->Entry_Num))) \
+        return RME_ERR_CPT_RANGE; \
+    /* Get the cap slot */ \
+    (PARAM)=(TYPE)(&RME_CAP_GETOBJ(PARAM,struct RME_Cap_Struct*)[RME_CAP_L(CAP_NUM)]); \
+} \
+while(0)
+
+#if(RME_CPT_CACHE_NUM!=0U)
+/* Lookup cache position of a 2-level capability number in a master table */
+#define RME_CPT_CACHE_POS(CPT,CAP_NUM)              (((((rme_ptr_t)(CPT))>>RME_WORD_ORDER)^RME_CAP_H(CAP_NUM)^ \
+                                                      RME_CAP_L(CAP_NUM))&(RME_CPT_CACHE_NUM-1U))
+
+/* Resolve a 2-level capability number through the per-CPU lookup cache. The cache
+ * only remembers where the slot is; the caller will still check the validity of
+ * the final slot. The only thing that may make a cached slot pointer dangle is the
+ * removal or deletion of a captbl capability in the master table (or of the master
+ * table itself), which must be preceded by a freeze that bumps the generation. The
+ * generation is read before the walk, so a freeze that races with the fill makes the
+ * entry stale immediately. Any use of an entry filled before the freeze will fall
+ * into the freeze's quiescence period, as is the case with the uncached walk.
+ * CPT - The current master capability table.
+ * CAP_NUM - The capability number. Only allows 2-level encoding.
+ * TYPE - When assigning the pointer to the PARAM, what struct pointer type should I cast it into?
+ * PARAM - The parameter to receive the pointer to the found capability slot.
+ * TEMP - A temporary variable, used to atomically keep a snapshot of Type_Ref when checking. */
+#define RME_CPT_GETSLOT_2L(CPT,CAP_NUM,TYPE,PARAM,TEMP) \
+do \
+{ \
+    struct RME_Cpt_Cache* Cache_Ent; \
+    rme_ptr_t Cache_Gen; \
+    /* Atomic read - The generation must be observed before the walk */ \
+    Cache_Gen=RME_READ_ACQUIRE(&RME_Cpt_Cache_Gen); \
+    Cache_Ent=&(RME_CPU_LOCAL()->Cpt_Cache[RME_CPT_CACHE_POS(CPT,CAP_NUM)]); \
+    /* See if we hit the cache */ \
+    if(RME_LIKELY((Cache_Ent->Cpt==(CPT))&& \
+                  (Cache_Ent->Cap_Num==((rme_ptr_t)(CAP_NUM)))&& \
+                  (Cache_Ent->Gen==Cache_Gen))) \
+        (PARAM)=(TYPE)(Cache_Ent->Slot); \
+    else \
+    { \
+        /* Walk the tables and refill the entry if the walk succeeds */ \
+        RME_CPT_WALK_2L(CPT,CAP_NUM,TYPE,PARAM,TEMP); \
+        Cache_Ent->Cpt=(CPT); \
+        Cache_Ent->Cap_Num=(rme_ptr_t)(CAP_NUM); \
+        Cache_Ent->Gen=Cache_Gen; \
+        Cache_Ent->Slot=(struct RME_Cap_Struct*)(PARAM); \
+    } \
+} \
+while(0)
+#else
+#define RME_CPT_GETSLOT_2L(CPT,CAP_NUM,TYPE,PARAM,TEMP) RME_CPT_WALK_2L(CPT,CAP_NUM,TYPE,PARAM,TEMP)
+#endif
+
 /* Get the capability from the master table according to capability number encoding.
  * The read acquire is for handling the case where the other CPU is creating
  * the capability. Suppose we are now operating on an empty slot, and the other CPU
@@ -523,47 +627,20 @@ do \
         /* Check if the captbl is over range */ \
         if(RME_UNLIKELY(((rme_ptr_t)(CAP_NUM))>=((CPT)->Entry_Num))) \
             return RME_ERR_CPT_RANGE; \
-        /* Get the cap slot and check the type */ \
+        /* Get the cap slot */ \
         (PARAM)=(TYPE)(&RME_CAP_GETOBJ(CPT,struct RME_Cap_Struct*)[(CAP_NUM)]); \
-        /* Atomic read - Need a read acquire barrier here to avoid stale reads below */ \
-        (TEMP)=RME_READ_ACQUIRE(&((PARAM)->Head.Type_Stat)); \
-        /* See if the capability is frozen */ \
-        if(RME_UNLIKELY(RME_CAP_STAT(TEMP)==RME_CAP_STAT_FROZEN)) \
-            return RME_ERR_CPT_FROZEN; \
-        /* See if the type is correct */ \
-        if(RME_UNLIKELY(RME_CAP_TYPE(TEMP)!=(CAP_TYPE))) \
-            return RME_ERR_CPT_TYPE; \
     } \
     /* Yes, this is a 2-level cap */ \
     else \
-    { \
-        /* Check if the cap to potential captbl is over range */ \
-        if(RME_UNLIKELY(RME_CAP_H(CAP_NUM)>=((CPT)->Entry_Num))) \
-            return RME_ERR_CPT_RANGE; \
-        /* Get the cap slot */ \
-        (PARAM)=(TYPE)(&RME_CAP_GETOBJ(CPT,struct RME_Cap_Cpt*)[RME_CAP_H(CAP_NUM)]); \
-        /* Atomic read - Need a read acquire barrier here to avoid stale reads below */ \
-        (TEMP)=RME_READ_ACQUIRE(&((PARAM)->Head.Type_Stat)); \
-        /* See if the capability table is frozen for deletion or removal */ \
-        if(RME_UNLIKELY(RME_CAP_STAT(TEMP)==RME_CAP_STAT_FROZEN)) \
-            return RME_ERR_CPT_FROZEN; \
-        /* See if this is a captbl */ \
-        if(RME_UNLIKELY(RME_CAP_TYPE(TEMP)!=RME_CAP_TYPE_CPT)) \
-            return RME_ERR_CPT_TYPE; \
-        /* Check if the 2nd-layer captbl is over range */ \
-        if(RME_UNLIKELY(RME_CAP_L(CAP_NUM)>=(((struct RME_Cap_Cpt*)(PARAM))->Entry_Num))) \
-            return RME_ERR_CPT_RANGE; \
-        /* Get the cap slot and check the type */ \
-        (PARAM)=(TYPE)(&RME_CAP_GETOBJ(PARAM,struct RME_Cap_Struct*)[RME_CAP_L(CAP_NUM)]); \
-        /* Atomic read - Need a read acquire barrier here to avoid stale reads below */ \
-        (TEMP)=RME_READ_ACQUIRE(&((PARAM)->Head.Type_Stat)); \
-        /* See if the capability is frozen */ \
-        if(RME_UNLIKELY(RME_CAP_STAT(TEMP)==RME_CAP_STAT_FROZEN)) \
-            return RME_ERR_CPT_FROZEN; \
-        /* See if the type is correct */ \
-        if(RME_UNLIKELY(RME_CAP_TYPE(TEMP)!=(CAP_TYPE))) \
-            return RME_ERR_CPT_TYPE; \
-    } \
+        RME_CPT_GETSLOT_2L(CPT,CAP_NUM,TYPE,PARAM,TEMP); \
+    /* Atomic read - Need a read acquire barrier here to avoid stale reads below */ \
+    (TEMP)=RME_READ_ACQUIRE(&((PARAM)->Head.Type_Stat)); \
+    /* See if the capability is frozen */ \
+    if(RME_UNLIKELY(RME_CAP_STAT(TEMP)==RME_CAP_STAT_FROZEN)) \
+        return RME_ERR_CPT_FROZEN; \
+    /* See if the type is correct */ \
+    if(RME_UNLIKELY(RME_CAP_TYPE(TEMP)!=(CAP_TYPE))) \
+        return RME_ERR_CPT_TYPE; \
 } \
 while(0)
 
@@ -713,6 +790,13 @@ while(0)
 
 /*****************************************************************************/
 /* Generic *******************************************************************/
+/* List head structure */
+struct RME_List
+{
+    struct RME_List* Next;
+    struct RME_List* Prev;
+};
+
 /* Capability header structure */
 struct RME_Cap_Head
 {
@@ -726,6 +810,10 @@ struct RME_Cap_Head
     rme_ptr_t Object;
     /* The freeze timestamp */
     rme_ptr_t Timestamp;
+#if(RME_CPT_DRV_ENABLE!=0U)
+    /* The derivation list - list head for roots, list node for leaves */
+    struct RME_List Drv;
+#endif
 };
 
 /* Generic capability structure */
@@ -778,13 +866,6 @@ struct RME_Cap_Kom
 };
 
 /* Process and Thread ********************************************************/
-/* List head structure */
-struct RME_List
-{
-    struct RME_List* Next;
-    struct RME_List* Prev;
-};
-
 /* Per-CPU run queue structure */
 struct RME_Run_Struct
 {
@@ -807,7 +888,8 @@ struct RME_Cap_Prc
     /* A pointer to page table in trusted memory */
     rme_ptr_t Pgt;
 #endif
-    rme_ptr_t Info[1];
+    /* The pager signal endpoint, or RME_NULL if none - root cap only */
+    struct RME_Cap_Sig* Pgr;
 };
 
 /* Thread scheduling state structure */
@@ -926,6 +1008,43 @@ struct RME_Cap_Inv
     rme_ptr_t Info[3];
 };
 
+#if(RME_CPT_CACHE_NUM!=0U)
+/* Capability lookup cache entry for 2-level capability numbers */
+struct RME_Cpt_Cache
+{
+    /* The master capability table that the lookup started from */
+    struct RME_Cap_Cpt* Cpt;
+    /* The 2-level capability number */
+    rme_ptr_t Cap_Num;
+    /* The freeze generation when this entry was filled */
+    rme_ptr_t Gen;
+    /* The resolved capability slot */
+    struct RME_Cap_Struct* Slot;
+};
+#endif
+
+/* Kernel object table contention statistics */
+struct RME_Kot_Stat
+{
+    /* Number of failed markings */
+    rme_ptr_t Fail;
+    /* Number of CAS retries on words shared with neighbors */
+    rme_ptr_t Retry;
+    /* Number of markings that had to be rolled back */
+    rme_ptr_t Undo;
+};
+
+#if(RME_KOT_ZERO_NUM!=0U)
+/* Kernel memory range released by deletion and waiting to be zeroed */
+struct RME_Kot_Dirty
+{
+    /* The start address of the range */
+    rme_ptr_t Addr;
+    /* The size of the range that is yet to be zeroed */
+    rme_ptr_t Size;
+};
+#endif
+
 /* CPU-local data structure */
 struct RME_CPU_Local
 {
@@ -939,6 +1058,17 @@ struct RME_CPU_Local
     struct RME_Cap_Sig* Sig_Vct;
     /* The runqueue and bitmap */
     struct RME_Run_Struct Run;
+    /* The kernel object table statistics */
+    struct RME_Kot_Stat Kot_Stat;
+#if(RME_CPT_CACHE_NUM!=0U)
+    /* The 2-level capability lookup cache */
+    struct RME_Cpt_Cache Cpt_Cache[RME_CPT_CACHE_NUM];
+#endif
+#if(RME_KOT_ZERO_NUM!=0U)
+    /* The deferred zeroing stack */
+    rme_ptr_t Dirty_Num;
+    struct RME_Kot_Dirty Dirty[RME_KOT_ZERO_NUM];
+#endif
 };
 
 /* Kernel Function ***********************************************************/
@@ -1008,6 +1138,17 @@ static rme_ret_t _RME_Cpt_Add(struct RME_Cap_Cpt* Cpt,
 static rme_ret_t _RME_Cpt_Rem(struct RME_Cap_Cpt* Cpt,
                               rme_cid_t Cap_Cpt_Rem,
                               rme_cid_t Cap_Rem);
+static rme_ret_t _RME_Cpt_Mig(struct RME_Cap_Cpt* Cpt,
+                              rme_cid_t Cap_Cpt_Dst,
+                              rme_cid_t Cap_Cpt_Src,
+                              rme_ptr_t Begin,
+                              rme_ptr_t Num);
+#if(RME_CPT_DRV_ENABLE!=0U)
+static rme_ret_t _RME_Cpt_Rvk(struct RME_Cap_Cpt* Cpt,
+                              rme_cid_t Cap_Cpt_Rvk,
+                              rme_cid_t Cap_Rvk,
+                              rme_ptr_t Num);
+#endif
 
 /* Page Table ****************************************************************/
 /* Page table system calls */
@@ -1024,6 +1165,12 @@ static rme_ret_t _RME_Pgt_Crt(struct RME_Cap_Cpt* Cpt,
 static rme_ret_t _RME_Pgt_Del(struct RME_Cap_Cpt* Cpt,
                               rme_cid_t Cap_Cpt,
                               rme_cid_t Cap_Pgt);
+static rme_ret_t _RME_Pgt_Add_Entry(struct RME_Cap_Pgt* Pgt_Dst,
+                                    rme_ptr_t Pos_Dst,
+                                    rme_ptr_t Flag_Dst,
+                                    struct RME_Cap_Pgt* Pgt_Src,
+                                    rme_ptr_t Pos_Src,
+                                    rme_ptr_t Index);
 static rme_ret_t _RME_Pgt_Add(struct RME_Cap_Cpt* Cpt, 
                               rme_cid_t Cap_Pgt_Dst,
                               rme_ptr_t Pos_Dst,
@@ -1031,6 +1178,14 @@ static rme_ret_t _RME_Pgt_Add(struct RME_Cap_Cpt* Cpt,
                               rme_cid_t Cap_Pgt_Src,
                               rme_ptr_t Pos_Src,
                               rme_ptr_t Index);
+static rme_ret_t _RME_Pgt_Add_Rng(struct RME_Cap_Cpt* Cpt, 
+                                  rme_cid_t Cap_Pgt_Dst,
+                                  rme_ptr_t Pos_Dst,
+                                  rme_ptr_t Flag_Dst,
+                                  rme_cid_t Cap_Pgt_Src,
+                                  rme_ptr_t Pos_Src,
+                                  rme_ptr_t Index,
+                                  rme_ptr_t Num);
 static rme_ret_t _RME_Pgt_Rem(struct RME_Cap_Cpt* Cpt,
                               rme_cid_t Cap_Pgt,
                               rme_ptr_t Pos);
@@ -1043,13 +1198,34 @@ static rme_ret_t _RME_Pgt_Des(struct RME_Cap_Cpt* Cpt,
                               rme_cid_t Cap_Pgt_Parent,
                               rme_ptr_t Pos,
                               rme_cid_t Cap_Pgt_Child);
+/* Page table kernel functions */
+static rme_ret_t _RME_Pgt_Query(struct RME_Cap_Cpt* Cpt,
+                                rme_cid_t Cap_Pgt,
+                                rme_ptr_t Pos,
+                                rme_ptr_t Num,
+                                rme_ptr_t Buf);
 #endif
+/* Kernel Memory *************************************************************/
+static rme_ret_t _RME_Kot_Mark_Part(struct RME_CPU_Local* Local,
+                                    rme_ptr_t Pos,
+                                    rme_ptr_t Mask);
+#if(RME_KOT_ZERO_NUM!=0U)
+static void _RME_Kot_Bmp_Mod(rme_ptr_t* Bmp,
+                             rme_ptr_t Kaddr,
+                             rme_ptr_t Size,
+                             rme_ptr_t Set);
+static rme_ptr_t _RME_Kot_Zero(struct RME_CPU_Local* Local);
+#endif
+static rme_ret_t _RME_Kot_Stat_Get(struct RME_CPU_Local* Local,
+                                   rme_ptr_t Counter,
+                                   rme_ptr_t Clear);
 /* Process and Thread ********************************************************/
 /* In-kernel ready-queue primitives */
 static void _RME_Run_Ins(struct RME_Thd_Struct* Thd);
 static void _RME_Run_Del(struct RME_Thd_Struct* Thd);
 static struct RME_Thd_Struct* _RME_Run_High(struct RME_CPU_Local* Local);
 static void _RME_Run_Notif(struct RME_Thd_Struct* Thd);
+static rme_ret_t _RME_Run_Pgr(struct RME_Thd_Struct* Thd);
 static rme_ret_t _RME_Run_Swt(struct RME_Reg_Struct* Reg,
                               struct RME_Thd_Struct* Thd_Cur, 
                               struct RME_Thd_Struct* Thd_New);
@@ -1082,6 +1258,9 @@ static rme_ret_t _RME_Prc_Pgt(struct RME_Cap_Cpt* Cpt,
                               rme_cid_t Cap_Prc,
                               rme_ptr_t Raw_Pgt);
 #endif
+static rme_ret_t _RME_Prc_Pgr(struct RME_Cap_Cpt* Cpt,
+                              rme_cid_t Cap_Prc,
+                              rme_cid_t Cap_Sig);
 /* Thread system calls */
 static rme_ret_t _RME_Thd_Crt(struct RME_Cap_Cpt* Cpt,
                               rme_cid_t Cap_Cpt,
@@ -1194,7 +1373,14 @@ static rme_ret_t _RME_Kfn_Act(struct RME_Cap_Cpt* Cpt,
 #endif
 
 /*****************************************************************************/
-
+#if(RME_CPT_CACHE_NUM!=0U)
+/* Capability lookup cache generation - bumped whenever a captbl is frozen */
+__RME_EXTERN__ volatile rme_ptr_t RME_Cpt_Cache_Gen;
+#endif
+#if(RME_KOT_ZERO_NUM!=0U)
+/* Kernel object clean bitmap - set when the slot is known to be all zero */
+__RME_EXTERN__ rme_ptr_t RME_Kot_Clean[RME_KOT_WORD_NUM];
+#endif
 /*****************************************************************************/
 
 /* End Public Variable *******************************************************/
@@ -1304,6 +1490,10 @@ __RME_EXTERN__ rme_ret_t _RME_Kot_Mark(rme_ptr_t Kaddr,
                                        rme_ptr_t Size);
 __RME_EXTERN__ rme_ret_t _RME_Kot_Erase(rme_ptr_t Kaddr,
                                         rme_ptr_t Size);
+#if(RME_KOT_ZERO_NUM!=0U)
+__RME_EXTERN__ rme_ptr_t _RME_Kot_Clean_Chk(rme_ptr_t Kaddr,
+                                           rme_ptr_t Size);
+#endif
 /* Boot-time calls */
 __RME_EXTERN__ rme_ret_t _RME_Kom_Boot_Crt(struct RME_Cap_Cpt* Cpt,
                                            rme_cid_t Cap_Cpt,
@@ -1352,6 +1542,10 @@ __RME_EXTERN__ rme_ret_t _RME_Kern_Snd(struct RME_Cap_Sig* Sig,
                                        rme_ptr_t Number);
 __RME_EXTERN__ void _RME_Kern_High(struct RME_Reg_Struct* Reg,
                                    struct RME_CPU_Local* Local);
+/* Vector endpoint binding facilities */
+__RME_EXTERN__ rme_ret_t _RME_Kern_Sig_Bind(struct RME_Cap_Cpt* Cpt,
+                                            rme_cid_t Cap_Sig,
+                                            struct RME_Cap_Sig** Slot);
 /* Boot-time calls */
 __RME_EXTERN__ rme_ret_t _RME_Sig_Boot_Crt(struct RME_Cap_Cpt* Cpt,
                                            rme_cid_t Cap_Cpt,
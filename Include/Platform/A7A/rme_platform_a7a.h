@@ -94,7 +94,7 @@ typedef rme_s32_t rme_ret_t;
 /* Register access */
 #define RME_A7A_REG(X)                          (*((volatile rme_ptr_t*)(X)))
 /* CPU-local data structure location macro */
-#define RME_CPU_LOCAL()                         (&RME_A7A_Local)
+#define RME_CPU_LOCAL()                         (__RME_A7A_CPU_Local_Get())
 /* The order of bits in one CPU machine word */
 #define RME_WORD_ORDER                          (5U)
 /* Forcing VA=PA in user memory segments */
@@ -105,6 +105,28 @@ typedef rme_s32_t rme_ret_t;
 #define RME_CPT_LIMIT                           0
 /* Cpt size limit - not restricted */
 #define RME_CPT_ENTRY_MAX                       (0U)
+/* 2-level capability lookup cache entries, power of 2 - disabled */
+#define RME_CPT_CACHE_NUM                       (0U)
+/* Cpt migration slots processed per call */
+#define RME_CPT_MIG_MAX                         (16U)
+/* Capability derivation tracking - single-core only, disabled */
+#define RME_CPT_DRV_ENABLE                      (0U)
+/* Revoked capabilities per call */
+#define RME_CPT_RVK_MAX                         (16U)
+/* Kernel address of a checked user page - through the kernel linear mapping, as
+ * another core may change the user mapping between the check and the write */
+#define RME_PGT_KADDR(VADDR,PADDR)              RME_A7A_PA2VA(PADDR)
+/* Kernel object table CAS retries on words shared with neighbors */
+#define RME_KOT_RETRY_MAX                       (8U)
+/* Deferred zeroing entries per CPU - disabled */
+#define RME_KOT_ZERO_NUM                        (0U)
+/* Bytes zeroed per deferred zeroing call, multiple of slot size */
+#define RME_KOT_ZERO_CHUNK                      (256U)
+/* Pages mapped per batched page table add call */
+#define RME_PGT_ADD_MAX                         (16U)
+/* Batched page mapping hooks - no deferred hardware update */
+#define RME_PGT_BATCH_BEGIN(PGT)                ((void)(PGT))
+#define RME_PGT_BATCH_END(PGT)                  (0)
 /* Read timestamp counter */
 #define RME_TIMESTAMP                           (RME_A7A_Timestamp)
 /* Invocation stack maximum depth - not restricted */
@@ -194,7 +216,8 @@ typedef rme_s32_t rme_ret_t;
 
 #define RME_A7A_MMU_1M_PAGE_USER_COMMON (RME_A7A_MMU_1M_PAGE_PRESENT|RME_A7A_MMU_1M_USER| \
                                           RME_A7A_MMU_1M_SHAREABLE|RME_A7A_MMU_1M_NOTGLOBAL|RME_A7A_MMU_1M_ACCESS)
-#define RME_A7A_MMU_1M_PAGE_KERN_COMMON (RME_A7A_MMU_1M_PAGE_PRESENT|RME_A7A_MMU_1M_SHAREABLE|RME_A7A_MMU_1M_NOTGLOBAL|RME_A7A_MMU_1M_ACCESS)
+/* Kernel mappings are global so that they stay valid across ASID switches */
+#define RME_A7A_MMU_1M_PAGE_KERN_COMMON (RME_A7A_MMU_1M_PAGE_PRESENT|RME_A7A_MMU_1M_SHAREABLE|RME_A7A_MMU_1M_ACCESS)
 
 /* These definitions are only used by the initial page table */
 #define RME_A7A_MMU_1M_PAGE_USER_DEF    (RME_A7A_MMU_1M_PAGE_USER_COMMON|RME_A7A_MMU_1M_BUFFERABLE|RME_A7A_MMU_1M_CACHEABLE)
@@ -221,6 +244,14 @@ typedef rme_s32_t rme_ret_t;
 #define RME_A7A_MMU_1M_PAGE_ADDR(X)     ((X)&0xFFF00000U)
 #define RME_A7A_MMU_4K_PAGE_ADDR(X)     ((X)&0xFFFFF000U)
 
+/* Address space identifiers - the low 8 bits go into CONTEXTIDR, and the rest
+ * of the word is the generation. ASID 0 is never handed out to user tables */
+#define RME_A7A_ASID_BITS               (8U)
+#define RME_A7A_ASID_MASK               RME_MASK_END(RME_A7A_ASID_BITS-1U)
+#define RME_A7A_ASID_GEN(X)             ((X)>>RME_A7A_ASID_BITS)
+/* Maximum number of cores, used to size the per-core ASID bookkeeping */
+#define RME_A7A_CPU_NUM_MAX             (4U)
+
 #define RME_A7A_PGFLG_1M_RME2NAT(X)     (RME_A7A_Pgflg_1M_RME2NAT[X])
 #define RME_A7A_PGFLG_1M_PREPRC(X)      ((((X)&RME_A7A_MMU_1M_READONLY)>>12)| \
                                         (((X)&RME_A7A_MMU_1M_EXECUTENEVER)>>2)| \
@@ -287,6 +318,7 @@ typedef rme_s32_t rme_ret_t;
 #define RME_A7A_GICD_IPRIORITYR(X)      RME_A7A_SFR(RME_A7A_GICD_BASE,0x0400+(X)*4) /* 0-254 */
 /* Interrupt processor targets registers */
 #define RME_A7A_GICD_ITARGETSR(X)       RME_A7A_SFR(RME_A7A_GICD_BASE,0x0800+(X)*4) /* 0-7 */
+#define RME_A7A_GICD_ITARGETSR_B(X)     (*((volatile rme_u8_t*)((rme_ptr_t)(RME_A7A_GICD_BASE+0x0800+(X))))) /* 0-1019 */
 /* Interrupt configuration registers */
 #define RME_A7A_GICD_ICFGR(X)           RME_A7A_SFR(RME_A7A_GICD_BASE,0x0C00+(X)*4) /* 0-63 */
 /* Non-secure access control registers */
@@ -346,6 +378,13 @@ typedef rme_s32_t rme_ret_t;
 #define RME_A7A_GIC_GROUPING_P1S7       (6U)
 #define RME_A7A_GIC_GROUPING_P0S8       (7U)
 
+/* Global interrupt modification kernel function types */
+#define RME_A7A_KFN_INT_GLOBAL_MOD_AFF_GET      (0U)
+#define RME_A7A_KFN_INT_GLOBAL_MOD_AFF_SET      (1U)
+#define RME_A7A_KFN_INT_GLOBAL_MOD_CNT_GET      (2U)
+#define RME_A7A_KFN_INT_GLOBAL_MOD_STATE_GET    (3U)
+#define RME_A7A_KFN_INT_GLOBAL_MOD_STATE_SET    (4U)
+
 /* Timer definitions */
 /* global timer count register 0 */
 #define RME_A7A_GTWD_GTCR0              RME_A7A_SFR(RME_A7A_GTWD_BASE,0x0000)
@@ -733,13 +772,27 @@ static const rme_ptr_t RME_A7A_Pgflg_4K_NAT2RME[16]=
     0x00000005,0x00000001,0x00000015,0x00000011,
     0x0000000D,0x00000009,0x0000001D,0x00000019
 };
+
+/* The next ASID to hand out, with the generation in the upper bits */
+static volatile rme_ptr_t RME_A7A_ASID_Next;
+/* The generation that each core last invalidated its local TLB for */
+static rme_ptr_t RME_A7A_ASID_Flush[RME_A7A_CPU_NUM_MAX];
+/* The device interrupts that each core has taken */
+static rme_ptr_t RME_A7A_Int_Cnt[RME_A7A_CPU_NUM_MAX];
+/* Whether each core has finished booting and can take device interrupts */
+static volatile rme_ptr_t RME_A7A_CPU_Boot[RME_A7A_CPU_NUM_MAX];
 /*****************************************************************************/
 /* End Private Variable ******************************************************/
 
 /* Private Function **********************************************************/ 
 /*****************************************************************************/
 static void __RME_A7A_Int_Init(void);
+static void __RME_A7A_Timer_Local_Init(void);
 static void __RME_A7A_Timer_Init(void);
+static rme_ptr_t ___RME_A7A_ASID_Get(struct RME_Cap_Pgt* Pgt);
+static rme_ret_t __RME_A7A_Int_Global_Mod(rme_ptr_t Int_Num,
+                                          rme_ptr_t Operation,
+                                          rme_ptr_t Param);
 /*****************************************************************************/
 #define __RME_EXTERN__
 /* End Private Function ******************************************************/
@@ -755,7 +808,7 @@ static void __RME_A7A_Timer_Init(void);
 /* Timestamp counter */
 __RME_EXTERN__ rme_ptr_t RME_A7A_Timestamp;
 /* Cortex-A9 can have up to 4 cores. We hard-code it here */
-__RME_EXTERN__ struct RME_CPU_Local RME_A7A_Local;
+__RME_EXTERN__ struct RME_CPU_Local RME_A7A_Local[RME_A7A_CPU_NUM_MAX];
 /* ARMv6-M use simple kernel object table */
 __RME_EXTERN__ rme_ptr_t RME_A7A_Kot[RME_KOT_WORD_NUM];
 /* The memory layout of this chip */
@@ -1024,6 +1077,10 @@ RME_EXTERN void __RME_A7A_Wait_Int(void);
 /* Memory barriers */
 RME_EXTERN rme_ptr_t __RME_A7A_Read_Acquire(volatile rme_ptr_t* Ptr);
 RME_EXTERN void __RME_A7A_Write_Release(volatile rme_ptr_t* Ptr, rme_ptr_t Val);
+/* TLB shootdown */
+RME_EXTERN void __RME_A7A_TLB_Shootdown(void);
+/* Address space switching */
+RME_EXTERN void __RME_A7A_ASID_Switch(rme_ptr_t TTBR0, rme_ptr_t ASID, rme_ptr_t Flush);
 /* MSB counting */
 RME_EXTERN rme_ptr_t __RME_A7A_MSB_Get(rme_ptr_t Val);
 /* Debugging */
@@ -1047,6 +1104,9 @@ __RME_EXTERN__ void __RME_Svc_Param_Get(struct RME_Reg_Struct* Reg,
                                         rme_ptr_t* Param);
 __RME_EXTERN__ void __RME_Svc_Retval_Set(struct RME_Reg_Struct* Reg,
                                          rme_ret_t Retval);
+__RME_EXTERN__ void __RME_Svc_Pgr_Set(struct RME_Reg_Struct* Reg,
+                                      rme_ptr_t TID,
+                                      struct RME_Exc_Struct* Exc);
 /* Thread register sets */
 __RME_EXTERN__ void __RME_Thd_Reg_Init(rme_ptr_t Attr,rme_ptr_t Entry,rme_ptr_t Stack,rme_ptr_t Param,
                                        struct RME_Reg_Struct* Reg);
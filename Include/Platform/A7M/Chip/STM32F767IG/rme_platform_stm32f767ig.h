@@ -59,6 +59,13 @@ Description: The configuration file for STM32F767IG.
 #define RME_A7M_SYSTICK_VAL                             (2160000U)
 /* Number of MPU regions available */
 #define RME_A7M_REGION_NUM                              (8U)
+/* Dynamic MPU region replacement policy */
+#define RME_A7M_MPU_REPL                                RME_A7M_MPU_REPL_RAND
+/* Per-vector interrupt coalescing and rate limiting - disabled */
+#define RME_A7M_VCT_COAL_ENABLE                         (0U)
+/* Bypass top-halves registered at runtime, and how many vectors may have one - disabled */
+#define RME_A7M_VCT_BYP_ENABLE                          (0U)
+#define RME_A7M_VCT_BYP_NUM                             (8U)
 /* What is the FPU type? */
 #define RME_COP_NUM                                     (3U)
 #define RME_A7M_COP_FPV4_SP                             (1U)
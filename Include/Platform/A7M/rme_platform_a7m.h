@@ -106,6 +106,29 @@ typedef rme_s32_t rme_ret_t;
 #define RME_TIMESTAMP                           (RME_A7M_Timestamp)
 /* Cpt size limit - not restricted */
 #define RME_CPT_ENTRY_MAX                       (0U)
+/* 2-level capability lookup cache entries, power of 2 - disabled */
+#define RME_CPT_CACHE_NUM                       (0U)
+/* Cpt migration slots processed per call */
+#define RME_CPT_MIG_MAX                         (16U)
+/* Capability derivation tracking - single-core only, disabled */
+#define RME_CPT_DRV_ENABLE                      (0U)
+/* Revoked capabilities per call */
+#define RME_CPT_RVK_MAX                         (16U)
+/* Kernel address of a checked user page - the user one, as VA=PA */
+#define RME_PGT_KADDR(VADDR,PADDR)              (VADDR)
+/* Kernel object table CAS retries on words shared with neighbors */
+#define RME_KOT_RETRY_MAX                       (8U)
+/* Deferred zeroing entries per CPU - disabled */
+#define RME_KOT_ZERO_NUM                        (0U)
+/* Bytes zeroed per deferred zeroing call, multiple of slot size */
+#define RME_KOT_ZERO_CHUNK                      (256U)
+/* Pages mapped per batched page table add call */
+#define RME_PGT_ADD_MAX                         (16U)
+/* Batched page mapping hooks - MPU update deferred to the end */
+#define RME_PGT_BATCH_BEGIN(PGT)                __RME_A7M_Pgt_Batch_Begin(PGT)
+#define RME_PGT_BATCH_END(PGT)                  __RME_A7M_Pgt_Batch_End(PGT)
+/* Page table walk cache entries per address space */
+#define RME_PGT_WALK_CACHE_NUM                  (4U)
 /* Forcing VA=PA in user memory segments */
 #define RME_PGT_PHYS_ENABLE                     (1U)
 /* Normal page directory size calculation macro */
@@ -138,7 +161,15 @@ typedef rme_s32_t rme_ret_t;
 #define RME_RVM_VCT_SIG_SELF                    (1U)
 #define RME_RVM_VCT_SIG_INIT                    (2U)
 #define RME_RVM_VCT_SIG_NONE                    (3U)
-#define RME_RVM_FLAG_SET(B,S,N)                 ((volatile struct __RME_RVM_Flag*)((B)+((S)>>1)*(N)))
+/* Flag set layout - the index of the buffer that the kernel writes to, then two
+ * buffers. Each buffer holds the fast flags, the group word, the summary words
+ * if there are more flag words than bits in a word, and then the flag words */
+#define RME_RVM_FLAG_BUF(S)                     ((((S)/RME_WORD_BYTE)-1U)>>1)
+#define RME_RVM_FLAG_SUM(S)                     (((RME_RVM_FLAG_BUF(S)-2U)<=RME_WORD_BIT)?0U: \
+                                                 ((RME_RVM_FLAG_BUF(S)-2U+RME_WORD_BIT)/(RME_WORD_BIT+1U)))
+#define RME_RVM_FLAG_CUR(B)                     (*((volatile rme_ptr_t*)(B)))
+#define RME_RVM_FLAG_SET(B,S,N)                 ((volatile struct __RME_RVM_Flag*) \
+                                                 ((B)+RME_WORD_BYTE*(1U+RME_RVM_FLAG_BUF(S)*(N))))
 /* End System Macro **********************************************************/
 
 /* ARMv7-M Macro *************************************************************/
@@ -403,6 +434,7 @@ typedef rme_s32_t rme_ret_t;
 #define RME_A7M_MPU_DATA                        (sizeof(struct __RME_A7M_MPU_Data)/RME_WORD_BYTE)
 #define RME_A7M_PGT_TBL_NOM(X)                  (((rme_ptr_t*)(X))+RME_A7M_PGT_META)
 #define RME_A7M_PGT_TBL_TOP(X)                  (((rme_ptr_t*)(X))+RME_A7M_PGT_META+RME_A7M_MPU_DATA)
+#define RME_A7M_PGT_MPU(X)                      ((struct __RME_A7M_MPU_Data*)(((rme_ptr_t*)(X))+RME_A7M_PGT_META))
 /* Page entry bit definitions */
 #define RME_A7M_PGT_PRESENT                     RME_POW2(0U)
 #define RME_A7M_PGT_TERMINAL                    RME_POW2(1U)
@@ -413,6 +445,15 @@ typedef rme_s32_t rme_ret_t;
 /* MPU operation flag */
 #define RME_A7M_MPU_CLR                         (0U)
 #define RME_A7M_MPU_UPD                         (1U)
+/* Batched mapping state */
+#define RME_A7M_PGT_BATCH_NONE                   (0U)
+#define RME_A7M_PGT_BATCH_CLEAN                  (1U)
+#define RME_A7M_PGT_BATCH_DIRTY                  (2U)
+/* MPU dynamic region replacement policy - FIFO evicts exactly the region
+ * that is needed next on a cyclic working set larger than the MPU, while
+ * random replacement degrades gracefully; random is the default */
+#define RME_A7M_MPU_REPL_RAND                   (0U)
+#define RME_A7M_MPU_REPL_FIFO                   (1U)
 /* MPU definitions */
 /* Extract address for/from MPU */
 #define RME_A7M_MPU_ADDR(X)                     ((X)&0xFFFFFFE0U)
@@ -434,11 +475,27 @@ typedef rme_s32_t rme_ret_t;
 #define RME_A7M_KFN_PGT_ENTRY_MOD_FLAG_GET      (0U)
 #define RME_A7M_KFN_PGT_ENTRY_MOD_SZORD_GET     (1U)
 #define RME_A7M_KFN_PGT_ENTRY_MOD_NMORD_GET     (2U)
+#define RME_A7M_KFN_PGT_ENTRY_MOD_MISS_GET      (3U)
+#define RME_A7M_KFN_PGT_ENTRY_MOD_MISS_CLR      (4U)
 /* Interrupt source configuration */
 #define RME_A7M_KFN_INT_LOCAL_MOD_STATE_GET     (0U)
 #define RME_A7M_KFN_INT_LOCAL_MOD_STATE_SET     (1U)
 #define RME_A7M_KFN_INT_LOCAL_MOD_PRIO_GET      (2U)
 #define RME_A7M_KFN_INT_LOCAL_MOD_PRIO_SET      (3U)
+#define RME_A7M_KFN_INT_LOCAL_MOD_SIG_SET       (4U)
+#define RME_A7M_KFN_INT_LOCAL_MOD_COAL_SET      (5U)
+#define RME_A7M_KFN_INT_LOCAL_MOD_COAL_ACK      (6U)
+#define RME_A7M_KFN_INT_LOCAL_MOD_BYP_SET       (7U)
+#define RME_A7M_KFN_INT_LOCAL_MOD_BYP_ACK       (8U)
+/* Bypass top-half register operations */
+#define RME_A7M_VCT_BYP_OP_WRITE                (0U)
+#define RME_A7M_VCT_BYP_OP_MODIFY               (1U)
+#define RME_A7M_VCT_BYP_OP_CLEAR                (2U)
+#define RME_A7M_VCT_BYP_OP_TEST                 (3U)
+/* Register operations in each bypass top-half */
+#define RME_A7M_VCT_BYP_OP_NUM                  (4U)
+/* The system region, which holds the NVIC and MPU and is never for bypass */
+#define RME_A7M_VCT_BYP_SYS_BASE                (0xE0000000U)
 /* Cache identifier */
 #define RME_A7M_KFN_CACHE_ICACHE                (0U)
 #define RME_A7M_KFN_CACHE_DCACHE                (1U)
@@ -576,13 +633,18 @@ typedef rme_s32_t rme_ret_t;
 #undef __HDR_DEF__
 /*****************************************************************************/
 /* Handler *******************************************************************/
-/* Interrupt flag structure */
+/* Interrupt flag structure. The consumer flips the buffer index with an atomic
+ * exchange, after which the kernel only writes to the other buffer; it then
+ * drains the old buffer top-down, finding set bits with count-trailing-zeros
+ * on the group, summary and flag words in turn and clearing each word it
+ * reads. Without summary words, group bit i covers flag word i; with them,
+ * group bit i covers summary word i, whose bit j covers flag word i*W+j */
 struct __RME_RVM_Flag
 {
-    rme_ptr_t Lock;
     rme_ptr_t Fast;
     rme_ptr_t Group;
-    rme_ptr_t Flag[1024];
+    /* Summary words, then flag words */
+    rme_ptr_t Data[1];
 };
 
 /* Register Manipulation *****************************************************/
@@ -651,6 +713,62 @@ struct __RME_A7M_Raw_Pgt
     struct __RME_A7M_MPU_Entry Data[RME_A7M_REGION_NUM];
 };
 
+#if(RME_A7M_VCT_COAL_ENABLE!=0U)
+/* Interrupt coalescing policy and state of a vector */
+struct __RME_A7M_Vct_Coal
+{
+    /* The hits since the driver last acknowledged */
+    rme_ptr_t Hit;
+    /* The hits since the last signal */
+    rme_ptr_t Pend;
+    /* At most one signal per this many hits; 0 if there is no policy */
+    rme_ptr_t Num;
+    /* At most one signal per this many ticks */
+    rme_ptr_t Window;
+    /* The timestamp of the last signal */
+    rme_ptr_t Last;
+    /* Whether the vector stays masked after a signal until acknowledged */
+    rme_ptr_t Mask;
+};
+#endif
+
+#if((RME_A7M_VCT_BYP_ENABLE!=0U)&&(RME_PGT_RAW_ENABLE==0U))
+/* Register operation of a bypass top-half */
+struct RME_A7M_Vct_Byp_Op
+{
+    /* The operation type */
+    rme_ptr_t Type;
+    /* The register address, word aligned */
+    rme_ptr_t Addr;
+    /* The bits that the operation looks at or changes */
+    rme_ptr_t Mask;
+    /* The value to write, or to compare the masked read with */
+    rme_ptr_t Value;
+};
+
+/* Bypass top-half, laid out the same in user memory when registered */
+struct RME_A7M_Vct_Byp
+{
+    /* At most one signal per this many hits; 0 if only failed tests signal */
+    rme_ptr_t Num;
+    /* The number of register operations in use */
+    rme_ptr_t Op_Num;
+    struct RME_A7M_Vct_Byp_Op Op[RME_A7M_VCT_BYP_OP_NUM];
+};
+
+/* Bypass top-half installed on a vector */
+struct __RME_A7M_Vct_Byp_Slot
+{
+    /* The vector number plus one; 0 if the slot is free */
+    rme_ptr_t Vct;
+    /* The hits since the driver last acknowledged */
+    rme_ptr_t Hit;
+    /* The hits since the last signal */
+    rme_ptr_t Pend;
+    struct RME_A7M_Vct_Byp Byp;
+};
+#endif
+
 /* Page table metadata structure */
 #if(RME_PGT_RAW_ENABLE==0U)
 struct __RME_A7M_Pgt_Meta
@@ -666,13 +784,39 @@ struct __RME_A7M_Pgt_Meta
     rme_ptr_t Page_Flag;
 };
 
+/* Page table walk cache entry */
+struct __RME_A7M_Pgt_Cache
+{
+    /* The walk cache generation when this entry was filled in */
+    rme_ptr_t Gen;
+    /* The first and the last address of the cached page */
+    rme_ptr_t Start;
+    rme_ptr_t End;
+    /* The flags of the cached page */
+    rme_ptr_t Flag;
+    /* The page directory that contains the page, RME_NULL if unused */
+    struct __RME_A7M_Pgt_Meta* Meta;
+};
+
 /* MPU metadata structure */
 struct __RME_A7M_MPU_Data
 {
     /* Bitmap showing whether these are static or not */
     rme_ptr_t Static;
+    /* The next region to consider for FIFO replacement */
+    rme_ptr_t Hand;
+    /* The number of dynamic region misses of this process */
+    rme_ptr_t Miss;
+    /* The generation of the MPU data, renewed whenever it changes */
+    rme_ptr_t Gen;
     /* The MPU data itself */
     struct __RME_A7M_Raw_Pgt Raw;
+#if(RME_PGT_WALK_CACHE_NUM!=0U)
+    /* The next walk cache entry to replace */
+    rme_ptr_t Cache_Hand;
+    /* The walk cache of this address space */
+    struct __RME_A7M_Pgt_Cache Cache[RME_PGT_WALK_CACHE_NUM];
+#endif
 };
 #endif
 /*****************************************************************************/
@@ -699,7 +843,30 @@ struct __RME_A7M_MPU_Data
 /* If the header is not used in the public mode */
 #ifndef __HDR_PUBLIC__
 /*****************************************************************************/
-
+#if(RME_PGT_RAW_ENABLE==0U)
+/* Whether we are in a batched mapping, and whether the MPU needs an update */
+static rme_ptr_t RME_A7M_Pgt_Batch;
+/* The MPU data generation counter, and the MPU data currently loaded */
+static rme_ptr_t RME_A7M_MPU_Gen;
+static struct __RME_A7M_MPU_Data* RME_A7M_MPU_Cur;
+static rme_ptr_t RME_A7M_MPU_Cur_Gen;
+#endif
+#if((RME_PGT_RAW_ENABLE==0U)&&(RME_PGT_WALK_CACHE_NUM!=0U))
+/* The walk cache generation, bumped on each unmap to invalidate all entries */
+static rme_ptr_t RME_A7M_Pgt_Gen;
+#endif
+/* The signal endpoints that each vector is bound to, if any */
+static struct RME_Cap_Sig* RME_A7M_Vct_Sig[RME_RVM_PHYS_VCT_NUM];
+#if(RME_A7M_VCT_COAL_ENABLE!=0U)
+/* The coalescing policies, and the vectors held back until their window ends */
+static struct __RME_A7M_Vct_Coal RME_A7M_Vct_Coal[RME_RVM_PHYS_VCT_NUM];
+static rme_ptr_t RME_A7M_Vct_Defer[RME_ROUND_UP(RME_RVM_PHYS_VCT_NUM,RME_WORD_ORDER)>>RME_WORD_ORDER];
+#endif
+#if((RME_A7M_VCT_BYP_ENABLE!=0U)&&(RME_PGT_RAW_ENABLE==0U))
+/* The bypass top-halves, and which one each vector uses plus one, if any */
+static struct __RME_A7M_Vct_Byp_Slot RME_A7M_Vct_Byp[RME_A7M_VCT_BYP_NUM];
+static rme_u8_t RME_A7M_Vct_Byp_Map[RME_RVM_PHYS_VCT_NUM];
+#endif
 /*****************************************************************************/
 /* End Private Variable ******************************************************/
 
@@ -743,9 +910,25 @@ static void __RME_A7M_Flag_Fast(rme_ptr_t Base,
 static void __RME_A7M_Flag_Slow(rme_ptr_t Base,
                                 rme_ptr_t Size,
                                 rme_ptr_t Pos);
+#if(RME_A7M_VCT_COAL_ENABLE!=0U)
+static rme_ptr_t __RME_A7M_Vct_Coal(rme_ptr_t Vct_Num);
+static void __RME_A7M_Vct_Coal_Tim(void);
+#endif
+#if((RME_A7M_VCT_BYP_ENABLE!=0U)&&(RME_PGT_RAW_ENABLE==0U))
+static rme_ptr_t __RME_A7M_Vct_Byp(rme_ptr_t Vct_Num);
+static rme_ret_t __RME_A7M_Vct_Byp_Check(struct RME_Cap_Pgt* Pgt,
+                                         rme_ptr_t Addr,
+                                         rme_ptr_t Flag);
+static rme_ret_t __RME_A7M_Vct_Byp_Set(rme_ptr_t Vct_Num,
+                                       rme_ptr_t Addr);
+static void __RME_A7M_Vct_Byp_Drop(rme_ptr_t Start,
+                                   rme_ptr_t Order);
+#endif
 /* Page table ****************************************************************/
 #if(RME_PGT_RAW_ENABLE==0U)
+#if(RME_A7M_MPU_REPL!=RME_A7M_MPU_REPL_FIFO)
 static rme_ptr_t __RME_A7M_Rand(void);
+#endif
 static rme_ptr_t ___RME_A7M_MPU_RASR_Gen(rme_ptr_t* Table,
                                          rme_ptr_t Flag, 
                                          rme_ptr_t Size_Order,
@@ -754,6 +937,9 @@ static rme_ret_t ___RME_A7M_MPU_Clear(struct __RME_A7M_MPU_Data* Top_MPU,
                                       rme_ptr_t Base_Addr,
                                       rme_ptr_t Size_Order,
                                       rme_ptr_t Num_Order);
+static rme_u8_t ___RME_A7M_MPU_Victim(struct __RME_A7M_MPU_Data* Top_MPU,
+                                      rme_u8_t* Dynamic,
+                                      rme_ptr_t Dynamic_Cnt);
 static rme_ret_t ___RME_A7M_MPU_Add(struct __RME_A7M_MPU_Data* Top_MPU, 
                                     rme_ptr_t Base_Addr,
                                     rme_ptr_t Size_Order,
@@ -767,6 +953,14 @@ static rme_ptr_t ___RME_A7M_Pgt_Have_Page(rme_ptr_t* Table,
 static rme_ptr_t ___RME_A7M_Pgt_Have_Pgdir(rme_ptr_t* Table,
                                            rme_ptr_t Num_Order);
 static void ___RME_A7M_Pgt_Refresh(void);
+#if(RME_PGT_WALK_CACHE_NUM!=0U)
+static struct __RME_A7M_Pgt_Cache* ___RME_A7M_Pgt_Cache_Find(struct __RME_A7M_Pgt_Meta* Top,
+                                                             rme_ptr_t Vaddr);
+static void ___RME_A7M_Pgt_Cache_Fill(struct __RME_A7M_Pgt_Meta* Top,
+                                      struct __RME_A7M_Pgt_Meta* Meta,
+                                      rme_ptr_t Start,
+                                      rme_ptr_t Flag);
+#endif
 #endif
 /* Kernel function ***********************************************************/
 #if(RME_PGT_RAW_ENABLE==0U)
@@ -775,7 +969,8 @@ static rme_ret_t __RME_A7M_Pgt_Entry_Mod(struct RME_Cap_Cpt* Cpt,
                                          rme_ptr_t Vaddr,
                                          rme_ptr_t Type);
 #endif
-static rme_ret_t __RME_A7M_Int_Local_Mod(rme_ptr_t Int_Num,
+static rme_ret_t __RME_A7M_Int_Local_Mod(struct RME_Cap_Cpt* Cpt,
+                                         rme_ptr_t Int_Num,
                                          rme_ptr_t Operation,
                                          rme_ptr_t Param);
 static rme_ret_t __RME_A7M_Int_Local_Trig(rme_ptr_t CPUID,
@@ -894,6 +1089,9 @@ __RME_EXTERN__ void __RME_Svc_Param_Get(struct RME_Reg_Struct* Reg,
                                         rme_ptr_t* Param);
 __RME_EXTERN__ void __RME_Svc_Retval_Set(struct RME_Reg_Struct* Reg,
                                          rme_ret_t Retval);
+__RME_EXTERN__ void __RME_Svc_Pgr_Set(struct RME_Reg_Struct* Reg,
+                                      rme_ptr_t TID,
+                                      struct RME_Exc_Struct* Exc);
 /* Thread register set */
 __RME_EXTERN__ void __RME_Thd_Reg_Init(rme_ptr_t Attr,
                                        rme_ptr_t Entry,
@@ -952,6 +1150,9 @@ __RME_EXTERN__ rme_ret_t __RME_Pgt_Page_Map(struct RME_Cap_Pgt* Pgt_Op,
                                             rme_ptr_t Flag);
 __RME_EXTERN__ rme_ret_t __RME_Pgt_Page_Unmap(struct RME_Cap_Pgt* Pgt_Op,
                                               rme_ptr_t Pos);
+/* Batched mapping */
+__RME_EXTERN__ void __RME_A7M_Pgt_Batch_Begin(struct RME_Cap_Pgt* Pgt_Op);
+__RME_EXTERN__ rme_ret_t __RME_A7M_Pgt_Batch_End(struct RME_Cap_Pgt* Pgt_Op);
 __RME_EXTERN__ rme_ret_t __RME_Pgt_Pgdir_Map(struct RME_Cap_Pgt* Pgt_Parent,
                                              rme_ptr_t Pos, 
                                              struct RME_Cap_Pgt* Pgt_Child,
@@ -63,6 +63,13 @@ Description : The configuration file for CH32V307VC. This chip carries multiple
 #define RME_RV32P_OSTIM_VAL                             (1440000U)
 /* Number of MPU regions available - nonstandard implementation, only 3 available */
 #define RME_RV32P_REGION_NUM                            (3U)
+/* Dynamic PMP range replacement policy */
+#define RME_RV32P_PMP_REPL                              RME_RV32P_PMP_REPL_RAND
+/* Largest gap in bytes that PMP ranges may be merged across - this memory becomes accessible */
+#define RME_RV32P_PMP_COAL_TOL                          (0U)
+/* Bypass top-halves registered at runtime, and how many vectors may have one - disabled */
+#define RME_RV32P_VCT_BYP_ENABLE                        (0U)
+#define RME_RV32P_VCT_BYP_NUM                           (8U)
 /* What is the FPU type? */
 #define RME_COP_NUM                                     (1U)
 #define RME_RV32P_COP_RVF                               (1U)
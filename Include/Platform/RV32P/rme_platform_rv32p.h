@@ -106,6 +106,29 @@ typedef rme_s32_t rme_ret_t;
 #define RME_TIMESTAMP                           (RME_RV32P_Timestamp)
 /* Cpt size limit - not restricted */
 #define RME_CPT_ENTRY_MAX                       (0U)
+/* 2-level capability lookup cache entries, power of 2 - disabled */
+#define RME_CPT_CACHE_NUM                       (0U)
+/* Cpt migration slots processed per call */
+#define RME_CPT_MIG_MAX                         (16U)
+/* Capability derivation tracking - single-core only, disabled */
+#define RME_CPT_DRV_ENABLE                      (0U)
+/* Revoked capabilities per call */
+#define RME_CPT_RVK_MAX                         (16U)
+/* Kernel address of a checked user page - the user one, as VA=PA */
+#define RME_PGT_KADDR(VADDR,PADDR)              (VADDR)
+/* Kernel object table CAS retries on words shared with neighbors */
+#define RME_KOT_RETRY_MAX                       (8U)
+/* Deferred zeroing entries per CPU - disabled */
+#define RME_KOT_ZERO_NUM                        (0U)
+/* Bytes zeroed per deferred zeroing call, multiple of slot size */
+#define RME_KOT_ZERO_CHUNK                      (256U)
+/* Pages mapped per batched page table add call */
+#define RME_PGT_ADD_MAX                         (16U)
+/* Batched page mapping hooks - no deferred hardware update */
+#define RME_PGT_BATCH_BEGIN(PGT)                ((void)(PGT))
+#define RME_PGT_BATCH_END(PGT)                  (0)
+/* Page table walk cache entries per address space */
+#define RME_PGT_WALK_CACHE_NUM                  (4U)
 /* Forcing VA=PA in user memory segments */
 #define RME_PGT_PHYS_ENABLE                     (1U)
 /* Normal page directory size calculation macro */
@@ -141,7 +164,15 @@ typedef rme_s32_t rme_ret_t;
 #define RME_RVM_VCT_SIG_SELF                    (1U)
 #define RME_RVM_VCT_SIG_INIT                    (2U)
 #define RME_RVM_VCT_SIG_NONE                    (3U)
-#define RME_RVM_FLAG_SET(B, S, N)               ((volatile struct __RME_RVM_Flag*)((B)+((S)>>1)*(N)))
+/* Flag set layout - the index of the buffer that the kernel writes to, then two
+ * buffers. Each buffer holds the fast flags, the group word, the summary words
+ * if there are more flag words than bits in a word, and then the flag words */
+#define RME_RVM_FLAG_BUF(S)                   ((((S)/RME_WORD_BYTE)-1U)>>1)
+#define RME_RVM_FLAG_SUM(S)                   (((RME_RVM_FLAG_BUF(S)-2U)<=RME_WORD_BIT)?0U: \
+                                               ((RME_RVM_FLAG_BUF(S)-2U+RME_WORD_BIT)/(RME_WORD_BIT+1U)))
+#define RME_RVM_FLAG_CUR(B)                   (*((volatile rme_ptr_t*)(B)))
+#define RME_RVM_FLAG_SET(B,S,N)               ((volatile struct __RME_RVM_Flag*) \
+                                               ((B)+RME_WORD_BYTE*(1U+RME_RVM_FLAG_BUF(S)*(N))))
 /* End System Macro **********************************************************/
 
 /* RV32P Macro ***************************************************************/
@@ -164,6 +195,9 @@ do \
 } \
 while(0)
 
+/* MCOUNTEREN - user mode may read the cycle counter, for timestamping */
+#define RME_RV32P_MCOUNTEREN_INIT               (0x00000001U)
+
 /* MSTATUS FPU states */
 #define RME_RV32P_MSTATUS_FPU_MASK              (0x00006000U)
 #define RME_RV32P_MSTATUS_FPU_OFF               (0x00000000U)
@@ -282,6 +316,13 @@ while(0)
 #define RME_RV32P_PMP_DATA                      (sizeof(struct __RME_RV32P_PMP_Data)/RME_WORD_BYTE)
 #define RME_RV32P_PGT_TBL_NOM(X)                (((rme_ptr_t*)(X))+RME_RV32P_PGT_META)
 #define RME_RV32P_PGT_TBL_TOP(X)                (((rme_ptr_t*)(X))+RME_RV32P_PGT_META+RME_RV32P_PMP_DATA)
+#define RME_RV32P_PGT_PMP(X)                    ((struct __RME_RV32P_PMP_Data*)(((rme_ptr_t*)(X))+RME_RV32P_PGT_META))
+
+/* PMP dynamic range replacement policy - FIFO evicts exactly the range
+ * that is needed next on a cyclic working set larger than the PMP, while
+ * random replacement degrades gracefully; random is the default */
+#define RME_RV32P_PMP_REPL_RAND                 (0U)
+#define RME_RV32P_PMP_REPL_FIFO                 (1U)
 
 /* Page entry bit definitions */
 #define RME_RV32P_PGT_PRESENT                   RME_POW2(0U)
@@ -293,21 +334,6 @@ while(0)
 
 /* Merge flag permissions */
 #define RME_RV32P_PGT_MERGE(X)                  ((X)&(RME_PGT_READ|RME_PGT_WRITE|RME_PGT_EXECUTE))
-/* Decide entry mode */
-#define RME_RV32P_PGT_MODE(X) \
-do \
-{ \
-    Size_Div4=(X).End_Div4-(X).Start_Div4; \
-    if(RME_ISPOW2(Size_Div4)) \
-    { \
-        (X).Order_Div4=RME_MSB_GET(Size_Div4); \
-    } \
-    else \
-    { \
-        (X).Order_Div4=0U; \
-    } \
-} \
-while(0)
 
 /* Write info to PMP */
 #define RME_RV32P_PMP_PERM(X)                   ((X)&0x07U)
@@ -324,11 +350,23 @@ while(0)
 #define RME_RV32P_KFN_PGT_ENTRY_MOD_FLAG_GET    (0U)
 #define RME_RV32P_KFN_PGT_ENTRY_MOD_SZORD_GET   (1U)
 #define RME_RV32P_KFN_PGT_ENTRY_MOD_NMORD_GET   (2U)
+#define RME_RV32P_KFN_PGT_ENTRY_MOD_MISS_GET    (3U)
+#define RME_RV32P_KFN_PGT_ENTRY_MOD_MISS_CLR    (4U)
 /* Interrupt source configuration */
 #define RME_RV32P_KFN_INT_LOCAL_MOD_STATE_GET   (0U)
 #define RME_RV32P_KFN_INT_LOCAL_MOD_STATE_SET   (1U)
 #define RME_RV32P_KFN_INT_LOCAL_MOD_PRIO_GET    (2U)
 #define RME_RV32P_KFN_INT_LOCAL_MOD_PRIO_SET    (3U)
+#define RME_RV32P_KFN_INT_LOCAL_MOD_SIG_SET     (4U)
+#define RME_RV32P_KFN_INT_LOCAL_MOD_BYP_SET     (5U)
+#define RME_RV32P_KFN_INT_LOCAL_MOD_BYP_ACK     (6U)
+/* Bypass top-half register operations */
+#define RME_RV32P_VCT_BYP_OP_WRITE              (0U)
+#define RME_RV32P_VCT_BYP_OP_MODIFY             (1U)
+#define RME_RV32P_VCT_BYP_OP_CLEAR              (2U)
+#define RME_RV32P_VCT_BYP_OP_TEST               (3U)
+/* Register operations in each bypass top-half */
+#define RME_RV32P_VCT_BYP_OP_NUM                (4U)
 /* Prefetcher modification */
 #define RME_RV32P_KFN_PRFTH_MOD_STATE_GET       (0U)
 #define RME_RV32P_KFN_PRFTH_MOD_STATE_SET       (1U)
@@ -436,13 +474,18 @@ while(0)
 #undef __HDR_DEF__
 /*****************************************************************************/
 /* Handler *******************************************************************/
-/* Interrupt flag structure */
+/* Interrupt flag structure. The consumer flips the buffer index with an atomic
+ * exchange, after which the kernel only writes to the other buffer; it then
+ * drains the old buffer top-down, finding set bits with count-trailing-zeros
+ * on the group, summary and flag words in turn and clearing each word it
+ * reads. Without summary words, group bit i covers flag word i; with them,
+ * group bit i covers summary word i, whose bit j covers flag word i*W+j */
 struct __RME_RVM_Flag
 {
-    rme_ptr_t Lock;
     rme_ptr_t Fast;
     rme_ptr_t Group;
-    rme_ptr_t Flag[1024];
+    /* Summary words, then flag words */
+    rme_ptr_t Data[1];
 };
 
 /* Register Manipulation *****************************************************/
@@ -597,12 +640,36 @@ struct __RME_RV32P_Pgt_Meta
     rme_ptr_t Order;
 };
 
+/* Page table walk cache entry */
+struct __RME_RV32P_Pgt_Cache
+{
+    /* The walk cache generation when this entry was filled in */
+    rme_ptr_t Gen;
+    /* The first and the last address of the cached page */
+    rme_ptr_t Start;
+    rme_ptr_t End;
+    /* The flags of the cached page */
+    rme_ptr_t Flag;
+    /* The page directory that contains the page, RME_NULL if unused */
+    struct __RME_RV32P_Pgt_Meta* Meta;
+};
+
 struct __RME_RV32P_PMP_Data
 {
     /* Bitmap showing whether these are static or not */
     rme_ptr_t Static;
+    /* The next range to consider for FIFO replacement */
+    rme_ptr_t Hand;
+    /* The number of PMP misses of this process */
+    rme_ptr_t Miss;
     /* The MPU data itself */
     struct __RME_RV32P_Raw_Pgt Raw;
+#if(RME_PGT_WALK_CACHE_NUM!=0U)
+    /* The next walk cache entry to replace */
+    rme_ptr_t Cache_Hand;
+    /* The walk cache of this address space */
+    struct __RME_RV32P_Pgt_Cache Cache[RME_PGT_WALK_CACHE_NUM];
+#endif
 };
 
 /* Decode struct for ease of processing - all address divided by 4 */
@@ -617,6 +684,43 @@ struct __RME_RV32P_PMP_Range
     rme_ptr_t Order_Div4;
 };
 #endif
+
+#if((RME_RV32P_VCT_BYP_ENABLE!=0U)&&(RME_PGT_RAW_ENABLE==0U))
+/* Register operation of a bypass top-half */
+struct RME_RV32P_Vct_Byp_Op
+{
+    /* The operation type */
+    rme_ptr_t Type;
+    /* The register address, word aligned */
+    rme_ptr_t Addr;
+    /* The bits that the operation looks at or changes */
+    rme_ptr_t Mask;
+    /* The value to write, or to compare the masked read with */
+    rme_ptr_t Value;
+};
+
+/* Bypass top-half, laid out the same in user memory when registered */
+struct RME_RV32P_Vct_Byp
+{
+    /* At most one signal per this many hits; 0 if only failed tests signal */
+    rme_ptr_t Num;
+    /* The number of register operations in use */
+    rme_ptr_t Op_Num;
+    struct RME_RV32P_Vct_Byp_Op Op[RME_RV32P_VCT_BYP_OP_NUM];
+};
+
+/* Bypass top-half installed on a vector */
+struct __RME_RV32P_Vct_Byp_Slot
+{
+    /* The vector number plus one; 0 if the slot is free */
+    rme_ptr_t Vct;
+    /* The hits since the driver last acknowledged */
+    rme_ptr_t Hit;
+    /* The hits since the last signal */
+    rme_ptr_t Pend;
+    struct RME_RV32P_Vct_Byp Byp;
+};
+#endif
 /*****************************************************************************/
 /* __RME_PLATFORM_RV32P_STRUCT__ */
 #endif
@@ -641,7 +745,17 @@ struct __RME_RV32P_PMP_Range
 /* If the header is not used in the public mode */
 #ifndef __HDR_PUBLIC__
 /*****************************************************************************/
-
+#if((RME_PGT_RAW_ENABLE==0U)&&(RME_PGT_WALK_CACHE_NUM!=0U))
+/* The walk cache generation, bumped on each unmap to invalidate all entries */
+static rme_ptr_t RME_RV32P_Pgt_Gen;
+#endif
+/* The signal endpoints that each vector is bound to, if any */
+static struct RME_Cap_Sig* RME_RV32P_Vct_Sig[RME_RVM_PHYS_VCT_NUM];
+#if((RME_RV32P_VCT_BYP_ENABLE!=0U)&&(RME_PGT_RAW_ENABLE==0U))
+/* The bypass top-halves, and which one each vector uses plus one, if any */
+static struct __RME_RV32P_Vct_Byp_Slot RME_RV32P_Vct_Byp[RME_RV32P_VCT_BYP_NUM];
+static rme_u8_t RME_RV32P_Vct_Byp_Map[RME_RVM_PHYS_VCT_NUM];
+#endif
 /*****************************************************************************/
 /* End Private Variable ******************************************************/
 
@@ -689,9 +803,21 @@ static void __RME_RV32P_Flag_Fast(rme_ptr_t Base,
 static void __RME_RV32P_Flag_Slow(rme_ptr_t Base,
                                   rme_ptr_t Size,
                                   rme_ptr_t Pos);
+#if((RME_RV32P_VCT_BYP_ENABLE!=0U)&&(RME_PGT_RAW_ENABLE==0U))
+static rme_ptr_t __RME_RV32P_Vct_Byp(rme_ptr_t Vct_Num);
+static rme_ret_t __RME_RV32P_Vct_Byp_Check(struct RME_Cap_Pgt* Pgt,
+                                           rme_ptr_t Addr,
+                                           rme_ptr_t Flag);
+static rme_ret_t __RME_RV32P_Vct_Byp_Set(rme_ptr_t Vct_Num,
+                                         rme_ptr_t Addr);
+static void __RME_RV32P_Vct_Byp_Drop(rme_ptr_t Start,
+                                     rme_ptr_t Order);
+#endif
 /* Page table ****************************************************************/
 #if(RME_PGT_RAW_ENABLE==0U)
+#if(RME_RV32P_PMP_REPL!=RME_RV32P_PMP_REPL_FIFO)
 static rme_ptr_t __RME_RV32P_Rand(void);
+#endif
 static rme_ptr_t ___RME_RV32P_PMP_Decode(struct __RME_RV32P_PMP_Data* Top_Data,
                                          struct __RME_RV32P_PMP_Range* Range);
 static void ___RME_RV32P_PMP_Range_Ins(struct __RME_RV32P_PMP_Range* Range,
@@ -700,13 +826,19 @@ static void ___RME_RV32P_PMP_Range_Ins(struct __RME_RV32P_PMP_Range* Range,
 static void ___RME_RV32P_PMP_Range_Del(struct __RME_RV32P_PMP_Range* Range,
                                        rme_ptr_t Number,
                                        rme_ptr_t Pos);
+static rme_ptr_t ___RME_RV32P_PMP_Range_Merge(struct __RME_RV32P_PMP_Range* Range,
+                                              rme_ptr_t Number,
+                                              rme_ptr_t Gap_Div4,
+                                              rme_ptr_t* Add);
 static rme_ptr_t ___RME_RV32P_PMP_Range_Entry(struct __RME_RV32P_PMP_Range* Range,
                                               rme_ptr_t Number);
 static rme_ptr_t ___RME_RV32P_PMP_Range_Kick(struct __RME_RV32P_PMP_Range* Range,
                                              rme_ptr_t Number,
-                                             rme_ptr_t Add);
+                                             rme_ptr_t Add,
+                                             rme_ptr_t* Hand);
 static rme_ret_t ___RME_RV32P_PMP_Add(struct __RME_RV32P_PMP_Range* Range,
                                       rme_ptr_t Number,
+                                      rme_ptr_t* Hand,
                                       rme_ptr_t Paddr,
                                       rme_ptr_t Size_Order,
                                       rme_ptr_t Flag);
@@ -718,6 +850,14 @@ static rme_ret_t ___RME_RV32P_PMP_Update(struct __RME_RV32P_Pgt_Meta* Top_Meta,
                                          rme_ptr_t Paddr,
                                          rme_ptr_t Size_Order,
                                          rme_ptr_t Flag);
+#if(RME_PGT_WALK_CACHE_NUM!=0U)
+static struct __RME_RV32P_Pgt_Cache* ___RME_RV32P_Pgt_Cache_Find(struct __RME_RV32P_Pgt_Meta* Top,
+                                                                 rme_ptr_t Vaddr);
+static void ___RME_RV32P_Pgt_Cache_Fill(struct __RME_RV32P_Pgt_Meta* Top,
+                                        struct __RME_RV32P_Pgt_Meta* Meta,
+                                        rme_ptr_t Start,
+                                        rme_ptr_t Flag);
+#endif
 #endif
 /* Kernel function ***********************************************************/
 #if(RME_PGT_RAW_ENABLE==0U)
@@ -726,7 +866,8 @@ static rme_ret_t __RME_RV32P_Pgt_Entry_Mod(struct RME_Cap_Cpt* Cpt,
                                            rme_ptr_t Vaddr,
                                            rme_ptr_t Type);
 #endif
-static rme_ret_t __RME_RV32P_Int_Local_Mod(rme_ptr_t Int_Num,
+static rme_ret_t __RME_RV32P_Int_Local_Mod(struct RME_Cap_Cpt* Cpt,
+                                           rme_ptr_t Int_Num,
                                            rme_ptr_t Operation,
                                            rme_ptr_t Param);
 static rme_ret_t __RME_RV32P_Int_Local_Trig(rme_ptr_t CPUID,
@@ -799,6 +940,7 @@ RME_EXTERN rme_ptr_t ___RME_RV32P_MCYCLE_Get(void);
 RME_EXTERN rme_ptr_t ___RME_RV32P_MISA_Get(void);
 RME_EXTERN rme_ptr_t ___RME_RV32P_MSTATUS_Get(void);
 RME_EXTERN void ___RME_RV32P_MSTATUS_Set(rme_ptr_t Value);
+RME_EXTERN void ___RME_RV32P_MCOUNTEREN_Set(rme_ptr_t Value);
 #if(RME_DBGLOG_ENABLE!=0U)
 /* Debugging */
 __RME_EXTERN__ rme_ptr_t __RME_Putchar(char Char);
@@ -847,6 +989,9 @@ __RME_EXTERN__ void __RME_Svc_Param_Get(struct RME_Reg_Struct* Reg,
                                         rme_ptr_t* Param);
 __RME_EXTERN__ void __RME_Svc_Retval_Set(struct RME_Reg_Struct* Reg,
                                          rme_ret_t Retval);
+__RME_EXTERN__ void __RME_Svc_Pgr_Set(struct RME_Reg_Struct* Reg,
+                                      rme_ptr_t TID,
+                                      struct RME_Exc_Struct* Exc);
 /* Thread register sets */
 __RME_EXTERN__ void __RME_Thd_Reg_Init(rme_ptr_t Attr,
                                        rme_ptr_t Entry,
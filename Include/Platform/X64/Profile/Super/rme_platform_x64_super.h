@@ -18,7 +18,7 @@ Description: The configuration file for X64 supercomputer profile.
 #define RME_X64_CPU_NUM              256
 /* Number of IOAPICs in the system - max. 256 ones are supported */
 #define RME_X64_IOAPIC_NUM           8
-/* Shared interrupt flag region address - not populated now */
+/* Physical address of the shared interrupt flag sets, two per CPU - 0 if unused */
 #define RME_X64_INT_FLAG_ADDR        0x00
 /* What is the FPU type? */
 #define RME_X64_FPU_TYPE             RME_X64_FPU_AVX512
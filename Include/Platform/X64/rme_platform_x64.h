@@ -115,6 +115,27 @@ typedef rme_s64_t rme_ret_t;
 #define RME_QUIE_TIME                        (10U)
 /* Cpt size limit - not restricted, user-level decides this */
 #define RME_CPT_LIMIT                         (0U)
+/* 2-level capability lookup cache entries, power of 2 - disabled */
+#define RME_CPT_CACHE_NUM                    (0U)
+/* Cpt migration slots processed per call */
+#define RME_CPT_MIG_MAX                      (16U)
+/* Capability derivation tracking - single-core only, disabled */
+#define RME_CPT_DRV_ENABLE                   (0U)
+/* Revoked capabilities per call */
+#define RME_CPT_RVK_MAX                      (16U)
+/* Kernel address of a checked user page - through the linear mapping */
+#define RME_PGT_KADDR(VADDR,PADDR)           RME_X64_PA2VA(PADDR)
+/* Kernel object table CAS retries on words shared with neighbors */
+#define RME_KOT_RETRY_MAX                    (8U)
+/* Deferred zeroing entries per CPU - disabled */
+#define RME_KOT_ZERO_NUM                     (0U)
+/* Bytes zeroed per deferred zeroing call, multiple of slot size */
+#define RME_KOT_ZERO_CHUNK                   (256U)
+/* Pages mapped per batched page table add call */
+#define RME_PGT_ADD_MAX                      (16U)
+/* Batched page mapping hooks - no deferred hardware update */
+#define RME_PGT_BATCH_BEGIN(PGT)             ((void)(PGT))
+#define RME_PGT_BATCH_END(PGT)               (0)
 /* Normal page directory size calculation macro */
 #define RME_PGT_SIZE_NOM(NUM_ORDER)           ((1<<(NUM_ORDER))*sizeof(rme_ptr_t))
 /* Top-level page directory size calculation macro */
@@ -317,6 +338,7 @@ static INLINE rme_ptr_t __RME_Get_timestamp()
 #define RME_X64_MADT_INT_SRC_OVERRIDE        2
 #define RME_X64_MADT_NMI_INT_SRC             3
 #define RME_X64_MADT_LAPIC_NMI               4
+#define RME_X64_MADT_X2APIC                  9
 
 #define RME_X64_APIC_LAPIC_ENABLED           1
 
@@ -349,6 +371,8 @@ static INLINE rme_ptr_t __RME_Get_timestamp()
 #define RME_X64_MMU_PDE_PAT                  (((rme_ptr_t)1)<<12)
 /* The generic address mask */
 #define RME_X64_MMU_ADDR(X)                  ((X)&0x000FFFFFFFFFF000)
+/* Attributes of an entry that must match when merging - without A/D set by hardware */
+#define RME_X64_MMU_ATTR(X)                  ((X)&(~(RME_X64_MMU_ADDR(~((rme_ptr_t)0))|RME_X64_MMU_A|RME_X64_MMU_D)))
 /* Initial PML4 entries */
 #define RME_X64_MMU_KERN_PML4                (RME_X64_MMU_P|RME_X64_MMU_RW|RME_X64_MMU_G)
 /* Initial PDP entries - note that the P bit is not set */
@@ -365,6 +389,38 @@ static INLINE rme_ptr_t __RME_Get_timestamp()
 #define RME_X64_PGFLG_RME2NAT(FLAGS)         (RME_X64_Pgflg_RME2NAT[(FLAGS)&(~RME_PGT_STATIC)])
 #define RME_X64_PGFLG_NAT2RME(FLAGS)         (RME_X64_Pgflg_NAT2RME[(((FLAGS)>>63)<<3)|(((FLAGS)&0x18)>>2)|(((FLAGS)&0x02)>>1)])
 
+/* Page table entry modification kernel function types */
+/* Replace a full and contiguous child directory with one large page */
+#define RME_X64_KFN_PGT_ENTRY_MOD_PROMOTE    (0)
+/* Replace a large page with a child directory covering the same memory */
+#define RME_X64_KFN_PGT_ENTRY_MOD_SPLIT      (1)
+
+/* Local interrupt modification kernel function types */
+/* Get whether an IOAPIC input is enabled */
+#define RME_X64_KFN_INT_LOCAL_MOD_STATE_GET  (0)
+/* Route an IOAPIC input to the current CPU, or disable it */
+#define RME_X64_KFN_INT_LOCAL_MOD_STATE_SET  (1)
+/* Bind a signal endpoint to a vector, or unbind it */
+#define RME_X64_KFN_INT_LOCAL_MOD_SIG_SET    (2)
+
+/* Global interrupt modification kernel function types */
+/* Get which CPU an IOAPIC input is routed to */
+#define RME_X64_KFN_INT_GLOBAL_MOD_AFF_GET   (0)
+/* Route an IOAPIC input to a CPU, keeping it enabled or disabled */
+#define RME_X64_KFN_INT_GLOBAL_MOD_AFF_SET   (1)
+/* Get the number of user interrupts that a CPU has taken */
+#define RME_X64_KFN_INT_GLOBAL_MOD_CNT_GET   (2)
+/* Allocate a user interrupt for MSI and bind it to a CPU and signal endpoint */
+#define RME_X64_KFN_INT_GLOBAL_MOD_MSI_ALLOC (3)
+/* Free a user interrupt allocated for MSI */
+#define RME_X64_KFN_INT_GLOBAL_MOD_MSI_FREE  (4)
+
+/* MSI message - the allocation returns the address in bits 47:16 and the data
+ * in bits 15:0; the low 8 bits of the data is the vector */
+#define RME_X64_MSI_ADDR_BASE                (0xFEE00000)
+#define RME_X64_MSI_ADDR(X)                  (((X)>>16)&0xFFFFFFFF)
+#define RME_X64_MSI_DATA(X)                  ((X)&0xFFFF)
+
 /* Hardware port definitions */
 #define RME_X64_COM1                         (0x3F8)
 #define RME_X64_PIT_CH0                      (0x40)
@@ -381,6 +437,7 @@ static INLINE rme_ptr_t __RME_Get_timestamp()
 #define RME_X64_CPUID_0_VENDOR_ID            (0x0)
 /* Processor info and feature bits */
 #define RME_X64_CPUID_1_INFO_FEATURE         (0x1)
+#define RME_X64_1_ECX_X2APIC                 (1<<21)
 /* Cache and TLB descriptor information */
 #define RME_X64_CPUID_2_CACHE_TLB            (0x2)
 /* Processor serial number */
@@ -522,6 +579,18 @@ while(0)
 #define RME_X64_INT_ERROR                    RME_X64_INT_USER(0x81-32)
 #define RME_X64_INT_IPI                      RME_X64_INT_USER(0x82-32)
 #define RME_X64_INT_SMP_SYSTICK              RME_X64_INT_USER(0x83-32)
+#define RME_X64_INT_TLB                      RME_X64_INT_USER(0x84-32)
+/* Number of user interrupts that devices can use, below the ones above */
+#define RME_X64_INT_USER_NUM                 (0x80-32)
+
+/* The interrupt flag sets - each CPU has the index of the buffer that the kernel
+ * writes to, then two buffers */
+#define RME_X64_FLAG_CPU(CPUID)              (RME_X64_PA2VA(RME_X64_INT_FLAG_ADDR)+ \
+                                              (sizeof(rme_ptr_t)+(sizeof(struct __RME_X64_Flag)<<1))*(CPUID))
+#define RME_X64_FLAG_CUR(CPUID)              (*((volatile rme_ptr_t*)RME_X64_FLAG_CPU(CPUID)))
+#define RME_X64_FLAG_SET(CPUID,N)            ((volatile struct __RME_X64_Flag*) \
+                                              (RME_X64_FLAG_CPU(CPUID)+sizeof(rme_ptr_t)+ \
+                                               sizeof(struct __RME_X64_Flag)*(N)))
 
 /* LAPIC offsets - maybe we should use structs later on */
 #define RME_X64_LAPIC_ID                     (0x0020/4)
@@ -559,9 +628,19 @@ while(0)
 #define RME_X64_LAPIC_TCCR                   (0x0390/4)
 #define RME_X64_LAPIC_TDCR                   (0x03E0/4)
 
-/* LAPIC R/W */
-#define RME_X64_LAPIC_READ(REG)              (((rme_u32_t*)RME_X64_PA2VA(RME_X64_LAPIC_Addr))[REG])
-#define RME_X64_LAPIC_WRITE(REG,VAL)         (((rme_u32_t*)RME_X64_PA2VA(RME_X64_LAPIC_Addr))[REG]=(VAL))
+/* LAPIC R/W - through MSRs in x2APIC mode, and through memory otherwise */
+#define RME_X64_LAPIC_READ(REG)              ((RME_X64_X2APIC!=0)? \
+                                              (rme_u32_t)__RME_X64_Read_MSR(RME_X64_MSR_X2APIC(REG)): \
+                                              ((rme_u32_t*)RME_X64_PA2VA(RME_X64_LAPIC_Addr))[REG])
+#define RME_X64_LAPIC_WRITE(REG,VAL) \
+do \
+{ \
+	if(RME_X64_X2APIC!=0) \
+		__RME_X64_Write_MSR(RME_X64_MSR_X2APIC(REG),(VAL)); \
+	else \
+		((rme_u32_t*)RME_X64_PA2VA(RME_X64_LAPIC_Addr))[REG]=(VAL); \
+} \
+while(0)
 
 /* IOAPIC address - consider supporting multiple ones */
 #define RME_X64_IOAPIC_ADDR                 (RME_X64_PA2VA(0xFEC00000))
@@ -576,6 +655,8 @@ while(0)
 #define RME_X64_IOAPIC_INT_ACTIVELOW        (0x00002000)
 #define RME_X64_IOAPIC_INT_LOGICAL          (0x00000800)
 
+/* These select a register then access it, so callers other than the boot-time
+ * initialization must hold the IOAPIC lock across each use */
 #define RME_X64_IOAPIC_READ(REG,DATA) \
 do \
 { \
@@ -602,9 +683,14 @@ while(0)
 #define RME_X64_MSR_IA32_STAR              (0xC0000081)
 #define RME_X64_MSR_IA32_LSTAR             (0xC0000082)
 #define RME_X64_MSR_IA32_FMASK             (0xC0000084)
+#define RME_X64_MSR_IA32_APIC_BASE         (0x1B)
+/* The x2APIC registers, at the LAPIC register offset divided by 16 */
+#define RME_X64_MSR_X2APIC(REG)            (0x800+((REG)>>2))
 
 /* MSR bits */
 #define RME_X64_MSR_IA32_EFER_SCE          (1)
+#define RME_X64_MSR_IA32_APIC_BASE_EXTD    (1<<10)
+#define RME_X64_MSR_IA32_APIC_BASE_EN      (1<<11)
 
 /* Segment definitions */
 #define RME_X64_SEG_KERNEL_CODE            (1*8)
@@ -697,6 +783,17 @@ struct RME_X64_ACPI_MADT_LAPIC_Record
 	rme_u32_t Flags;
 } __attribute__((__packed__));
 
+/* MADT's x2APIC record, for LAPIC IDs that do not fit in 8 bits */
+struct RME_X64_ACPI_MADT_X2APIC_Record
+{
+	rme_u8_t Type;
+	rme_u8_t Length;
+	rme_u16_t Reserved;
+	rme_u32_t X2APIC_ID;
+	rme_u32_t Flags;
+	rme_u32_t ACPI_UID;
+} __attribute__((__packed__));
+
 /* MADT's IOAPIC record */
 struct RME_X64_ACPI_MADT_IOAPIC_Record
 {
@@ -766,6 +863,13 @@ struct RME_X64_CPU_Info
 	rme_ptr_t LAPIC_ID;
 	/* Is the booting done on this CPU? */
 	volatile rme_ptr_t Boot_Done;
+	/* The top-level page table currently loaded on this CPU, or 0 if none */
+	volatile rme_ptr_t Pgt_Cur;
+	/* TLB shootdown generations requested by others and done by this CPU */
+	volatile rme_ptr_t TLB_Req;
+	volatile rme_ptr_t TLB_Ack;
+	/* User interrupts taken by this CPU, only ever written by itself */
+	volatile rme_ptr_t Int_Cnt;
 };
 
 /* Per-IOAPIC data structure */
@@ -774,6 +878,16 @@ struct RME_X64_IOAPIC_Info
     rme_ptr_t IOAPIC_ID;
 };
 
+/* Interrupt flag structure - same layout as the other ports, but the fast
+ * flags are unused and there is one slow flag for each user interrupt. The
+ * flag words fit in one group word, so there are no summary words */
+struct __RME_X64_Flag
+{
+    rme_ptr_t Fast;
+    rme_ptr_t Group;
+    rme_ptr_t Flag[RME_ROUND_UP(RME_X64_INT_USER_NUM,RME_WORD_ORDER)>>RME_WORD_ORDER];
+};
+
 /* The 6 registers that are used to pass arguments are RDI, RSI, RDX, RCX, R8, R9.
  * Note that this is different from Micro$oft: M$ use RCX, RDX, R8, R9. The return
  * value is always located at RAX. */
@@ -832,6 +946,9 @@ struct RME_Exc_Struct
 
     /* Stack segment selector (only pushed if transitioning from user to kernel) */
     rme_ptr_t SS;
+
+    /* The faulting linear address from CR2 (only valid for page faults) */
+    rme_ptr_t CR2;
 };
 
 /* The coprocessor register set structure. MMX and SSE */
@@ -1011,7 +1128,7 @@ static volatile rme_ptr_t RME_X64_UART_Exist;
 static volatile struct multiboot_info* RME_X64_MBInfo;
 /* The layout of the memory structure */
 static volatile struct RME_X64_Layout RME_X64_Layout;
-/* We currently support 256 CPUs max */
+/* The number of CPUs, up to RME_X64_CPU_NUM; beyond 255 needs x2APIC */
 static volatile rme_ptr_t RME_X64_Num_CPU;
 /* CPU counter */
 static volatile rme_ptr_t RME_X64_CPU_Cnt;
@@ -1019,12 +1136,22 @@ static volatile struct RME_X64_CPU_Info RME_X64_CPU_Info[RME_X64_CPU_NUM];
 /* There can be max. 8 IOAPICs */
 static volatile rme_ptr_t RME_X64_Num_IOAPIC;
 static volatile struct RME_X64_IOAPIC_Info RME_X64_IOAPIC_Info[RME_X64_IOAPIC_NUM];
+/* The last IOAPIC input, read from the version register once at boot */
+static volatile rme_ptr_t RME_X64_IOAPIC_Max_Int;
+/* The IOAPIC is accessed through an index/data register pair shared by all CPUs */
+static volatile rme_ptr_t RME_X64_IOAPIC_Lock_Word;
 /* The LAPIC address */
 static volatile rme_ptr_t RME_X64_LAPIC_Addr;
+/* Whether the LAPICs are used in x2APIC mode */
+static volatile rme_ptr_t RME_X64_X2APIC;
 /* The processor features */
 static volatile struct RME_X64_Features RME_X64_Feature;
 /* The PCID counter */
 static volatile rme_ptr_t RME_X64_PCID_Inc;
+/* The signal endpoints that each user interrupt is bound to, if any */
+static struct RME_Cap_Sig* RME_X64_Vct_Sig[RME_X64_INT_USER_NUM];
+/* The user interrupts that are allocated for MSI */
+static volatile rme_ptr_t RME_X64_MSI_Alloc[RME_ROUND_UP(RME_X64_INT_USER_NUM,RME_WORD_ORDER)>>RME_WORD_ORDER];
 /* The VGA buffer pointer */
 static volatile rme_u16_t* vga_buffer;
 /* The VGA text cursor row */
@@ -1215,11 +1342,31 @@ static struct RME_CPU_Local* __RME_X64_CPU_Local_Get_By_CPUID(rme_ptr_t CPUID);
 static void __RME_X64_PIC_Init(void);
 static void __RME_X64_LAPIC_Init(void);
 static void __RME_X64_IOAPIC_Init(void);
+/* Send an IPI */
+static void __RME_X64_LAPIC_IPI(rme_ptr_t LAPIC_ID, rme_ptr_t Cmd);
+/* Serialize IOAPIC register access */
+static void __RME_X64_IOAPIC_Lock(void);
+static void __RME_X64_IOAPIC_Unlock(void);
 /* Enable/disable a vector in IOAPIC */
 static void __RME_X64_IOAPIC_Int_Enable(rme_ptr_t IRQ, rme_ptr_t CPUID);
 static void __RME_X64_IOAPIC_Int_Disable(rme_ptr_t IRQ);
+/* Interrupt delivery to user level */
+static void __RME_X64_Flag_Or(volatile rme_ptr_t* Word, rme_ptr_t Mask);
+static void __RME_X64_Flag_Set(rme_ptr_t CPUID, rme_ptr_t IRQ);
+static rme_ret_t __RME_X64_Int_Local_Mod(struct RME_Cap_Cpt* Cpt, rme_ptr_t IRQ,
+                                         rme_ptr_t Operation, rme_ptr_t Param);
+static rme_ret_t __RME_X64_MSI_Alloc(struct RME_Cap_Cpt* Cpt, rme_ptr_t Param);
+static rme_ret_t __RME_X64_MSI_Free(struct RME_Cap_Cpt* Cpt, rme_ptr_t IRQ, rme_ptr_t Max_Int);
+static rme_ret_t __RME_X64_Int_Global_Mod(struct RME_Cap_Cpt* Cpt, rme_ptr_t IRQ,
+                                          rme_ptr_t Operation, rme_ptr_t Param);
 /* Initialize timers */
 static void __RME_X64_Timer_Init(void);
+/* TLB shootdown */
+static void __RME_X64_TLB_Handler(void);
+static void __RME_X64_TLB_Shootdown(rme_ptr_t Pgt);
+/* Large page promotion and splitting */
+static rme_ret_t __RME_X64_Pgt_Entry_Mod(struct RME_Cap_Cpt* Cpt, rme_cid_t Cap_Pgt,
+                                         rme_ptr_t Param, rme_ptr_t Type);
 /*****************************************************************************/
 #define __EXTERN__
 /* End Private Function ******************************************************/
@@ -1251,8 +1398,10 @@ EXTERN void __RME_X64_IDT_Load(rme_ptr_t* IDTR);
 EXTERN void __RME_X64_TSS_Load(rme_ptr_t TSS);
 EXTERN rme_ptr_t __RME_X64_CPUID_Get(rme_ptr_t EAX, rme_ptr_t* EBX, rme_ptr_t* ECX, rme_ptr_t* EDX);
 EXTERN void __RME_X64_Pgt_Set(rme_ptr_t Pgt);
+EXTERN rme_ptr_t __RME_X64_CR2_Get(void);
 EXTERN void __RME_Svc_Param_Get(struct RME_Reg_Struct* Reg,rme_ptr_t* Svc,rme_ptr_t* Cid,rme_ptr_t* Param);
 EXTERN void __RME_Svc_Retval_Set(struct RME_Reg_Struct* Reg,rme_ret_t Retval);
+EXTERN void __RME_Svc_Pgr_Set(struct RME_Reg_Struct* Reg,rme_ptr_t TID,struct RME_Exc_Struct* Exc);
 EXTERN void __RME_Inv_Retval_Set(struct RME_Reg_Struct* Reg,rme_ret_t Retval);
 EXTERN rme_ret_t __RME_Kfn_Handler(struct RME_Cap_Cpt* Cpt,struct RME_Reg_Struct* Reg,rme_ptr_t FuncID,rme_ptr_t SubID,rme_ptr_t Param1,rme_ptr_t Param2);
 EXTERN void __RME_List_Crt(struct RME_List* Head);
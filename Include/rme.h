@@ -141,6 +141,10 @@ Description : The header of the RME RTOS. This header defines the error codes,
 /* This cap to kernel memory allows all operations */
 #define RME_KOM_FLAG_ALL                (RME_KOM_FLAG_CPT|RME_KOM_FLAG_PGT| \
                                          RME_KOM_FLAG_THD|RME_KOM_FLAG_INV)
+/* Kernel object table contention counters, for RME_KFN_KOT_STAT_GET */
+#define RME_KOT_STAT_FAIL               (0U)
+#define RME_KOT_STAT_RETRY              (1U)
+#define RME_KOT_STAT_UNDO               (2U)
 
 /* Process *******************************************************************/
 /* This cap to process allows creating invocation stubs in it */
@@ -151,9 +155,12 @@ Description : The header of the RME RTOS. This header defines the error codes,
 #define RME_PRC_FLAG_CPT                (1U<<2)
 /* This cap to process allows changing its page table */
 #define RME_PRC_FLAG_PGT                (1U<<3)
+/* This cap to process allows changing its pager endpoint */
+#define RME_PRC_FLAG_PGR                (1U<<4)
 /* This cap to process allows all operations */
 #define RME_PRC_FLAG_ALL                (RME_PRC_FLAG_INV|RME_PRC_FLAG_THD| \
-                                         RME_PRC_FLAG_CPT|RME_PRC_FLAG_PGT)
+                                         RME_PRC_FLAG_CPT|RME_PRC_FLAG_PGT| \
+                                         RME_PRC_FLAG_PGR)
 
 /* Thread ********************************************************************/
 /* This cap to thread allows setting its execution parameters */
@@ -196,8 +203,14 @@ Description : The header of the RME RTOS. This header defines the error codes,
                                          RME_SIG_FLAG_RCV_NS|RME_SIG_FLAG_RCV_NM)
 /* This cap to signal endpoint allows sending scheduler notification to it */
 #define RME_SIG_FLAG_SCHED              (1U<<5)
+/* This cap to signal endpoint allows sending fault notification to it */
+#define RME_SIG_FLAG_PGR                (1U<<6)
+/* This cap to signal endpoint allows binding it to an interrupt vector */
+#define RME_SIG_FLAG_VCT                (1U<<7)
 /* This cap to signal endpoint allows all operations */
-#define RME_SIG_FLAG_ALL                (RME_SIG_FLAG_SND|RME_SIG_FLAG_RCV|RME_SIG_FLAG_SCHED)
+#define RME_SIG_FLAG_ALL                (RME_SIG_FLAG_SND|RME_SIG_FLAG_RCV| \
+                                         RME_SIG_FLAG_SCHED|RME_SIG_FLAG_PGR| \
+                                         RME_SIG_FLAG_VCT)
 
 /* Invocation ****************************************************************/
 /* This cap to invocation allows setting parameters for it */
@@ -411,6 +424,17 @@ Description : The header of the RME RTOS. This header defines the error codes,
 #define RME_SVC_INV_DEL                 (32U)
 /* Set entry&stack */
 #define RME_SVC_INV_SET                 (33U)
+/* Capability table extension ************************************************/
+/* Migrate to a larger table */
+#define RME_SVC_CPT_MIG                 (34U)
+/* Revoke all derivations */
+#define RME_SVC_CPT_RVK                 (35U)
+/* Page table extension ******************************************************/
+/* Add a run of consecutive pages */
+#define RME_SVC_PGT_ADD_RNG             (36U)
+/* Process extension *********************************************************/
+/* Change pager endpoint */
+#define RME_SVC_PRC_PGR                 (37U)
 /* End System Call Number ****************************************************/
 
 /* Kernel Function Number ****************************************************/
@@ -425,6 +449,8 @@ Description : The header of the RME RTOS. This header defines the error codes,
 #define RME_KFN_PGT_TLB_LOCK            (0xF003U)
 /* Query or modify the content of an entry */
 #define RME_KFN_PGT_ENTRY_MOD           (0xF004U)
+/* Query the pages in a range of a page directory in bulk */
+#define RME_KFN_PGT_ENTRY_QUERY         (0xF005U)
 /* Interrupt controller ******************************************************/
 /* Modify local interrupt controller */
 #define RME_KFN_INT_LOCAL_MOD           (0xF100U)
@@ -529,6 +555,11 @@ Description : The header of the RME RTOS. This header defines the error codes,
 #define RME_KFN_DEBUG_IBP_MOD           (0xF805U)
 /* Modify data breakpoint state */
 #define RME_KFN_DEBUG_DBP_MOD           (0xF806U)
+/* Kernel memory *************************************************************/
+/* Zero a chunk of deleted kernel memory in advance */
+#define RME_KFN_KOM_ZERO                (0xF900U)
+/* Read a kernel object table contention counter of the current CPU */
+#define RME_KFN_KOT_STAT_GET            (0xF901U)
 /* End Kernel Function Number ************************************************/
 
 /* End Define ****************************************************************/
@@ -7,6 +7,16 @@ Description : The benchmark file for RME.
 ******************************************************************************/
 
 /* Define ********************************************************************/
+/* The port that the benchmark is built for; this decides the word size, the
+ * timestamp counter and how the thread stacks are laid out */
+#define RME_BENCH_PORT_A7M                  0
+#define RME_BENCH_PORT_RV32P                1
+#define RME_BENCH_PORT_A7A                  2
+#define RME_BENCH_PORT_X64                  3
+#ifndef RME_BENCH_PORT
+#define RME_BENCH_PORT                      RME_BENCH_PORT_A7M
+#endif
+
 /* Types */
 typedef signed int  s32;
 typedef signed short s16;
@@ -14,15 +24,25 @@ typedef signed char  s8;
 typedef unsigned int  u32;
 typedef unsigned short u16;
 typedef unsigned char  u8;
+#if(RME_BENCH_PORT==RME_BENCH_PORT_X64)
+typedef signed long long s64;
+typedef unsigned long long u64;
+typedef s64 tid_t;
+typedef u64 ptr_t;
+typedef s64 cnt_t;
+typedef s64 cid_t;
+typedef s64 ret_t;
+#else
 typedef s32 tid_t;
 typedef u32 ptr_t;
 typedef s32 cnt_t;
 typedef s32 cid_t;
 typedef s32 ret_t;
+#endif
 
 #define BENCHMARK_STACK_SIZE 4096
 /* System service stub */
-#define RME_CAP_OP(OP,CAPID,ARG1,ARG2,ARG3) RME_Svc(((OP)<<(sizeof(ptr_t)*4)|(CAPID)),ARG1,ARG2,ARG3)
+#define RME_CAP_OP(OP,CAPID,ARG1,ARG2,ARG3) RME_Svc(((((ptr_t)(OP))<<(sizeof(ptr_t)*4))|(CAPID)),ARG1,ARG2,ARG3)
 #define RME_PARAM_D_MASK                    (((ptr_t)(-1))>>(sizeof(ptr_t)*4))
 #define RME_PARAM_Q_MASK                    (((ptr_t)(-1))>>(sizeof(ptr_t)*6))
 #define RME_PARAM_O_MASK                    (((ptr_t)(-1))>>(sizeof(ptr_t)*7))
@@ -66,6 +86,18 @@ typedef s32 ret_t;
 #define RME_BOOT_BENCH_THD       8
 #define RME_BOOT_BENCH_PGT_TOP 9
 #define RME_BOOT_BENCH_PGT_SRAM 10
+#define RME_BOOT_BENCH_CPT 11
+#define RME_BOOT_BENCH_SIG 12
+#define RME_BOOT_BENCH_PRC 13
+#define RME_BOOT_BENCH_CPT_DST 14
+/* The table of per-CPU timer endpoints on the multi-core ports */
+#define RME_BOOT_TBL_TIMER 15
+
+/* 2-level capability ID */
+#define RME_CAPID_2L                        (((ptr_t)1)<<(sizeof(ptr_t)*2-1))
+#define RME_CAPID(X,Y)                      (((X)<<(sizeof(ptr_t)*2))|(Y)|RME_CAPID_2L)
+/* Empty capability ID, for the operations that take an optional capability */
+#define RME_CID_NULL                        (((ptr_t)1)<<(sizeof(ptr_t)*4-1))
 
 /* Need to export the memory frontier! */
 /* Need to export the flags as well ! */
@@ -75,7 +107,50 @@ typedef s32 ret_t;
 /* The stack safe size */
 #define RME_STACK_SAFE_SIZE 16
 
-#define RME_TSC() TIM2->CNT
+/* The timestamp counter - each port reads its own, see _RME_Tsc_Get */
+#define RME_TSC() _RME_Tsc_Get()
+
+/* The vector that the interrupt latency test triggers in software; pick one
+ * that no device uses. The local interrupt modification operations below are
+ * numbered the same on A7M, A6M and RV32P */
+#define RME_BENCH_INT_VCT 0
+#define RME_BENCH_INT_LOCAL_MOD_STATE_SET 1
+#define RME_BENCH_INT_LOCAL_MOD_SIG_SET 4
+/* The latency histogram has 64 buckets, each 4 TSC ticks wide */
+#define RME_BENCH_HIST_NUM 64
+#define RME_BENCH_HIST_ORDER 2
+/* The x86-64 fault vectors that the fault forwarding test raises, in order */
+#define RME_BENCH_FAULT_NUM 3
+#define RME_BENCH_FAULT_DE 0
+#define RME_BENCH_FAULT_UD 6
+#define RME_BENCH_FAULT_GP 13
+/* The tick test runs on this many cores, and waits for this many ticks on each;
+ * the A7A port does not boot its other cores yet */
+#if(RME_BENCH_PORT==RME_BENCH_PORT_A7A)
+#define RME_BENCH_CPU_NUM 1
+#else
+#define RME_BENCH_CPU_NUM 2
+#endif
+#define RME_BENCH_TICK_NUM 1000
+
+/* The test that RME_Benchmark runs; pick one with -DRME_BENCH_TEST=... */
+#define RME_BENCH_TEST_SAME_PRC_THD_SWT 0
+#define RME_BENCH_TEST_CPT_CACHE 1
+#define RME_BENCH_TEST_KOT_STRESS 2
+#define RME_BENCH_TEST_PGT_UNMAP 3
+#define RME_BENCH_TEST_PGDIR_UNMAP 4
+#define RME_BENCH_TEST_THD_FAULT 5
+#define RME_BENCH_TEST_CPT_MIG 6
+#define RME_BENCH_TEST_PRC_ASID_SWT 7
+#define RME_BENCH_TEST_INT_LATENCY 8
+#define RME_BENCH_TEST_TICK 9
+#ifndef RME_BENCH_TEST
+#define RME_BENCH_TEST RME_BENCH_TEST_SAME_PRC_THD_SWT
+#endif
+/* The test verdict, for the debugger or the QEMU monitor to read */
+#define RME_BENCH_RUNNING 0
+#define RME_BENCH_PASS 1
+#define RME_BENCH_FAIL 2
 
 /* Need to export the system priority limit! */
 struct RME_CMX_Ret_Stack
@@ -112,7 +187,9 @@ struct RME_CMX_Ret_Stack
 
 /* Include *******************************************************************/
 #include "RME.h"
+#if(RME_BENCH_PORT==RME_BENCH_PORT_A7M)
 #include "stm32f4xx.h"
+#endif
 /* Need to export error codes, and size of each object, in words! */
 /* End Include ***************************************************************/
 
@@ -121,6 +198,32 @@ struct RME_CMX_Ret_Stack
 ptr_t RME_Stack[2048];
 u16 Time[10000];
 s8 RME_Bench_Buf[1024];
+/* The verdict of the selected test */
+volatile ptr_t RME_Bench_Result;
+/* Interrupt latency test - trigger time and results */
+volatile ptr_t RME_Int_Stamp;
+ptr_t RME_Int_Hist[RME_BENCH_HIST_NUM];
+ptr_t RME_Int_Min;
+ptr_t RME_Int_Avg;
+ptr_t RME_Int_Max;
+ptr_t RME_Int_Jitter;
+/* Kernel object table stress test - contention counters of this CPU */
+ret_t RME_Kot_Stat_Fail;
+ret_t RME_Kot_Stat_Retry;
+ret_t RME_Kot_Stat_Undo;
+/* Page directory unmap test - number of destructions that failed */
+ptr_t RME_Pgdir_Unmap_Fail;
+/* Capability table migration test - results of the send and the deletion */
+ret_t RME_Cpt_Mig_Snd;
+ret_t RME_Cpt_Mig_Del;
+/* Tick test - per-CPU tick counts and the shortest and longest intervals */
+volatile ptr_t RME_Tick_Cnt[RME_BENCH_CPU_NUM];
+ptr_t RME_Tick_Min[RME_BENCH_CPU_NUM];
+ptr_t RME_Tick_Max[RME_BENCH_CPU_NUM];
+/* Fault forwarding test - what the pager saw, and the number of mismatches */
+ptr_t RME_Thd_Fault_TID[RME_BENCH_FAULT_NUM];
+ptr_t RME_Thd_Fault_Vct[RME_BENCH_FAULT_NUM];
+ptr_t RME_Thd_Fault_Fail;
 /* End Private Variables *****************************************************/
 
 /* Function Prototypes *******************************************************/
@@ -128,10 +231,30 @@ extern ret_t RME_Svc(ptr_t Svc_Capid,ptr_t Param1, ptr_t Param2, ptr_t Param3);
 extern cnt_t RME_Sprint_Uint(s8* Buffer,u32 Arg_Int);
 extern void RME_Thd_Stub(void);
 extern void RME_Inv_Stub(void);
+void _RME_Tsc_Init(void);
+ptr_t _RME_Tsc_Get(void);
 ptr_t _RME_Stack_Init(ptr_t Stack, ptr_t Stub, ptr_t Param1, ptr_t Param2, ptr_t Param3, ptr_t Param4);
-void RME_Benchmark(void);
+void RME_Benchmark(ptr_t CPUID);
 void RME_Same_Prc_Thd_Switch_Test_Thd(ptr_t Param1, ptr_t Param2, ptr_t Param3, ptr_t Param4);
-void RME_Same_Prc_Thd_Switch_Test(void);
+ret_t RME_Same_Prc_Thd_Switch_Test(void);
+ret_t RME_Cpt_Cache_Test(void);
+ret_t RME_Kot_Stress_Test(void);
+ret_t RME_Pgt_Unmap_Test(void);
+#if(RME_BENCH_PORT==RME_BENCH_PORT_X64)
+ret_t RME_Pgdir_Unmap_Test(void);
+ret_t _RME_Pgr_Rcv(ptr_t* TID, ptr_t* Vct);
+void RME_Thd_Fault_Test_Thd(ptr_t Param1, ptr_t Param2, ptr_t Param3, ptr_t Param4);
+ret_t RME_Thd_Fault_Test(void);
+#endif
+ret_t RME_Cpt_Mig_Test(void);
+#if(RME_BENCH_PORT==RME_BENCH_PORT_A7A)
+ret_t RME_Prc_ASID_Switch_Test(void);
+#endif
+#if((RME_BENCH_PORT==RME_BENCH_PORT_A7A)||(RME_BENCH_PORT==RME_BENCH_PORT_X64))
+ret_t RME_Tick_Test(ptr_t CPUID);
+#endif
+void RME_Int_Latency_Test_Thd(ptr_t Param1, ptr_t Param2, ptr_t Param3, ptr_t Param4);
+ret_t RME_Int_Latency_Test(void);
 /* End Function Prototypes ***************************************************/
 
 /* Function:_RME_Tsc_Init *****************************************************
@@ -142,6 +265,7 @@ Return      : None.
 ******************************************************************************/
 void _RME_Tsc_Init(void)
 {
+#if(RME_BENCH_PORT==RME_BENCH_PORT_A7M)
 //    TIM_HandleTypeDef TIM2_Handle;
 //    
 //    /* Initialize timer 2 to run at the same speed as the CPU */
@@ -153,9 +277,47 @@ void _RME_Tsc_Init(void)
 //    HAL_TIM_Base_Init(&TIM2_Handle);
 //    __HAL_RCC_TIM2_CLK_ENABLE();
 //    __HAL_TIM_ENABLE(&TIM2_Handle);
+#endif
+    /* The cycle counters of the other ports are always running */
 }
 /* End Function:_RME_Tsc_Init ************************************************/
 
+/* Function:_RME_Tsc_Get ******************************************************
+Description : Read the timestamp counter of the port. Only the lower word is
+              returned; the tests only ever take short differences of it.
+              A7M   - TIM2 of the STM32, running at the CPU frequency.
+              RV32P - The cycle CSR, which the kernel lets user mode read.
+              A7A   - The virtual count of the generic timer.
+              X64   - The timestamp counter, read with RDTSC.
+Input       : None.
+Output      : None.
+Return      : ptr_t - The current timestamp.
+******************************************************************************/
+ptr_t _RME_Tsc_Get(void)
+{
+#if(RME_BENCH_PORT==RME_BENCH_PORT_A7M)
+    return TIM2->CNT;
+#elif(RME_BENCH_PORT==RME_BENCH_PORT_RV32P)
+    ptr_t Cycle;
+    
+    __asm__ __volatile__("csrr %0, cycle":"=r"(Cycle));
+    return Cycle;
+#elif(RME_BENCH_PORT==RME_BENCH_PORT_A7A)
+    ptr_t Low;
+    ptr_t High;
+    
+    __asm__ __volatile__("mrrc p15, 1, %0, %1, c14":"=r"(Low),"=r"(High));
+    return Low;
+#else
+    u32 Low;
+    u32 High;
+    
+    __asm__ __volatile__("rdtsc":"=a"(Low),"=d"(High));
+    return Low;
+#endif
+}
+/* End Function:_RME_Tsc_Get *************************************************/
+
 /* Function:_RME_Stack_Init ***************************************************
 Description : The thread's stack initializer, initializes the thread's stack.
 Input       : None.
@@ -164,6 +326,7 @@ Return      : None.
 ******************************************************************************/
 ptr_t _RME_Stack_Init(ptr_t Stack, ptr_t Stub, ptr_t Param1, ptr_t Param2, ptr_t Param3, ptr_t Param4)
 {
+#if(RME_BENCH_PORT==RME_BENCH_PORT_A7M)
     struct RME_CMX_Ret_Stack* Stack_Ptr;
     
     Stack_Ptr=(struct RME_CMX_Ret_Stack*)(Stack-RME_STACK_SAFE_SIZE-sizeof(struct RME_CMX_Ret_Stack));
@@ -178,6 +341,10 @@ ptr_t _RME_Stack_Init(ptr_t Stack, ptr_t Stub, ptr_t Param1, ptr_t Param2, ptr_t
     Stack_Ptr->XPSR=0x01000200;
     
     return (ptr_t)Stack_Ptr;
+#else
+    /* The other ports start the thread at its entry directly - just align the stack */
+    return (Stack-RME_STACK_SAFE_SIZE*sizeof(ptr_t))&(~((ptr_t)0x0F));
+#endif
 }
 /* End Function:_RME_Stack_Init **********************************************/
 
@@ -205,15 +372,16 @@ void RME_Same_Prc_Thd_Switch_Test_Thd(ptr_t Param1, ptr_t Param2, ptr_t Param3,
 Description : The same-process thread switch test code.
 Input       : None.
 Output      : None.
-Return      : None.
+Return      : ret_t - If the test passed, 0; else -1.
 ******************************************************************************/
-void RME_Same_Prc_Thd_Switch_Test(void)
+ret_t RME_Same_Prc_Thd_Switch_Test(void)
 {
     /* Intra-process thread switching time */
     ret_t Retval;
     cnt_t Count;
     ptr_t Stack_Addr;
     ptr_t Temp;
+    cnt_t Fail;
     /* Initialize the thread's stack before entering it */
     Stack_Addr=_RME_Stack_Init((ptr_t)(&RME_Stack[2047]),
                                (ptr_t)RME_Thd_Stub,
@@ -263,6 +431,7 @@ void RME_Same_Prc_Thd_Switch_Test(void)
     * This configuration, CPU works at 216MHz, correct, but the 
     * The TSC is always 8 cycles between reads.
     */
+    Fail=0;
     _RME_Tsc_Init();
     for(Count=0;Count<10000;Count++)
     {
@@ -273,9 +442,11 @@ void RME_Same_Prc_Thd_Switch_Test(void)
                           0);
         Temp=RME_TSC()-Temp;
         Time[Count]=Temp-8;
+        if(Retval<0)
+            Fail++;
     }
     
-    while(1);
+    return (Fail==0)?0:-1;
 }
 /* End Function:RME_Same_Prc_Thd_Switch_Test ********************************/
 
@@ -403,15 +574,859 @@ void RME_Diff_Prc_Thd_Switch_Test(void)
 }
 /* End Function:RME_Diff_Prc_Thd_Switch_Test ********************************/
 
-/* Function:RME_Benchmark *****************************************************
-Description : The benchmark entry, also the init thread.
+/* Function:RME_Cpt_Cache_Test ***********************************************
+Description : The 2-level capability lookup test code. The same signal endpoint
+              is sent to through an 1-level and a 2-level capability ID; the
+              difference between the two is the cost of the 2-level lookup. Run
+              this with RME_CPT_CACHE_NUM set to 0 and to a nonzero value to
+              compare the uncached walk against the per-CPU lookup cache.
+Input       : None.
+Output      : None.
+Return      : ret_t - If the test passed, 0; else -1.
+******************************************************************************/
+ret_t RME_Cpt_Cache_Test(void)
+{
+    ret_t Retval;
+    cnt_t Count;
+    ptr_t Temp;
+    cnt_t Fail;
+
+    /* Create the child capability table, and a signal endpoint in the master table */
+    Retval=RME_CAP_OP(RME_SVC_CPT_CRT,RME_BOOT_INIT_CPT,
+                      RME_PARAM_D1(RME_BOOT_INIT_KOM)|RME_PARAM_D0(RME_BOOT_BENCH_CPT),
+                      RME_BOOT_BENCH_KOM_FRONTIER,
+                      16);
+    Retval=RME_CAP_OP(RME_SVC_SIG_CRT,RME_BOOT_INIT_CPT,
+                      RME_BOOT_BENCH_SIG,
+                      0,
+                      0);
+    
+    /* Delegate the endpoint to the first slot of the child table */
+    Retval=RME_CAP_OP(RME_SVC_CPT_ADD,0,
+                      RME_PARAM_D1(RME_BOOT_BENCH_CPT)|RME_PARAM_D0(0),
+                      RME_PARAM_D1(RME_BOOT_INIT_CPT)|RME_PARAM_D0(RME_BOOT_BENCH_SIG),
+                      RME_SIG_FLAG_SND);
+    
+    /* 1-level lookups: Time[0] to Time[4999] */
+    Fail=0;
+    _RME_Tsc_Init();
+    for(Count=0;Count<5000;Count++)
+    {
+        Temp=RME_TSC();
+        Retval=RME_CAP_OP(RME_SVC_SIG_SND,0,
+                          RME_BOOT_BENCH_SIG,
+                          0,
+                          0);
+        Temp=RME_TSC()-Temp;
+        Time[Count]=Temp-8;
+        if(Retval<0)
+            Fail++;
+    }
+    
+    /* 2-level lookups: Time[5000] to Time[9999] */
+    for(Count=5000;Count<10000;Count++)
+    {
+        Temp=RME_TSC();
+        Retval=RME_CAP_OP(RME_SVC_SIG_SND,0,
+                          RME_CAPID(RME_BOOT_BENCH_CPT,0),
+                          0,
+                          0);
+        Temp=RME_TSC()-Temp;
+        Time[Count]=Temp-8;
+        if(Retval<0)
+            Fail++;
+    }
+    
+    return (Fail==0)?0:-1;
+}
+/* End Function:RME_Cpt_Cache_Test *******************************************/
+
+/* Function:RME_Kot_Stress_Test **********************************************
+Description : The kernel object table stress test code. Big capability tables
+              are repeatedly created and deleted at overlapping addresses, so
+              that creations often conflict with a live table. On a multi-core
+              target, run this from one thread per core with the same frontier
+              to get concurrent creates and deletes; the per-CPU Kot_Stat
+              counters then show the failure, retry and rollback rates, and
+              are read into RME_Kot_Stat_Fail/Retry/Undo at the end.
+              Time[] holds the creation time of each round. Creations that
+              conflict are expected to fail, so the test passes as long as the
+              counters can be read.
+Input       : None.
+Output      : None.
+Return      : ret_t - If the test passed, 0; else -1.
+******************************************************************************/
+ret_t RME_Kot_Stress_Test(void)
+{
+    ret_t Retval;
+    cnt_t Count;
+    cnt_t Fail;
+    ptr_t Temp;
+    ptr_t Raddr;
+
+    /* Start the counters from zero */
+    Retval=RME_CAP_OP(RME_SVC_KFN,RME_BOOT_INIT_KERN,
+                      RME_PARAM_D1(RME_KOT_STAT_FAIL)|RME_PARAM_D0(RME_KFN_KOT_STAT_GET),
+                      1,
+                      0);
+    Retval=RME_CAP_OP(RME_SVC_KFN,RME_BOOT_INIT_KERN,
+                      RME_PARAM_D1(RME_KOT_STAT_RETRY)|RME_PARAM_D0(RME_KFN_KOT_STAT_GET),
+                      1,
+                      0);
+    Retval=RME_CAP_OP(RME_SVC_KFN,RME_BOOT_INIT_KERN,
+                      RME_PARAM_D1(RME_KOT_STAT_UNDO)|RME_PARAM_D0(RME_KFN_KOT_STAT_GET),
+                      1,
+                      0);
+    
+    Fail=0;
+    _RME_Tsc_Init();
+    for(Count=0;Count<10000;Count++)
+    {
+        /* Rotate between 4 positions 1kB apart; each 4kB table overlaps the others */
+        Raddr=RME_BOOT_BENCH_KOM_FRONTIER+(Count&0x3)*0x400;
+        Temp=RME_TSC();
+        Retval=RME_CAP_OP(RME_SVC_CPT_CRT,RME_BOOT_INIT_CPT,
+                          RME_PARAM_D1(RME_BOOT_INIT_KOM)|RME_PARAM_D0(RME_BOOT_BENCH_CPT+(Count&0x1)),
+                          Raddr,
+                          128);
+        Temp=RME_TSC()-Temp;
+        Time[Count]=Temp-8;
+        if(Retval<0)
+            Fail++;
+        
+        /* Delete the table created in the last round, if any, so at most two are alive */
+        Retval=RME_CAP_OP(RME_SVC_CPT_FRZ,RME_BOOT_INIT_CPT,
+                          RME_BOOT_BENCH_CPT+((Count+1)&0x1),
+                          0,
+                          0);
+        Retval=RME_CAP_OP(RME_SVC_CPT_DEL,RME_BOOT_INIT_CPT,
+                          RME_BOOT_BENCH_CPT+((Count+1)&0x1),
+                          0,
+                          0);
+    }
+    
+    /* Read what this CPU saw */
+    RME_Kot_Stat_Fail=RME_CAP_OP(RME_SVC_KFN,RME_BOOT_INIT_KERN,
+                                 RME_PARAM_D1(RME_KOT_STAT_FAIL)|RME_PARAM_D0(RME_KFN_KOT_STAT_GET),
+                                 0,
+                                 0);
+    RME_Kot_Stat_Retry=RME_CAP_OP(RME_SVC_KFN,RME_BOOT_INIT_KERN,
+                                  RME_PARAM_D1(RME_KOT_STAT_RETRY)|RME_PARAM_D0(RME_KFN_KOT_STAT_GET),
+                                  0,
+                                  0);
+    RME_Kot_Stat_Undo=RME_CAP_OP(RME_SVC_KFN,RME_BOOT_INIT_KERN,
+                                 RME_PARAM_D1(RME_KOT_STAT_UNDO)|RME_PARAM_D0(RME_KFN_KOT_STAT_GET),
+                                 0,
+                                 0);
+    
+    if((RME_Kot_Stat_Fail<0)||(RME_Kot_Stat_Retry<0)||(RME_Kot_Stat_Undo<0))
+        return -1;
+    return 0;
+}
+/* End Function:RME_Kot_Stress_Test ******************************************/
+
+/* Function:RME_Pgt_Unmap_Test ***********************************************
+Description : The page unmap throughput test code. A page is repeatedly mapped
+              into and removed from a page table, and the removal is timed; this
+              includes the TLB shootdown. On a multi-core target, run this with
+              the benchmark address space loaded on 1, 2, ... N cores (e.g. one
+              spinning thread of this process per core) to see how the cost of
+              unmapping scales with the core count. Time[] holds the removal
+              time of each round.
+Input       : None.
+Output      : None.
+Return      : ret_t - If the test passed, 0; else -1.
+******************************************************************************/
+ret_t RME_Pgt_Unmap_Test(void)
+{
+    ret_t Retval;
+    cnt_t Count;
+    ptr_t Temp;
+    cnt_t Fail;
+
+    /* Create the page table to map pages into */
+    Retval=RME_CAP_OP(RME_SVC_PGT_CRT,RME_BOOT_INIT_CPT,
+                      RME_PARAM_D1(RME_BOOT_INIT_KOM)|RME_PARAM_Q1(RME_BOOT_BENCH_PGT_TOP)|
+                      RME_PARAM_O1(29)|RME_PARAM_O0(3),
+                      RME_BOOT_BENCH_KOM_FRONTIER,
+                      1);
+
+    Fail=0;
+    _RME_Tsc_Init();
+    for(Count=0;Count<10000;Count++)
+    {
+        /* Map the first page of the init process into it */
+        Retval=RME_CAP_OP(RME_SVC_PGT_ADD,RME_PGT_READ,
+                          RME_PARAM_D1(RME_BOOT_BENCH_PGT_TOP)|RME_PARAM_D0(0),
+                          RME_PARAM_D1(RME_BOOT_INIT_PGT)|RME_PARAM_D0(0),
+                          0);
+
+        Temp=RME_TSC();
+        Retval=RME_CAP_OP(RME_SVC_PGT_REM,0,
+                          RME_BOOT_BENCH_PGT_TOP,
+                          0,
+                          0);
+        Temp=RME_TSC()-Temp;
+        Time[Count]=Temp-8;
+        if(Retval<0)
+            Fail++;
+    }
+
+    return (Fail==0)?0:-1;
+}
+/* End Function:RME_Pgt_Unmap_Test *******************************************/
+
+#if(RME_BENCH_PORT==RME_BENCH_PORT_X64)
+/* Function:RME_Pgdir_Unmap_Test **********************************************
+Description : The page directory unmap test code for x86-64. A 4k-page directory
+              is repeatedly constructed into and destructed from a directory of
+              2M entries, and the destruction is timed; this includes the TLB
+              shootdown. Every destruction must succeed, so
+              RME_Pgdir_Unmap_Fail should read 0. Time[] holds the destruction
+              time of each round.
 Input       : None.
 Output      : None.
+Return      : ret_t - If the test passed, 0; else -1.
+******************************************************************************/
+ret_t RME_Pgdir_Unmap_Test(void)
+{
+    ret_t Retval;
+    cnt_t Count;
+    ptr_t Temp;
+
+    /* Create the parent with 512 2M entries, and the child with 512 4k pages */
+    Retval=RME_CAP_OP(RME_SVC_PGT_CRT,RME_BOOT_INIT_CPT,
+                      RME_PARAM_D1(RME_BOOT_INIT_KOM)|RME_PARAM_Q1(RME_BOOT_BENCH_PGT_TOP)|
+                      RME_PARAM_O1(21)|RME_PARAM_O0(9),
+                      RME_BOOT_BENCH_KOM_FRONTIER,
+                      0);
+    Retval=RME_CAP_OP(RME_SVC_PGT_CRT,RME_BOOT_INIT_CPT,
+                      RME_PARAM_D1(RME_BOOT_INIT_KOM)|RME_PARAM_Q1(RME_BOOT_BENCH_PGT_SRAM)|
+                      RME_PARAM_O1(12)|RME_PARAM_O0(9),
+                      RME_BOOT_BENCH_KOM_FRONTIER+0x1000,
+                      0);
+
+    RME_Pgdir_Unmap_Fail=0;
+    _RME_Tsc_Init();
+    for(Count=0;Count<10000;Count++)
+    {
+        Retval=RME_CAP_OP(RME_SVC_PGT_CON,0,
+                          RME_PARAM_D1(RME_BOOT_BENCH_PGT_TOP)|RME_PARAM_D0(RME_BOOT_BENCH_PGT_SRAM),
+                          0,
+                          RME_PGT_ALL_PERM);
+
+        Temp=RME_TSC();
+        Retval=RME_CAP_OP(RME_SVC_PGT_DES,0,
+                          RME_BOOT_BENCH_PGT_TOP,
+                          0,
+                          RME_BOOT_BENCH_PGT_SRAM);
+        Temp=RME_TSC()-Temp;
+        Time[Count]=Temp-8;
+        if(Retval<0)
+            RME_Pgdir_Unmap_Fail++;
+    }
+
+    return (RME_Pgdir_Unmap_Fail==0)?0:-1;
+}
+/* End Function:RME_Pgdir_Unmap_Test *****************************************/
+
+/* Function:_RME_Pgr_Rcv ******************************************************
+Description : Block on the pager endpoint, for the fault forwarding test. The
+              kernel hands the faulting TID and vector over in RSI and RDX,
+              which the plain system call stub does not return, so this makes
+              the system call itself.
+Input       : None.
+Output      : ptr_t* TID - The TID of the faulting thread.
+              ptr_t* Vct - The vector of the fault.
+Return      : ret_t - The return value of the receive.
+******************************************************************************/
+ret_t _RME_Pgr_Rcv(ptr_t* TID, ptr_t* Vct)
+{
+    register ptr_t RDI __asm__("rdi");
+    register ptr_t RSI __asm__("rsi");
+    register ptr_t RDX __asm__("rdx");
+    register ptr_t R8 __asm__("r8");
+    register ptr_t R9 __asm__("r9");
+    ret_t Retval;
+    
+    RDI=(((ptr_t)RME_SVC_SIG_RCV)<<(sizeof(ptr_t)*4))|RME_BOOT_BENCH_SIG;
+    RSI=RME_RCV_BS;
+    RDX=0;
+    R8=0;
+    R9=0;
+    __asm__ __volatile__("syscall"
+                         :"=a"(Retval),"+r"(RDI),"+r"(RSI),"+r"(RDX),"+r"(R8),"+r"(R9)
+                         :
+                         :"rcx","r11","memory");
+    
+    *TID=RSI;
+    *Vct=RDX;
+    return Retval;
+}
+/* End Function:_RME_Pgr_Rcv *************************************************/
+
+/* Function:RME_Thd_Fault_Test_Thd ********************************************
+Description : The faulting thread for the fault forwarding test. Each time it
+              is started, it raises the fault that its parameter selects; the
+              pager never resumes it at the faulting instruction.
+Input       : ptr_t Param1 - 0 for #DE, 1 for #UD, 2 for #GP.
+Output      : None.
 Return      : None.
 ******************************************************************************/
-void RME_Benchmark(void)
+void RME_Thd_Fault_Test_Thd(ptr_t Param1, ptr_t Param2, ptr_t Param3, ptr_t Param4)
 {
-    RME_Same_Prc_Thd_Switch_Test();
+    if(Param1==0)
+        __asm__ __volatile__("xorq %%rcx, %%rcx\n\tdivq %%rcx":::"rax","rcx","rdx");
+    else if(Param1==1)
+        __asm__ __volatile__("ud2");
+    else
+        __asm__ __volatile__("hlt");
+    
+    while(1);
+}
+/* End Function:RME_Thd_Fault_Test_Thd ***************************************/
+
+/* Function:RME_Thd_Fault_Test ************************************************
+Description : The fault forwarding test code for x86-64. The init thread is the
+              pager of the init process, and a thread of the same priority
+              raises #DE, #UD and #GP in turn. Each fault must go through
+              _RME_Thd_Fatal to the pager rather than hang the kernel, and the
+              pager must see the right TID and vector; it then restarts the
+              thread on the next fault with RME_SVC_THD_EXEC_SET.
+              RME_Thd_Fault_Fail should read 0.
+Input       : None.
+Output      : None.
+Return      : ret_t - If the test passed, 0; else -1.
+******************************************************************************/
+ret_t RME_Thd_Fault_Test(void)
+{
+    ret_t Retval;
+    cnt_t Count;
+    ptr_t Stack_Addr;
+    ptr_t Vct[RME_BENCH_FAULT_NUM];
+    
+    Vct[0]=RME_BENCH_FAULT_DE;
+    Vct[1]=RME_BENCH_FAULT_UD;
+    Vct[2]=RME_BENCH_FAULT_GP;
+    Stack_Addr=_RME_Stack_Init((ptr_t)(&RME_Stack[2047]),
+                               (ptr_t)RME_Thd_Stub,
+                               1, 2, 3, 4);
+    
+    /* Create the pager endpoint and make it the pager of the init process */
+    Retval=RME_CAP_OP(RME_SVC_SIG_CRT,RME_BOOT_INIT_CPT,
+                      RME_BOOT_BENCH_SIG,
+                      0,
+                      0);
+    Retval=RME_CAP_OP(RME_SVC_PRC_PGR,0,
+                      RME_BOOT_INIT_PRC,
+                      RME_BOOT_BENCH_SIG,
+                      0);
+    
+    /* The faulting thread has TID 1 and the priority of the init thread, so
+     * it only runs when the init thread blocks on the pager endpoint */
+    Retval=RME_CAP_OP(RME_SVC_THD_CRT,RME_BOOT_INIT_CPT,
+                      RME_PARAM_D1(RME_BOOT_INIT_KOM)|RME_PARAM_D0(RME_BOOT_BENCH_THD),
+                      RME_PARAM_D1(RME_BOOT_INIT_PRC)|RME_PARAM_D0(0),
+                      RME_BOOT_BENCH_KOM_FRONTIER);
+    Retval=RME_CAP_OP(RME_SVC_THD_SCHED_BIND,RME_BOOT_BENCH_THD,
+                      RME_PARAM_D1(RME_BOOT_INIT_THD)|RME_PARAM_D0(RME_CID_NULL),
+                      RME_PARAM_D1(1)|RME_PARAM_D0(0),
+                      0);
+    Retval=RME_CAP_OP(RME_SVC_THD_TIME_XFER,0,
+                      RME_BOOT_BENCH_THD,
+                      RME_BOOT_INIT_THD,
+                      10000000);
+    
+    RME_Thd_Fault_Fail=0;
+    for(Count=0;Count<RME_BENCH_FAULT_NUM;Count++)
+    {
+        /* Start the thread on the next fault; this also clears the last one */
+        Retval=RME_CAP_OP(RME_SVC_THD_EXEC_SET,RME_BOOT_BENCH_THD,
+                          (ptr_t)RME_Thd_Fault_Test_Thd,
+                          Stack_Addr,
+                          Count);
+        
+        Retval=_RME_Pgr_Rcv(&RME_Thd_Fault_TID[Count],&RME_Thd_Fault_Vct[Count]);
+        if((Retval<0)||(RME_Thd_Fault_TID[Count]!=1)||(RME_Thd_Fault_Vct[Count]!=Vct[Count]))
+            RME_Thd_Fault_Fail++;
+    }
+    
+    /* Unbind the pager; the thread stays parked with the last fault */
+    Retval=RME_CAP_OP(RME_SVC_PRC_PGR,0,
+                      RME_BOOT_INIT_PRC,
+                      RME_CID_NULL,
+                      0);
+    
+    return (RME_Thd_Fault_Fail==0)?0:-1;
+}
+/* End Function:RME_Thd_Fault_Test *******************************************/
+#endif
+
+/* Function:RME_Cpt_Mig_Test **************************************************
+Description : The capability table migration test code. A 16-slot table holds a
+              root endpoint, a leaf of the timer endpoint and a cap to itself;
+              the slots are frozen, then migrated to a 32-slot table a few
+              slots at a time once quiescent, and the old table is deleted. The
+              deletion only succeeds if every slot left the old table and
+              nothing in the new one still references it, and
+              the endpoint must still be usable through the new table.
+              RME_Cpt_Mig_Snd and RME_Cpt_Mig_Del should both read 0.
+Input       : None.
+Output      : None.
+Return      : ret_t - If the test passed, 0; else -1.
+******************************************************************************/
+ret_t RME_Cpt_Mig_Test(void)
+{
+    ret_t Retval;
+    ptr_t Begin;
+    
+    /* Create the source and the destination tables */
+    Retval=RME_CAP_OP(RME_SVC_CPT_CRT,RME_BOOT_INIT_CPT,
+                      RME_PARAM_D1(RME_BOOT_INIT_KOM)|RME_PARAM_D0(RME_BOOT_BENCH_CPT),
+                      RME_BOOT_BENCH_KOM_FRONTIER,
+                      16);
+    Retval=RME_CAP_OP(RME_SVC_CPT_CRT,RME_BOOT_INIT_CPT,
+                      RME_PARAM_D1(RME_BOOT_INIT_KOM)|RME_PARAM_D0(RME_BOOT_BENCH_CPT_DST),
+                      RME_BOOT_BENCH_KOM_FRONTIER+0x1000,
+                      32);
+    
+    /* A root, a leaf of a root outside the table, and a cap to the table itself */
+    Retval=RME_CAP_OP(RME_SVC_SIG_CRT,RME_BOOT_BENCH_CPT,
+                      0,
+                      0,
+                      0);
+    Retval=RME_CAP_OP(RME_SVC_CPT_ADD,0,
+                      RME_PARAM_D1(RME_BOOT_BENCH_CPT)|RME_PARAM_D0(1),
+                      RME_PARAM_D1(RME_BOOT_INIT_CPT)|RME_PARAM_D0(RME_BOOT_INIT_TIMER),
+                      RME_SIG_FLAG_SND);
+    Retval=RME_CAP_OP(RME_SVC_CPT_ADD,0,
+                      RME_PARAM_D1(RME_BOOT_BENCH_CPT)|RME_PARAM_D0(2),
+                      RME_PARAM_D1(RME_BOOT_INIT_CPT)|RME_PARAM_D0(RME_BOOT_BENCH_CPT),
+                      RME_CPT_FLAG_ALL);
+    
+    /* Slots must be frozen before they can move, as for a removal */
+    for(Begin=0;Begin<3;Begin++)
+    {
+        Retval=RME_CAP_OP(RME_SVC_CPT_FRZ,RME_BOOT_BENCH_CPT,
+                          Begin,
+                          0,
+                          0);
+    }
+    
+    /* Migrate 4 slots at a time, waiting until the slots are quiescent */
+    Begin=0;
+    while(Begin<16)
+    {
+        Retval=RME_CAP_OP(RME_SVC_CPT_MIG,0,
+                          RME_PARAM_D1(RME_BOOT_BENCH_CPT_DST)|RME_PARAM_D0(RME_BOOT_BENCH_CPT),
+                          Begin,
+                          4);
+        if(Retval==RME_ERR_CPT_QUIE)
+            continue;
+        if(Retval<0)
+            break;
+        Begin=(ptr_t)Retval;
+    }
+    
+    /* The endpoint now lives in the new table */
+    RME_Cpt_Mig_Snd=RME_CAP_OP(RME_SVC_SIG_SND,0,
+                               RME_CAPID(RME_BOOT_BENCH_CPT_DST,0),
+                               0,
+                               0);
+    
+    /* The old table must be deletable once it is quiescent */
+    do
+    {
+        Retval=RME_CAP_OP(RME_SVC_CPT_FRZ,RME_BOOT_INIT_CPT,
+                          RME_BOOT_BENCH_CPT,
+                          0,
+                          0);
+        RME_Cpt_Mig_Del=RME_CAP_OP(RME_SVC_CPT_DEL,RME_BOOT_INIT_CPT,
+                                   RME_BOOT_BENCH_CPT,
+                                   0,
+                                   0);
+    }
+    while(RME_Cpt_Mig_Del==RME_ERR_CPT_QUIE);
+    
+    return ((RME_Cpt_Mig_Snd==0)&&(RME_Cpt_Mig_Del==0))?0:-1;
+}
+/* End Function:RME_Cpt_Mig_Test *********************************************/
+
+#if(RME_BENCH_PORT==RME_BENCH_PORT_A7A)
+/* Function:RME_Prc_ASID_Switch_Test *****************************************
+Description : The cross-process thread switch test code for ARMv7-A, where the
+              user mappings are tagged with ASIDs. A second process is built
+              with a top-level table that maps the same sections as the init
+              process, and the init thread and its thread keep switching to
+              each other. Each switch changes the address space, so this shows
+              the cost of the ASID switch; compare it with a kernel that flushes
+              the TLB on every switch. Time[] holds the round trip times, in
+              ticks of the generic timer. Only built for the A7A port.
+Input       : None.
+Output      : None.
+Return      : ret_t - If the test passed, 0; else -1.
+******************************************************************************/
+ret_t RME_Prc_ASID_Switch_Test(void)
+{
+    ret_t Retval;
+    cnt_t Count;
+    ptr_t Stack_Addr;
+    ptr_t Temp;
+    ptr_t Frontier;
+    cnt_t Fail;
+    
+    /* The top-level table is 16kB and must be aligned to that */
+    Frontier=(RME_BOOT_BENCH_KOM_FRONTIER+0x3FFF)&(~((ptr_t)0x3FFF));
+    Stack_Addr=_RME_Stack_Init((ptr_t)(&RME_Stack[2047]),
+                               (ptr_t)RME_Thd_Stub,
+                               1, 2, 3, 4);
+    
+    /* Create the top-level table with 4096 1MB sections */
+    Retval=RME_CAP_OP(RME_SVC_PGT_CRT,RME_BOOT_INIT_CPT,
+                      RME_PARAM_D1(RME_BOOT_INIT_KOM)|RME_PARAM_Q1(RME_BOOT_BENCH_PGT_TOP)|
+                      RME_PARAM_O1(20)|RME_PARAM_O0(12),
+                      Frontier,
+                      1);
+    Frontier+=0x4000;
+    
+    /* Map the user half of the init process into it; absent sections just fail */
+    for(Count=0;Count<2048;Count++)
+    {
+        Retval=RME_CAP_OP(RME_SVC_PGT_ADD,RME_PGT_READ|RME_PGT_WRITE|RME_PGT_EXECUTE|
+                                          RME_PGT_CACHE|RME_PGT_BUFFER,
+                          RME_PARAM_D1(RME_BOOT_BENCH_PGT_TOP)|RME_PARAM_D0(Count),
+                          RME_PARAM_D1(RME_BOOT_INIT_PGT)|RME_PARAM_D0(Count),
+                          0);
+    }
+    
+    /* Create the process and its thread */
+    Retval=RME_CAP_OP(RME_SVC_PRC_CRT,RME_BOOT_INIT_CPT,
+                      RME_BOOT_BENCH_PRC,
+                      RME_BOOT_INIT_CPT,
+                      RME_BOOT_BENCH_PGT_TOP);
+    Retval=RME_CAP_OP(RME_SVC_THD_CRT,RME_BOOT_INIT_CPT,
+                      RME_PARAM_D1(RME_BOOT_INIT_KOM)|RME_PARAM_D0(RME_BOOT_BENCH_THD),
+                      RME_PARAM_D1(RME_BOOT_BENCH_PRC)|RME_PARAM_D0(31),
+                      Frontier);
+    
+    /* Bind the thread to the processor */
+    Retval=RME_CAP_OP(RME_SVC_THD_SCHED_BIND,0,
+                      RME_BOOT_BENCH_THD,
+                      RME_BOOT_INIT_THD,
+                      0);
+    
+    /* Set the execution information */
+    Retval=RME_CAP_OP(RME_SVC_THD_EXEC_SET,0,
+                      RME_BOOT_BENCH_THD,
+                      (ptr_t)RME_Diff_Prc_Thd_Switch_Test_Thd,
+                      Stack_Addr);
+                      
+    /* Delegate some timeslice to it */
+    Retval=RME_CAP_OP(RME_SVC_THD_TIME_XFER,0,
+                      RME_BOOT_BENCH_THD,
+                      RME_BOOT_INIT_THD,
+                      10000000);
+    
+    Fail=0;
+    _RME_Tsc_Init();
+    for(Count=0;Count<10000;Count++)
+    {
+        Temp=RME_TSC();
+        Retval=RME_CAP_OP(RME_SVC_THD_SWT,0,
+                          RME_BOOT_BENCH_THD,
+                          0,
+                          0);
+        Temp=RME_TSC()-Temp;
+        Time[Count]=Temp-8;
+        if(Retval<0)
+            Fail++;
+    }
+    
+    return (Fail==0)?0:-1;
+}
+/* End Function:RME_Prc_ASID_Switch_Test *************************************/
+#endif
+
+#if((RME_BENCH_PORT==RME_BENCH_PORT_A7A)||(RME_BENCH_PORT==RME_BENCH_PORT_X64))
+/* Function:RME_Tick_Test *****************************************************
+Description : The per-CPU tick test code for the multi-core ports. The init
+              thread of every core calls this with its own CPUID, and counts
+              the ticks that arrive at the timer endpoint of its core until it
+              has seen RME_BENCH_TICK_NUM of them. Every core must get its own
+              ticks from its own timer; a core that only gets ticks relayed
+              from another, or none at all, shows up as a count that stalls or
+              as intervals far off the tick period. Afterwards RME_Tick_Cnt[]
+              should read RME_BENCH_TICK_NUM on every core, and RME_Tick_Min[]
+              and RME_Tick_Max[] hold the interval range in TSC ticks. CPU 0
+              waits for the other cores to finish, so the verdict never comes
+              if a core stalls.
+Input       : ptr_t CPUID - The CPU that this init thread runs on.
+Output      : None.
+Return      : ret_t - If the test passed, 0; else -1.
+******************************************************************************/
+ret_t RME_Tick_Test(ptr_t CPUID)
+{
+    ret_t Retval;
+    ptr_t Last;
+    ptr_t Temp;
+    cnt_t Count;
+    
+    if(CPUID>=RME_BENCH_CPU_NUM)
+        while(1);
+    
+    RME_Tick_Cnt[CPUID]=0;
+    RME_Tick_Min[CPUID]=(ptr_t)(-1);
+    RME_Tick_Max[CPUID]=0;
+    _RME_Tsc_Init();
+    
+    /* Start from a tick boundary, and drop whatever was pending */
+    Retval=RME_CAP_OP(RME_SVC_SIG_RCV,0,
+                      RME_CAPID(RME_BOOT_TBL_TIMER,CPUID),
+                      RME_RCV_BM,
+                      0);
+    Last=RME_TSC();
+    
+    while(RME_Tick_Cnt[CPUID]<RME_BENCH_TICK_NUM)
+    {
+        /* Take all ticks that came in since the last receive */
+        Retval=RME_CAP_OP(RME_SVC_SIG_RCV,0,
+                          RME_CAPID(RME_BOOT_TBL_TIMER,CPUID),
+                          RME_RCV_BM,
+                          0);
+        Temp=RME_TSC();
+        if(Retval<=0)
+            continue;
+        
+        RME_Tick_Cnt[CPUID]+=(ptr_t)Retval;
+        /* Only single ticks give a meaningful interval */
+        if(Retval==1)
+        {
+            if((Temp-Last)<RME_Tick_Min[CPUID])
+                RME_Tick_Min[CPUID]=Temp-Last;
+            if((Temp-Last)>RME_Tick_Max[CPUID])
+                RME_Tick_Max[CPUID]=Temp-Last;
+        }
+        Last=Temp;
+    }
+    
+    if(CPUID!=0)
+        return 0;
+    
+    /* Every core must have seen its ticks, and at least one lone tick */
+    for(Count=0;Count<RME_BENCH_CPU_NUM;Count++)
+    {
+        while(RME_Tick_Cnt[Count]<RME_BENCH_TICK_NUM);
+        if(RME_Tick_Max[Count]==0)
+            return -1;
+    }
+    
+    return 0;
+}
+/* End Function:RME_Tick_Test ************************************************/
+#endif
+
+/* Function:RME_Int_Latency_Test_Thd *****************************************
+Description : The driver thread for testing interrupt latency. It waits on the
+              endpoint that the vector is bound to, and takes the timestamp as
+              the first thing it does after waking up. It then unmasks the
+              vector, which the kernel masked when delivering it.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Int_Latency_Test_Thd(ptr_t Param1, ptr_t Param2, ptr_t Param3, ptr_t Param4)
+{
+    ret_t Retval;
+    cnt_t Count;
+    
+    for(Count=0;Count<10000;Count++)
+    {
+        Retval=RME_CAP_OP(RME_SVC_SIG_RCV,0,
+                          RME_BOOT_BENCH_SIG,
+                          RME_RCV_BS,
+                          0);
+        Time[Count]=RME_TSC()-RME_Int_Stamp-8;
+        
+        Retval=RME_CAP_OP(RME_SVC_KFN,RME_BOOT_INIT_KERN,
+                          RME_PARAM_D1(RME_BENCH_INT_VCT)|RME_PARAM_D0(RME_KFN_INT_LOCAL_MOD),
+                          RME_BENCH_INT_LOCAL_MOD_STATE_SET,
+                          1);
+    }
+    
+    /* Block forever so that the init thread can summarize the results */
+    while(1)
+    {
+        Retval=RME_CAP_OP(RME_SVC_SIG_RCV,0,
+                          RME_BOOT_BENCH_SIG,
+                          RME_RCV_BS,
+                          0);
+    }
+}
+/* End Function:RME_Int_Latency_Test_Thd ************************************/
+
+/* Function:RME_Int_Latency_Test *********************************************
+Description : The interrupt-to-thread latency test code. The init thread bumps
+              a vector with RME_KFN_INT_LOCAL_TRIG, and the time it takes until
+              the driver thread runs is the whole path through the vector
+              handler, the kernel send and the scheduler. The driver has a
+              higher priority than the init thread, so it runs as soon as the
+              vector is taken. Time[] holds each latency; the minimum, average,
+              maximum, jitter (maximum minus minimum) and a histogram are then
+              computed. RME_TSC() is the port's own counter, so the same test
+              runs unchanged on the A7M and RV32P boards and QEMU machines.
+Input       : None.
+Output      : None.
+Return      : ret_t - If the test passed, 0; else -1.
+******************************************************************************/
+ret_t RME_Int_Latency_Test(void)
+{
+    ret_t Retval;
+    cnt_t Count;
+    ptr_t Stack_Addr;
+    ptr_t Sum;
+    ptr_t Bucket;
+    cnt_t Fail;
+    
+    Stack_Addr=_RME_Stack_Init((ptr_t)(&RME_Stack[2047]),
+                               (ptr_t)RME_Thd_Stub,
+                               1, 2, 3, 4);
+    
+    /* Create the endpoint and bind the vector to it */
+    Retval=RME_CAP_OP(RME_SVC_SIG_CRT,RME_BOOT_INIT_CPT,
+                      RME_BOOT_BENCH_SIG,
+                      0,
+                      0);
+    Retval=RME_CAP_OP(RME_SVC_KFN,RME_BOOT_INIT_KERN,
+                      RME_PARAM_D1(RME_BENCH_INT_VCT)|RME_PARAM_D0(RME_KFN_INT_LOCAL_MOD),
+                      RME_BENCH_INT_LOCAL_MOD_SIG_SET,
+                      RME_BOOT_BENCH_SIG);
+    Retval=RME_CAP_OP(RME_SVC_KFN,RME_BOOT_INIT_KERN,
+                      RME_PARAM_D1(RME_BENCH_INT_VCT)|RME_PARAM_D0(RME_KFN_INT_LOCAL_MOD),
+                      RME_BENCH_INT_LOCAL_MOD_STATE_SET,
+                      1);
+    
+    /* Create the driver thread in the init process */
+    Retval=RME_CAP_OP(RME_SVC_THD_CRT,RME_BOOT_INIT_CPT,
+                      RME_PARAM_D1(RME_BOOT_INIT_KOM)|RME_PARAM_D0(RME_BOOT_BENCH_THD),
+                      RME_PARAM_D1(RME_BOOT_INIT_PRC)|RME_PARAM_D0(31),
+                      RME_BOOT_BENCH_KOM_FRONTIER);
+    Retval=RME_CAP_OP(RME_SVC_THD_SCHED_BIND,0,
+                      RME_BOOT_BENCH_THD,
+                      RME_BOOT_INIT_THD,
+                      0);
+    Retval=RME_CAP_OP(RME_SVC_THD_EXEC_SET,0,
+                      RME_BOOT_BENCH_THD,
+                      (ptr_t)RME_Int_Latency_Test_Thd,
+                      Stack_Addr);
+    Retval=RME_CAP_OP(RME_SVC_THD_TIME_XFER,0,
+                      RME_BOOT_BENCH_THD,
+                      RME_BOOT_INIT_THD,
+                      10000000);
+    
+    /* Let the driver block on the endpoint first */
+    Retval=RME_CAP_OP(RME_SVC_THD_SWT,0,
+                      RME_BOOT_BENCH_THD,
+                      0,
+                      0);
+    
+    Fail=0;
+    _RME_Tsc_Init();
+    for(Count=0;Count<10000;Count++)
+    {
+        RME_Int_Stamp=RME_TSC();
+        Retval=RME_CAP_OP(RME_SVC_KFN,RME_BOOT_INIT_KERN,
+                          RME_PARAM_D1(0)|RME_PARAM_D0(RME_KFN_INT_LOCAL_TRIG),
+                          RME_BENCH_INT_VCT,
+                          0);
+        if(Retval<0)
+            Fail++;
+    }
+    
+    /* Summarize the results */
+    RME_Int_Min=(ptr_t)(-1);
+    RME_Int_Max=0;
+    Sum=0;
+    for(Count=0;Count<RME_BENCH_HIST_NUM;Count++)
+        RME_Int_Hist[Count]=0;
+    for(Count=0;Count<10000;Count++)
+    {
+        if(Time[Count]<RME_Int_Min)
+            RME_Int_Min=Time[Count];
+        if(Time[Count]>RME_Int_Max)
+            RME_Int_Max=Time[Count];
+        Sum+=Time[Count];
+        
+        Bucket=Time[Count]>>RME_BENCH_HIST_ORDER;
+        if(Bucket>=RME_BENCH_HIST_NUM)
+            Bucket=RME_BENCH_HIST_NUM-1;
+        RME_Int_Hist[Bucket]++;
+    }
+    RME_Int_Avg=Sum/10000;
+    RME_Int_Jitter=RME_Int_Max-RME_Int_Min;
+    
+    return (Fail==0)?0:-1;
+}
+/* End Function:RME_Int_Latency_Test *****************************************/
+
+/* Function:RME_Benchmark *****************************************************
+Description : The benchmark entry, also the init thread. It runs the test that
+              RME_BENCH_TEST selects, and leaves the verdict in RME_Bench_Result;
+              the timings and other results stay in their own variables. Only
+              the tick test runs on more than one core; the init threads of the
+              other cores just park otherwise.
+Input       : ptr_t CPUID - The CPU that this init thread runs on, as the
+                            multi-core ports pass it; 0 on the others.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void RME_Benchmark(ptr_t CPUID)
+{
+    ret_t Retval;
+    
+#if((RME_BENCH_TEST==RME_BENCH_TEST_TICK)&& \
+    ((RME_BENCH_PORT==RME_BENCH_PORT_A7A)||(RME_BENCH_PORT==RME_BENCH_PORT_X64)))
+    if(CPUID!=0)
+    {
+        Retval=RME_Tick_Test(CPUID);
+        while(1);
+    }
+#else
+    if(CPUID!=0)
+        while(1);
+#endif
+    
+    RME_Bench_Result=RME_BENCH_RUNNING;
+#if(RME_BENCH_TEST==RME_BENCH_TEST_SAME_PRC_THD_SWT)
+    Retval=RME_Same_Prc_Thd_Switch_Test();
+#elif(RME_BENCH_TEST==RME_BENCH_TEST_CPT_CACHE)
+    Retval=RME_Cpt_Cache_Test();
+#elif(RME_BENCH_TEST==RME_BENCH_TEST_KOT_STRESS)
+    Retval=RME_Kot_Stress_Test();
+#elif(RME_BENCH_TEST==RME_BENCH_TEST_PGT_UNMAP)
+    Retval=RME_Pgt_Unmap_Test();
+#elif((RME_BENCH_TEST==RME_BENCH_TEST_PGDIR_UNMAP)&&(RME_BENCH_PORT==RME_BENCH_PORT_X64))
+    Retval=RME_Pgdir_Unmap_Test();
+#elif((RME_BENCH_TEST==RME_BENCH_TEST_THD_FAULT)&&(RME_BENCH_PORT==RME_BENCH_PORT_X64))
+    Retval=RME_Thd_Fault_Test();
+#elif(RME_BENCH_TEST==RME_BENCH_TEST_CPT_MIG)
+    Retval=RME_Cpt_Mig_Test();
+#elif((RME_BENCH_TEST==RME_BENCH_TEST_PRC_ASID_SWT)&&(RME_BENCH_PORT==RME_BENCH_PORT_A7A))
+    Retval=RME_Prc_ASID_Switch_Test();
+#elif(RME_BENCH_TEST==RME_BENCH_TEST_INT_LATENCY)
+    Retval=RME_Int_Latency_Test();
+#elif((RME_BENCH_TEST==RME_BENCH_TEST_TICK)&& \
+      ((RME_BENCH_PORT==RME_BENCH_PORT_A7A)||(RME_BENCH_PORT==RME_BENCH_PORT_X64)))
+    Retval=RME_Tick_Test(0);
+#else
+#error The selected test is not available on this port.
+#endif
+    
+    if(Retval==0)
+        RME_Bench_Result=RME_BENCH_PASS;
+    else
+        RME_Bench_Result=RME_BENCH_FAIL;
+    
+    while(1);
 }
 /* End Function:RME_Benchmark ************************************************/
 
@@ -1393,6 +1393,29 @@ void _RME_Svc_Handler(struct RME_Reg_Struct* Reg)
                                 (rme_cid_t)Param[0]);                       /* rme_cid_t Cap_Rem */
             break;
         }
+        case RME_SVC_CPT_MIG:
+        {
+            RME_COV_MARKER();
+            
+            Retval=_RME_Cpt_Mig(Cpt,
+                                (rme_cid_t)RME_PARAM_D1(Param[0]),          /* rme_cid_t Cap_Cpt_Dst */
+                                (rme_cid_t)RME_PARAM_D0(Param[0]),          /* rme_cid_t Cap_Cpt_Src */
+                                Param[1],                                   /* rme_ptr_t Begin */
+                                Param[2]);                                  /* rme_ptr_t Num */
+            break;
+        }
+#if(RME_CPT_DRV_ENABLE!=0U)
+        case RME_SVC_CPT_RVK:
+        {
+            RME_COV_MARKER();
+            
+            Retval=_RME_Cpt_Rvk(Cpt,
+                                (rme_cid_t)Cid,                             /* rme_cid_t Cap_Cpt_Rvk */
+                                (rme_cid_t)Param[0],                        /* rme_cid_t Cap_Rvk */
+                                Param[1]);                                  /* rme_ptr_t Num */
+            break;
+        }
+#endif
         
         /* Page table */
 #if(RME_PGT_RAW_ENABLE==0U)
@@ -1433,6 +1456,20 @@ void _RME_Svc_Handler(struct RME_Reg_Struct* Reg)
                                 Param[2]);                                  /* rme_ptr_t Index */
             break;
         }
+        case RME_SVC_PGT_ADD_RNG:
+        {
+            RME_COV_MARKER();
+            
+            Retval=_RME_Pgt_Add_Rng(Cpt,
+                                    (rme_cid_t)RME_PARAM_D1(Param[0]),      /* rme_cid_t Cap_Pgt_Dst */
+                                    RME_PARAM_D0(Param[0]),                 /* rme_ptr_t Pos_Dst */
+                                    Cid,                                    /* rme_ptr_t Flag_Dst */
+                                    (rme_cid_t)RME_PARAM_D1(Param[1]),      /* rme_cid_t Cap_Pgt_Src */
+                                    RME_PARAM_D0(Param[1]),                 /* rme_ptr_t Pos_Src */
+                                    RME_PARAM_D0(Param[2]),                 /* rme_ptr_t Index */
+                                    RME_PARAM_D1(Param[2]));                /* rme_ptr_t Num */
+            break;
+        }
         case RME_SVC_PGT_REM:
         {
             RME_COV_MARKER();
@@ -1514,6 +1551,15 @@ void _RME_Svc_Handler(struct RME_Reg_Struct* Reg)
 #endif
             break;
         }
+        case RME_SVC_PRC_PGR:
+        {
+            RME_COV_MARKER();
+            
+            Retval=_RME_Prc_Pgr(Cpt,
+                                (rme_cid_t)Param[0],                        /* rme_cid_t Cap_Prc */
+                                (rme_cid_t)Param[1]);                       /* rme_cid_t Cap_Sig */
+            break;
+        }
         
         /* Thread */
         case RME_SVC_THD_CRT:
@@ -1799,6 +1845,7 @@ rme_ret_t _RME_Cpt_Boot_Init(rme_cid_t Cap_Cpt,
     Cpt->Head.Root_Ref=1U;
     Cpt->Head.Object=Vaddr;
     Cpt->Head.Flag=RME_CPT_FLAG_ALL;
+    RME_CAP_DRV_INIT(Cpt);
     
     /* Info init */
     Cpt->Entry_Num=Entry_Num;
@@ -1882,10 +1929,20 @@ rme_ret_t _RME_Cpt_Boot_Crt(struct RME_Cap_Cpt* Cpt,
         /* No action required */
     }
 
-    /* Object init */
-    for(Count=0U;Count<Entry_Num;Count++)
+    /* Object init - skipped if the memory was zeroed in advance */
+    if(RME_KOT_CLEAN_CHK(Vaddr,RME_CPT_SIZE(Entry_Num))==0U)
     {
-        RME_CAP_CLEAR(&(((struct RME_Cap_Struct*)Vaddr)[Count]));
+        RME_COV_MARKER();
+        
+        for(Count=0U;Count<Entry_Num;Count++)
+        {
+            RME_CAP_CLEAR(&(((struct RME_Cap_Struct*)Vaddr)[Count]));
+        }
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
     }
 
     /* Header init */
@@ -1994,10 +2051,20 @@ static rme_ret_t _RME_Cpt_Crt(struct RME_Cap_Cpt* Cpt,
         /* No action required */
     }
 
-    /* Object init */
-    for(Count=0U;Count<Entry_Num;Count++)
+    /* Object init - skipped if the memory was zeroed in advance */
+    if(RME_KOT_CLEAN_CHK(Vaddr,RME_CPT_SIZE(Entry_Num))==0U)
     {
-        RME_CAP_CLEAR(&(((struct RME_Cap_Struct*)Vaddr)[Count]));
+        RME_COV_MARKER();
+        
+        for(Count=0U;Count<Entry_Num;Count++)
+        {
+            RME_CAP_CLEAR(&(((struct RME_Cap_Struct*)Vaddr)[Count]));
+        }
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
     }
 
     /* Header init */
@@ -2192,6 +2259,21 @@ static rme_ret_t _RME_Cpt_Frz(struct RME_Cap_Cpt* Cpt,
                                     RME_CAP_STAT_FROZEN,
                                     RME_CAP_ATTR(Type_Stat)));
 
+#if(RME_CPT_CACHE_NUM!=0U)
+    /* Captbl frozen - invalidate all cached 2-level lookups on all CPUs */
+    if(RME_CAP_TYPE(Type_Stat)==RME_CAP_TYPE_CPT)
+    {
+        RME_COV_MARKER();
+        
+        RME_FETCH_ADD(&RME_Cpt_Cache_Gen,1);
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+#endif
+
     return 0;
 }
 /* End Function:_RME_Cpt_Frz *************************************************/
@@ -2564,6 +2646,12 @@ static rme_ret_t _RME_Cpt_Add(struct RME_Cap_Cpt* Cpt,
         /* Increase the parent's refcnt - never overflows, guaranteed by field size */
         RME_FETCH_ADD(&(((struct RME_Cap_Struct*)
                         (Capobj_Dst->Head.Root_Ref))->Head.Root_Ref),1);
+#if(RME_CPT_DRV_ENABLE!=0U)
+        /* Link into the root's derivation list */
+        _RME_List_Ins(&(Capobj_Dst->Head.Drv),
+                      &(((struct RME_Cap_Struct*)(Capobj_Dst->Head.Root_Ref))->Head.Drv),
+                      ((struct RME_Cap_Struct*)(Capobj_Dst->Head.Root_Ref))->Head.Drv.Next);
+#endif
     }
     else
     {
@@ -2627,6 +2715,10 @@ static rme_ret_t _RME_Cpt_Rem(struct RME_Cap_Cpt* Cpt,
         Capobj_Root=(struct RME_Cap_Struct*)(Capobj_Rem->Head.Root_Ref);
         
         RME_CAP_DELETE(Capobj_Rem,Type_Stat);
+#if(RME_CPT_DRV_ENABLE!=0U)
+        /* Unlink from the root's derivation list */
+        _RME_List_Del(Capobj_Rem->Head.Drv.Prev,Capobj_Rem->Head.Drv.Next);
+#endif
 
         /* Check done, decrease its parent's refcnt - this must be done at last */
         RME_FETCH_ADD(&(Capobj_Root->Head.Root_Ref),-1);
@@ -2643,72 +2735,94 @@ static rme_ret_t _RME_Cpt_Rem(struct RME_Cap_Cpt* Cpt,
 }
 /* End Function:_RME_Cpt_Rem *************************************************/
 
-/* Function:_RME_Pgt_Boot_Crt *************************************************
-Description : Create a boot-time page table.
-              This function does not require a kernel memory capability.
+/* Function:_RME_Cpt_Mig ******************************************************
+Description : Migrate a chunk of capabilities from one capability table to a
+              larger one, so that a capability table can be grown online. Like
+              removal and deletion, migration only works on slots that the user
+              has frozen beforehand and that have become quiescent since, so no
+              other CPU can still be using a slot when it moves. Each such slot
+              in the chunk is moved to the same position in the destination
+              table with its original flags, becoming valid again there, and
+              the source slot is emptied, so the source table can be deleted
+              afterwards. A leaf keeps its root, and the reference count is
+              carried over rather than taken anew; a root only moves when
+              nothing refers to it, because its leaves point back at the slot
+              it sits in. Captbl capabilities referring to the source table
+              itself become leaves of the destination table, and release their
+              reference on the source table in the same step. Empty slots and
+              occupied destination slots are skipped, so a chunk may be safely
+              retried. A slot that is not frozen, not yet quiescent, or is a
+              referenced root stops the chunk there; the user fixes that and
+              calls again. At most RME_CPT_MIG_MAX
+              slots are processed per call to keep the operation bounded; the
+              user calls this repeatedly until the whole table is migrated,
+              then switches the process over with _RME_Prc_Cpt, which swaps
+              the table atomically.
 Input       : struct RME_Cap_Cpt* Cpt - The master capability table.
-              rme_cid_t Cap_Cpt - The capability table that contains the newly
-                                  created cap to pgtbl.
-                                  2-Level.
-              rme_cid_t Cap_Pgt - The capability slot that you want this newly
-                                  created page table capability to be in.
-                                  1-Level.
-              rme_ptr_t Vaddr - The virtual address to store the page table.
-              rme_ptr_t Base - The virtual address to start mapping for this
-                               page table. This address must be aligned to the
-                               total size of the table.
-              rme_ptr_t Is_Top - Whether this page table is the top-level. If
-                                 it is, we will map all the kernel page
-                                 directories into it.
-              rme_ptr_t Size_Order - The size order of the page table. The size
-                                     refers to the size of each page in the
-                                     page directory.
-              rme_ptr_t Num_Order - The number order of entries in the page
-                                    table.
+              rme_cid_t Cap_Cpt_Dst - The capability to the destination 
+                                      capability table.
+                                      2-Level.
+              rme_cid_t Cap_Cpt_Src - The capability to the source capability
+                                      table.
+                                      2-Level.
+              rme_ptr_t Begin - The first slot position to migrate.
+              rme_ptr_t Num - The number of slots to migrate.
 Output      : None.
-Return      : rme_ret_t - If successful, 0; or an error code.
+Return      : rme_ret_t - If successful, the next slot position to migrate;
+                          or an error code. When the first slot stops the
+                          chunk, RME_ERR_CPT_FROZEN, RME_ERR_CPT_QUIE or
+                          RME_ERR_CPT_REFCNT tells why.
 ******************************************************************************/
-#if(RME_PGT_RAW_ENABLE==0U)
-rme_ret_t _RME_Pgt_Boot_Crt(struct RME_Cap_Cpt* Cpt,
-                            rme_cid_t Cap_Cpt,
-                            rme_cid_t Cap_Pgt,
-                            rme_ptr_t Vaddr,
-                            rme_ptr_t Base,
-                            rme_ptr_t Is_Top,
-                            rme_ptr_t Size_Order,
-                            rme_ptr_t Num_Order)
+static rme_ret_t _RME_Cpt_Mig(struct RME_Cap_Cpt* Cpt,
+                              rme_cid_t Cap_Cpt_Dst,
+                              rme_cid_t Cap_Cpt_Src,
+                              rme_ptr_t Begin,
+                              rme_ptr_t Num)
 {
-    struct RME_Cap_Cpt* Cpt_Op;
-    struct RME_Cap_Pgt* Pgt_Crt;
+    struct RME_Cap_Cpt* Cpt_Dst;
+    struct RME_Cap_Cpt* Cpt_Src;
+    struct RME_Cap_Struct* Capobj_Dst;
+    struct RME_Cap_Struct* Capobj_Src;
+    struct RME_Cap_Struct* Capobj_Root;
     rme_ptr_t Type_Stat;
-    rme_ptr_t Table_Size;
+    rme_ptr_t Mov_Stat;
+    rme_ptr_t Src_Type;
+    rme_ptr_t Src_Attr;
+    rme_ptr_t Self;
+    rme_ptr_t Flag;
+    rme_ptr_t End;
+    rme_ptr_t Count;
+
+    /* Get the capability slots */
+    RME_CPT_GETCAP(Cpt,Cap_Cpt_Dst,RME_CAP_TYPE_CPT,
+                   struct RME_Cap_Cpt*,Cpt_Dst,Type_Stat);
+    RME_CPT_GETCAP(Cpt,Cap_Cpt_Src,RME_CAP_TYPE_CPT,
+                   struct RME_Cap_Cpt*,Cpt_Src,Type_Stat);
+    /* Check if both captbls are not frozen and allows such operations */
+    RME_CAP_CHECK(Cpt_Dst,RME_CPT_FLAG_ADD_DST);
+    RME_CAP_CHECK(Cpt_Src,RME_CPT_FLAG_ADD_SRC);
     
-    /* Check if the total representable memory exceeds our maximum possible
-     * addressible memory under the machine word length */
-    if(RME_UNLIKELY((Size_Order+Num_Order)>RME_POW2(RME_WORD_ORDER)))
+    /* The destination must be able to hold everything in the source, and must
+     * not be the source itself */
+    if(RME_UNLIKELY((Cpt_Dst->Entry_Num<Cpt_Src->Entry_Num)||
+                    (Cpt_Dst->Head.Object==Cpt_Src->Head.Object)))
     {
         RME_COV_MARKER();
         
-        return RME_ERR_PGT_HW;
+        return RME_ERR_CPT_RANGE;
     }
     else
     {
         RME_COV_MARKER();
         /* No action required */
     }
-
-    /* Get the cap location that we care about */
-    RME_CPT_GETCAP(Cpt,Cap_Cpt,RME_CAP_TYPE_CPT,
-                   struct RME_Cap_Cpt*,Cpt_Op,Type_Stat);
-    /* Check if the target captbl is not frozen and allows such operations */
-    RME_CAP_CHECK(Cpt_Op,RME_CPT_FLAG_CRT);
     
-    /* Check if these parameters are feasible */
-    if(RME_UNLIKELY(__RME_Pgt_Check(Base,Is_Top,Size_Order,Num_Order,Vaddr)!=0))
+    /* Is the chunk within range? */
+    if(RME_UNLIKELY((Begin>=Cpt_Src->Entry_Num)||(Num==0U)))
     {
         RME_COV_MARKER();
         
-        return RME_ERR_PGT_HW;
+        return RME_ERR_CPT_RANGE;
     }
     else
     {
@@ -2716,45 +2830,12 @@ rme_ret_t _RME_Pgt_Boot_Crt(struct RME_Cap_Cpt* Cpt,
         /* No action required */
     }
     
-    /* Check if the base address is properly aligned to the total order of the page table */
-    if(RME_UNLIKELY((Base&RME_MASK_END(Size_Order+Num_Order-1U))!=0U))
-    {
-        RME_COV_MARKER();
-
-        return RME_ERR_PGT_HW;
-    }
-    else
-    {
-        RME_COV_MARKER();
-        /* No action required */
-    }
-
-    /* Get the cap slot */
-    RME_CPT_GETSLOT(Cpt_Op,Cap_Pgt,struct RME_Cap_Pgt*,Pgt_Crt);
-    /* Take the slot if possible */
-    RME_CPT_OCCUPY(Pgt_Crt);
-
-    /* Are we creating the top level? */
-    if(Is_Top!=0U)
-    {
-        RME_COV_MARKER();
-        
-        Table_Size=RME_PGT_SIZE_TOP(Num_Order);
-    }
-    else
+    /* Bound the chunk so the operation stays preemptible between calls */
+    if(Num>RME_CPT_MIG_MAX)
     {
         RME_COV_MARKER();
         
-        Table_Size=RME_PGT_SIZE_NOM(Num_Order);
-    }
-    
-    /* Try to populate the area */
-    if(RME_UNLIKELY(_RME_Kot_Mark(Vaddr, Table_Size)!=0))
-    {
-        RME_COV_MARKER();
-    
-        RME_WRITE_RELEASE(&(Pgt_Crt->Head.Type_Stat),0U);
-        return RME_ERR_CPT_KOT;
+        Num=RME_CPT_MIG_MAX;
     }
     else
     {
@@ -2762,113 +2843,587 @@ rme_ret_t _RME_Pgt_Boot_Crt(struct RME_Cap_Cpt* Cpt,
         /* No action required */
     }
     
-    /* Header init */
-    Pgt_Crt->Head.Root_Ref=0U;
-    Pgt_Crt->Head.Object=Vaddr;
-    /* Set the property of the page table to only act as source and creating process */
-    Pgt_Crt->Head.Flag=RME_PGT_FLAG_FULL_RANGE|RME_PGT_FLAG_ADD_SRC|
-                       RME_PGT_FLAG_PRC_CRT|RME_PGT_FLAG_PRC_PGT;
-    
-    /* Info init */
-    Pgt_Crt->Base=Base|Is_Top;
-    Pgt_Crt->Order=RME_PGT_ORDER(Size_Order,Num_Order);
-    Pgt_Crt->ASID=0U;
-
-    /* Object init - need to add all kernel pages if they are top-level */
-    if(RME_UNLIKELY(__RME_Pgt_Init(Pgt_Crt)<0))
+    End=Begin+Num;
+    if(End>Cpt_Src->Entry_Num)
     {
         RME_COV_MARKER();
         
-        /* This must be successful */
-        RME_ASSERT(_RME_Kot_Erase(Vaddr, Table_Size)==0);
-
-        /* Unsuccessful - revert operations */
-        RME_WRITE_RELEASE(&(Pgt_Crt->Head.Type_Stat),0U);
-        return RME_ERR_PGT_HW;
+        End=Cpt_Src->Entry_Num;
     }
     else
     {
         RME_COV_MARKER();
         /* No action required */
     }
-
-    /* Establish cap */
-    RME_WRITE_RELEASE(&(Pgt_Crt->Head.Type_Stat),
-                      RME_CAP_TYPE_STAT(RME_CAP_TYPE_PGT,
-                                        RME_CAP_STAT_VALID,
-                                        RME_CAP_ATTR_ROOT));
-
-    return 0;
-}
-#endif
-/* End Function:_RME_Pgt_Boot_Crt ********************************************/
-
-/* Function:_RME_Pgt_Boot_Add *************************************************
-Description : This function is exclusively used to set up the Init process's
-              memory mappings in the booting process. When the system has
-              booted, it won't possible to fabricate pages like this.
-              Additionally, this function will set the cap to page table's 
-              property as unremovable. This means that it is not allowed to
-              remove any pages in the directory. It will set the reference
-              count of the capability as 1, thus making the capability to the
-              initial page table undeletable.
-Input       : struct RME_Cap_Cpt* Cpt - The master capability table.
-              rme_cid_t Cap_Pgt - The capability to the page table.
-                                  2-Level.
-              rme_ptr_t Paddr - The physical address to map from.
-              rme_ptr_t Pos - The page table position to map to.
-              rme_ptr_t Flag - The flags for the user page.
-Output      : None.
-Return      : rme_ret_t - If successful, 0; or an error code.
-******************************************************************************/
-#if(RME_PGT_RAW_ENABLE==0U)
-rme_ret_t _RME_Pgt_Boot_Add(struct RME_Cap_Cpt* Cpt,
-                            rme_cid_t Cap_Pgt, 
-                            rme_ptr_t Paddr,
-                            rme_ptr_t Pos,
-                            rme_ptr_t Flag)
-{
-    struct RME_Cap_Pgt* Pgt_Op;
-    rme_ptr_t Type_Stat;
-    rme_ptr_t Szord;
     
-    /* Get the capability slot */
-    RME_CPT_GETCAP(Cpt,Cap_Pgt,RME_CAP_TYPE_PGT,
-                   struct RME_Cap_Pgt*,Pgt_Op,Type_Stat);    
-    /* Check if the target captbl is not frozen, but don't check their properties */
-    RME_CAP_CHECK(Pgt_Op,0U);
-
-    Szord=RME_PGT_SZORD(Pgt_Op->Order);
-#if(RME_PGT_PHYS_ENABLE!=0U)
-    /* Check if we force identical mapping */
-    if(Szord==RME_WORD_BIT)
+    for(Count=Begin;Count<End;Count++)
     {
-        RME_COV_MARKER();
+        Capobj_Src=&(RME_CAP_GETOBJ(Cpt_Src,struct RME_Cap_Struct*)[Count]);
+        Capobj_Dst=&(RME_CAP_GETOBJ(Cpt_Dst,struct RME_Cap_Struct*)[Count]);
         
-        if(RME_UNLIKELY((Paddr!=0U)||(Pos!=0U)))
+        /* Atomic read - Read barrier to avoid premature checking of the rest */
+        Type_Stat=RME_READ_ACQUIRE(&(Capobj_Src->Head.Type_Stat));
+        /* Nothing to move here */
+        if(Type_Stat==0U)
         {
             RME_COV_MARKER();
             
-            return RME_ERR_PGT_ADDR;
+            continue;
         }
         else
         {
             RME_COV_MARKER();
             /* No action required */
         }
-    }
-    else if(RME_UNLIKELY(Paddr!=(RME_PGT_BASE(Pgt_Op->Base)+(Pos<<Szord))))
-    {
-        RME_COV_MARKER();
         
-        return RME_ERR_PGT_ADDR;
-    }
-    else
-    {
-        RME_COV_MARKER();
-        /* No action required */
-    }
-#endif
+        Src_Type=RME_CAP_TYPE(Type_Stat);
+        Src_Attr=RME_CAP_ATTR(Type_Stat);
+        Self=((Src_Type==RME_CAP_TYPE_CPT)&&
+              (Capobj_Src->Head.Object==Cpt_Src->Head.Object))?1U:0U;
+        
+        /* The slot must be frozen and quiescent, as for a removal. A root
+         * can't move while its leaves point at this slot, and the source
+         * table's own root can never leave it; frozen caps can't be
+         * delegated, so the refcnt check is stable */
+        if(RME_UNLIKELY(RME_CAP_STAT(Type_Stat)!=RME_CAP_STAT_FROZEN))
+        {
+            RME_COV_MARKER();
+            
+            Mov_Stat=(rme_ptr_t)RME_ERR_CPT_FROZEN;
+        }
+        else if(RME_UNLIKELY(RME_CAP_QUIE(Capobj_Src->Head.Timestamp)==0U))
+        {
+            RME_COV_MARKER();
+            
+            Mov_Stat=(rme_ptr_t)RME_ERR_CPT_QUIE;
+        }
+        else if((Src_Attr==RME_CAP_ATTR_ROOT)&&((Capobj_Src->Head.Root_Ref!=0U)||(Self!=0U)))
+        {
+            RME_COV_MARKER();
+            
+            Mov_Stat=(rme_ptr_t)RME_ERR_CPT_REFCNT;
+        }
+        else
+        {
+            RME_COV_MARKER();
+            
+            Mov_Stat=0U;
+        }
+        
+        if(Mov_Stat!=0U)
+        {
+            RME_COV_MARKER();
+            
+            if(Count==Begin)
+            {
+                RME_COV_MARKER();
+                
+                return (rme_ret_t)Mov_Stat;
+            }
+            else
+            {
+                RME_COV_MARKER();
+                
+                return (rme_ret_t)Count;
+            }
+        }
+        else
+        {
+            RME_COV_MARKER();
+            /* No action required */
+        }
+        
+        /* Own the source slot by marking it as creating, so that a racing
+         * removal or deletion of the frozen slot fails instead of helping.
+         * The type is cleared as for a creation, so that no lookup can take
+         * the slot for a usable cap while it is not frozen */
+        Mov_Stat=RME_CAP_TYPE_STAT(RME_CAP_TYPE_NOP,RME_CAP_STAT_CREATING,Src_Attr);
+        if(RME_COMP_SWAP(&(Capobj_Src->Head.Type_Stat),Type_Stat,Mov_Stat)==RME_CASFAIL)
+        {
+            RME_COV_MARKER();
+            
+            continue;
+        }
+        else
+        {
+            RME_COV_MARKER();
+            /* No action required */
+        }
+        
+        /* Try to take the destination slot - skip it if occupied */
+        if(RME_COMP_SWAP(&(Capobj_Dst->Head.Type_Stat),0U,
+                         RME_CAP_TYPE_STAT(RME_CAP_TYPE_NOP,
+                                           RME_CAP_STAT_CREATING,
+                                           RME_CAP_ATTR_ROOT))==RME_CASFAIL)
+        {
+            RME_COV_MARKER();
+            
+            /* Give the slot back as it was; it stays frozen */
+            RME_WRITE_RELEASE(&(Capobj_Src->Head.Type_Stat),Type_Stat);
+            continue;
+        }
+        else
+        {
+            RME_COV_MARKER();
+            /* No action required */
+        }
+        Capobj_Dst->Head.Timestamp=RME_TIMESTAMP;
+        
+        Flag=Capobj_Src->Head.Flag;
+        if(Self!=0U)
+        {
+            RME_COV_MARKER();
+            
+            /* Redirect to the new table: register the destination table's root
+             * and increase its refcnt */
+            Capobj_Root=RME_CAP_CONV_ROOT(Cpt_Dst,struct RME_Cap_Struct*);
+            RME_CAP_COPY(Capobj_Dst,Capobj_Root,Flag&(Cpt_Dst->Head.Flag));
+            Capobj_Dst->Head.Root_Ref=(rme_ptr_t)Capobj_Root;
+            RME_FETCH_ADD(&(Capobj_Root->Head.Root_Ref),1);
+#if(RME_CPT_DRV_ENABLE!=0U)
+            _RME_List_Del(Capobj_Src->Head.Drv.Prev,Capobj_Src->Head.Drv.Next);
+            _RME_List_Ins(&(Capobj_Dst->Head.Drv),
+                          &(Capobj_Root->Head.Drv),
+                          Capobj_Root->Head.Drv.Next);
+#endif
+            /* The old slot's reference on the source table goes with it */
+            Capobj_Root=(struct RME_Cap_Struct*)(Capobj_Src->Head.Root_Ref);
+            RME_FETCH_ADD(&(Capobj_Root->Head.Root_Ref),-1);
+            Src_Attr=RME_CAP_ATTR_LEAF;
+        }
+        else
+        {
+            RME_COV_MARKER();
+            
+            /* Move the cap as is. A leaf carries its reference over, and a
+             * root has no leaves, so no refcnt changes hands. KOM and KFN have
+             * no root at all; see _RME_Cpt_Add for details */
+            RME_CAP_COPY(Capobj_Dst,Capobj_Src,Flag);
+            Capobj_Dst->Head.Root_Ref=Capobj_Src->Head.Root_Ref;
+#if(RME_CPT_DRV_ENABLE!=0U)
+            if(Src_Attr==RME_CAP_ATTR_ROOT)
+            {
+                RME_COV_MARKER();
+                
+                RME_CAP_DRV_INIT(Capobj_Dst);
+            }
+            else if(Capobj_Dst->Head.Root_Ref!=0U)
+            {
+                RME_COV_MARKER();
+                
+                /* Take the old slot's place in the root's derivation list */
+                Capobj_Root=(struct RME_Cap_Struct*)(Capobj_Dst->Head.Root_Ref);
+                _RME_List_Del(Capobj_Src->Head.Drv.Prev,Capobj_Src->Head.Drv.Next);
+                _RME_List_Ins(&(Capobj_Dst->Head.Drv),
+                              &(Capobj_Root->Head.Drv),
+                              Capobj_Root->Head.Drv.Next);
+            }
+            else
+            {
+                RME_COV_MARKER();
+                /* No action required */
+            }
+#endif
+        }
+        
+        /* Establish the new cap, then empty the old slot */
+        RME_WRITE_RELEASE(&(Capobj_Dst->Head.Type_Stat),
+                          RME_CAP_TYPE_STAT(Src_Type,
+                                            RME_CAP_STAT_VALID,
+                                            Src_Attr));
+        RME_WRITE_RELEASE(&(Capobj_Src->Head.Type_Stat),0U);
+        
+#if(RME_CPT_CACHE_NUM!=0U)
+        /* Captbl moved - invalidate all cached 2-level lookups on all CPUs */
+        if(Src_Type==RME_CAP_TYPE_CPT)
+        {
+            RME_COV_MARKER();
+            
+            RME_FETCH_ADD(&RME_Cpt_Cache_Gen,1);
+        }
+        else
+        {
+            RME_COV_MARKER();
+            /* No action required */
+        }
+#endif
+    }
+    
+    return (rme_ret_t)End;
+}
+/* End Function:_RME_Cpt_Mig *************************************************/
+
+/* Function:_RME_Cpt_Rvk ******************************************************
+Description : Revoke capabilities derived from a root capability, wherever they
+              are. The leaves are found through the root's derivation list, and
+              are removed regardless of whether they are frozen. At most 
+              RME_CPT_RVK_MAX leaves are removed per call to keep the operation
+              bounded; the user calls this repeatedly until it returns 0. When
+              all leaves are revoked, the root's Root_Ref only counts kernel
+              objects that reference it. Kernel memory and kernel function
+              capabilities do not track their derivations and cannot be revoked.
+              This is only available on single-core systems, where the kernel
+              entries are serialized and the quiescence time is zero.
+Input       : struct RME_Cap_Cpt* Cpt - The master capability table.
+              rme_cid_t Cap_Cpt_Rvk - The capability to the capability table
+                                      containing the root capability.
+                                      2-Level.
+              rme_cid_t Cap_Rvk - The root capability to revoke derivations of.
+                                  1-Level.
+              rme_ptr_t Num - The number of leaves to revoke.
+Output      : None.
+Return      : rme_ret_t - If successful, the number of leaves revoked; or an
+                          error code.
+******************************************************************************/
+#if(RME_CPT_DRV_ENABLE!=0U)
+static rme_ret_t _RME_Cpt_Rvk(struct RME_Cap_Cpt* Cpt,
+                              rme_cid_t Cap_Cpt_Rvk,
+                              rme_cid_t Cap_Rvk,
+                              rme_ptr_t Num)
+{
+    struct RME_Cap_Cpt* Cpt_Op;
+    struct RME_Cap_Struct* Capobj_Rvk;
+    struct RME_Cap_Struct* Capobj_Leaf;
+    rme_ptr_t Type_Stat;
+    rme_ptr_t Rvk_Type;
+    rme_ptr_t Count;
+    
+    /* Get the capability slot */
+    RME_CPT_GETCAP(Cpt,Cap_Cpt_Rvk,RME_CAP_TYPE_CPT,
+                   struct RME_Cap_Cpt*,Cpt_Op,Type_Stat);    
+    /* Check if the target captbl is not frozen and allows such operations */
+    RME_CAP_CHECK(Cpt_Op,RME_CPT_FLAG_REM);
+    
+    /* Get the cap slot */
+    RME_CPT_GETSLOT(Cpt_Op,Cap_Rvk,struct RME_Cap_Struct*,Capobj_Rvk);
+    
+    /* Atomic read - Read barrier to avoid premature checking of the rest */
+    Type_Stat=RME_READ_ACQUIRE(&(Capobj_Rvk->Head.Type_Stat));
+    /* Does the cap exist at all? */
+    if(RME_UNLIKELY(Type_Stat==0U))
+    {
+        RME_COV_MARKER();
+        
+        return RME_ERR_CPT_NULL;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+    
+    /* Is the cap frozen? */
+    if(RME_UNLIKELY(RME_CAP_STAT(Type_Stat)==RME_CAP_STAT_FROZEN))
+    {
+        RME_COV_MARKER();
+        
+        return RME_ERR_CPT_FROZEN;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+    
+    /* Only roots that track their derivations can be revoked */
+    Rvk_Type=RME_CAP_TYPE(Type_Stat);
+    if(RME_UNLIKELY((RME_CAP_ATTR(Type_Stat)!=RME_CAP_ATTR_ROOT)||
+                    (Rvk_Type==RME_CAP_TYPE_KOM)||(Rvk_Type==RME_CAP_TYPE_KFN)))
+    {
+        RME_COV_MARKER();
+        
+        return RME_ERR_CPT_TYPE;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+    
+    /* Bound the batch so the operation stays preemptible between calls */
+    if(Num>RME_CPT_RVK_MAX)
+    {
+        RME_COV_MARKER();
+        
+        Num=RME_CPT_RVK_MAX;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+    
+    for(Count=0U;Count<Num;Count++)
+    {
+        /* Is there any leaf left? */
+        if(Capobj_Rvk->Head.Drv.Next==&(Capobj_Rvk->Head.Drv))
+        {
+            RME_COV_MARKER();
+            
+            break;
+        }
+        else
+        {
+            RME_COV_MARKER();
+            /* No action required */
+        }
+        
+        /* Unlink the first leaf and remove it */
+        Capobj_Leaf=RME_CAP_DRV2CAP(Capobj_Rvk->Head.Drv.Next);
+        RME_ASSERT(Capobj_Leaf->Head.Root_Ref==(rme_ptr_t)Capobj_Rvk);
+        _RME_List_Del(Capobj_Leaf->Head.Drv.Prev,Capobj_Leaf->Head.Drv.Next);
+        RME_WRITE_RELEASE(&(Capobj_Leaf->Head.Type_Stat),0U);
+        
+        /* Decrease the root's refcnt */
+        RME_FETCH_ADD(&(Capobj_Rvk->Head.Root_Ref),-1);
+    }
+    
+#if(RME_CPT_CACHE_NUM!=0U)
+    /* Captbls revoked without freezing - invalidate all cached 2-level lookups */
+    if(Rvk_Type==RME_CAP_TYPE_CPT)
+    {
+        RME_COV_MARKER();
+        
+        RME_FETCH_ADD(&RME_Cpt_Cache_Gen,1);
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+#endif
+
+    return (rme_ret_t)Count;
+}
+#endif
+/* End Function:_RME_Cpt_Rvk *************************************************/
+
+/* Function:_RME_Pgt_Boot_Crt *************************************************
+Description : Create a boot-time page table.
+              This function does not require a kernel memory capability.
+Input       : struct RME_Cap_Cpt* Cpt - The master capability table.
+              rme_cid_t Cap_Cpt - The capability table that contains the newly
+                                  created cap to pgtbl.
+                                  2-Level.
+              rme_cid_t Cap_Pgt - The capability slot that you want this newly
+                                  created page table capability to be in.
+                                  1-Level.
+              rme_ptr_t Vaddr - The virtual address to store the page table.
+              rme_ptr_t Base - The virtual address to start mapping for this
+                               page table. This address must be aligned to the
+                               total size of the table.
+              rme_ptr_t Is_Top - Whether this page table is the top-level. If
+                                 it is, we will map all the kernel page
+                                 directories into it.
+              rme_ptr_t Size_Order - The size order of the page table. The size
+                                     refers to the size of each page in the
+                                     page directory.
+              rme_ptr_t Num_Order - The number order of entries in the page
+                                    table.
+Output      : None.
+Return      : rme_ret_t - If successful, 0; or an error code.
+******************************************************************************/
+#if(RME_PGT_RAW_ENABLE==0U)
+rme_ret_t _RME_Pgt_Boot_Crt(struct RME_Cap_Cpt* Cpt,
+                            rme_cid_t Cap_Cpt,
+                            rme_cid_t Cap_Pgt,
+                            rme_ptr_t Vaddr,
+                            rme_ptr_t Base,
+                            rme_ptr_t Is_Top,
+                            rme_ptr_t Size_Order,
+                            rme_ptr_t Num_Order)
+{
+    struct RME_Cap_Cpt* Cpt_Op;
+    struct RME_Cap_Pgt* Pgt_Crt;
+    rme_ptr_t Type_Stat;
+    rme_ptr_t Table_Size;
+    
+    /* Check if the total representable memory exceeds our maximum possible
+     * addressible memory under the machine word length */
+    if(RME_UNLIKELY((Size_Order+Num_Order)>RME_POW2(RME_WORD_ORDER)))
+    {
+        RME_COV_MARKER();
+        
+        return RME_ERR_PGT_HW;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+
+    /* Get the cap location that we care about */
+    RME_CPT_GETCAP(Cpt,Cap_Cpt,RME_CAP_TYPE_CPT,
+                   struct RME_Cap_Cpt*,Cpt_Op,Type_Stat);
+    /* Check if the target captbl is not frozen and allows such operations */
+    RME_CAP_CHECK(Cpt_Op,RME_CPT_FLAG_CRT);
+    
+    /* Check if these parameters are feasible */
+    if(RME_UNLIKELY(__RME_Pgt_Check(Base,Is_Top,Size_Order,Num_Order,Vaddr)!=0))
+    {
+        RME_COV_MARKER();
+        
+        return RME_ERR_PGT_HW;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+    
+    /* Check if the base address is properly aligned to the total order of the page table */
+    if(RME_UNLIKELY((Base&RME_MASK_END(Size_Order+Num_Order-1U))!=0U))
+    {
+        RME_COV_MARKER();
+
+        return RME_ERR_PGT_HW;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+
+    /* Get the cap slot */
+    RME_CPT_GETSLOT(Cpt_Op,Cap_Pgt,struct RME_Cap_Pgt*,Pgt_Crt);
+    /* Take the slot if possible */
+    RME_CPT_OCCUPY(Pgt_Crt);
+
+    /* Are we creating the top level? */
+    if(Is_Top!=0U)
+    {
+        RME_COV_MARKER();
+        
+        Table_Size=RME_PGT_SIZE_TOP(Num_Order);
+    }
+    else
+    {
+        RME_COV_MARKER();
+        
+        Table_Size=RME_PGT_SIZE_NOM(Num_Order);
+    }
+    
+    /* Try to populate the area */
+    if(RME_UNLIKELY(_RME_Kot_Mark(Vaddr, Table_Size)!=0))
+    {
+        RME_COV_MARKER();
+    
+        RME_WRITE_RELEASE(&(Pgt_Crt->Head.Type_Stat),0U);
+        return RME_ERR_CPT_KOT;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+    
+    /* Header init */
+    Pgt_Crt->Head.Root_Ref=0U;
+    Pgt_Crt->Head.Object=Vaddr;
+    /* Set the property of the page table to only act as source and creating process */
+    Pgt_Crt->Head.Flag=RME_PGT_FLAG_FULL_RANGE|RME_PGT_FLAG_ADD_SRC|
+                       RME_PGT_FLAG_PRC_CRT|RME_PGT_FLAG_PRC_PGT;
+    
+    /* Info init */
+    Pgt_Crt->Base=Base|Is_Top;
+    Pgt_Crt->Order=RME_PGT_ORDER(Size_Order,Num_Order);
+    Pgt_Crt->ASID=0U;
+
+    /* Object init - need to add all kernel pages if they are top-level */
+    if(RME_UNLIKELY(__RME_Pgt_Init(Pgt_Crt)<0))
+    {
+        RME_COV_MARKER();
+        
+        /* This must be successful */
+        RME_ASSERT(_RME_Kot_Erase(Vaddr, Table_Size)==0);
+
+        /* Unsuccessful - revert operations */
+        RME_WRITE_RELEASE(&(Pgt_Crt->Head.Type_Stat),0U);
+        return RME_ERR_PGT_HW;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+
+    /* Establish cap */
+    RME_WRITE_RELEASE(&(Pgt_Crt->Head.Type_Stat),
+                      RME_CAP_TYPE_STAT(RME_CAP_TYPE_PGT,
+                                        RME_CAP_STAT_VALID,
+                                        RME_CAP_ATTR_ROOT));
+
+    return 0;
+}
+#endif
+/* End Function:_RME_Pgt_Boot_Crt ********************************************/
+
+/* Function:_RME_Pgt_Boot_Add *************************************************
+Description : This function is exclusively used to set up the Init process's
+              memory mappings in the booting process. When the system has
+              booted, it won't possible to fabricate pages like this.
+              Additionally, this function will set the cap to page table's 
+              property as unremovable. This means that it is not allowed to
+              remove any pages in the directory. It will set the reference
+              count of the capability as 1, thus making the capability to the
+              initial page table undeletable.
+Input       : struct RME_Cap_Cpt* Cpt - The master capability table.
+              rme_cid_t Cap_Pgt - The capability to the page table.
+                                  2-Level.
+              rme_ptr_t Paddr - The physical address to map from.
+              rme_ptr_t Pos - The page table position to map to.
+              rme_ptr_t Flag - The flags for the user page.
+Output      : None.
+Return      : rme_ret_t - If successful, 0; or an error code.
+******************************************************************************/
+#if(RME_PGT_RAW_ENABLE==0U)
+rme_ret_t _RME_Pgt_Boot_Add(struct RME_Cap_Cpt* Cpt,
+                            rme_cid_t Cap_Pgt, 
+                            rme_ptr_t Paddr,
+                            rme_ptr_t Pos,
+                            rme_ptr_t Flag)
+{
+    struct RME_Cap_Pgt* Pgt_Op;
+    rme_ptr_t Type_Stat;
+    rme_ptr_t Szord;
+    
+    /* Get the capability slot */
+    RME_CPT_GETCAP(Cpt,Cap_Pgt,RME_CAP_TYPE_PGT,
+                   struct RME_Cap_Pgt*,Pgt_Op,Type_Stat);    
+    /* Check if the target captbl is not frozen, but don't check their properties */
+    RME_CAP_CHECK(Pgt_Op,0U);
+
+    Szord=RME_PGT_SZORD(Pgt_Op->Order);
+#if(RME_PGT_PHYS_ENABLE!=0U)
+    /* Check if we force identical mapping */
+    if(Szord==RME_WORD_BIT)
+    {
+        RME_COV_MARKER();
+        
+        if(RME_UNLIKELY((Paddr!=0U)||(Pos!=0U)))
+        {
+            RME_COV_MARKER();
+            
+            return RME_ERR_PGT_ADDR;
+        }
+        else
+        {
+            RME_COV_MARKER();
+            /* No action required */
+        }
+    }
+    else if(RME_UNLIKELY(Paddr!=(RME_PGT_BASE(Pgt_Op->Base)+(Pos<<Szord))))
+    {
+        RME_COV_MARKER();
+        
+        return RME_ERR_PGT_ADDR;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+#endif
 
     /* See if the mapping range and the granularity is allowed */
     if(RME_UNLIKELY(((Pos>>RME_PGT_NMORD(Pgt_Op->Order))!=0U)||
@@ -3315,59 +3870,35 @@ static rme_ret_t _RME_Pgt_Del(struct RME_Cap_Cpt* Cpt,
 #endif
 /* End Function:_RME_Pgt_Del *************************************************/
 
-/* Function:_RME_Pgt_Add ******************************************************
-Description : Delegate a page from one page table to another. This is the only
-              way to add pages to new page tables after the system boots.
-Input       : struct RME_Cap_Cpt* Cpt - The master capability table.
-              rme_cid_t Cap_Pgt_Dst - The capability to the destination page
-                                      directory.
-                                      2-Level.
+/* Function:_RME_Pgt_Add_Entry ************************************************
+Description : Delegate a page from one page table to another, after both page
+              table capabilities have been looked up and checked.
+Input       : struct RME_Cap_Pgt* Pgt_Dst - The destination page directory.
               rme_ptr_t Pos_Dst - The position to delegate to in the
                                   destination page directory.
               rme_ptr_t Flag_Dst - The page access permission for the
                                    destination page.
-              rme_cid_t Cap_Pgt_Src - The capability to the source page 
-                                      directory.
-                                      2-Level.
-              rme_ptr_t Pos_Dst - The position to delegate from in the source
+              struct RME_Cap_Pgt* Pgt_Src - The source page directory.
+              rme_ptr_t Pos_Src - The position to delegate from in the source
                                   page directory.
               rme_ptr_t Index - The index of the physical address frame to
-                                delegate. For example, if the destination
-                                directory's page size is 1/4 of that of the
-                                source directory, index=0 will delegate the
-                                first 1/4, index=1 will delegate the second
-                                1/4, index=2 will delegate the third 1/4, and
-                                index=3 will delegate the last 1/4.
-                                All other index values are illegal.
+                                delegate. See _RME_Pgt_Add for details.
 Output      : None.
 Return      : rme_ret_t - If successful, 0; or an error code.
 ******************************************************************************/
 #if(RME_PGT_RAW_ENABLE==0U)
-static rme_ret_t _RME_Pgt_Add(struct RME_Cap_Cpt* Cpt, 
-                              rme_cid_t Cap_Pgt_Dst,
-                              rme_ptr_t Pos_Dst,
-                              rme_ptr_t Flag_Dst,
-                              rme_cid_t Cap_Pgt_Src,
-                              rme_ptr_t Pos_Src,
-                              rme_ptr_t Index)
+static rme_ret_t _RME_Pgt_Add_Entry(struct RME_Cap_Pgt* Pgt_Dst,
+                                    rme_ptr_t Pos_Dst,
+                                    rme_ptr_t Flag_Dst,
+                                    struct RME_Cap_Pgt* Pgt_Src,
+                                    rme_ptr_t Pos_Src,
+                                    rme_ptr_t Index)
 {
-    struct RME_Cap_Pgt* Pgt_Src;
-    struct RME_Cap_Pgt* Pgt_Dst;
     rme_ptr_t Paddr_Dst;
     rme_ptr_t Paddr_Src;
     rme_ptr_t Flag_Src;
-    rme_ptr_t Type_Stat;
     rme_ptr_t Szord_Src;
     rme_ptr_t Szord_Dst;
-
-    /* Get the capability slots */
-    RME_CPT_GETCAP(Cpt,Cap_Pgt_Dst,RME_CAP_TYPE_PGT,
-                   struct RME_Cap_Pgt*,Pgt_Dst,Type_Stat);
-    RME_CPT_GETCAP(Cpt,Cap_Pgt_Src,RME_CAP_TYPE_PGT,
-                   struct RME_Cap_Pgt*,Pgt_Src,Type_Stat);
-    /* Check if both page table caps are not frozen and allows such operations */
-    RME_CAP_CHECK(Pgt_Dst,RME_PGT_FLAG_ADD_DST);
-    RME_CAP_CHECK(Pgt_Src,RME_PGT_FLAG_ADD_SRC);
     /* Check the operation range - This is page table specific */
     if(RME_UNLIKELY((Pos_Dst>RME_PGT_FLAG_HIGH(Pgt_Dst->Head.Flag))||
                     (Pos_Dst<RME_PGT_FLAG_LOW(Pgt_Dst->Head.Flag))||
@@ -3461,68 +3992,267 @@ static rme_ret_t _RME_Pgt_Add(struct RME_Cap_Cpt* Cpt,
         if(RME_UNLIKELY(Paddr_Dst!=(RME_PGT_BASE(Pgt_Dst->Base)+(Pos_Dst<<Szord_Dst))))
         {
             RME_COV_MARKER();
-
-            return RME_ERR_PGT_ADDR;
+
+            return RME_ERR_PGT_ADDR;
+        }
+        else
+        {
+            RME_COV_MARKER();
+            /* No action required */
+        }
+#endif
+    }
+    /* The destination is also full range */
+    else
+    {
+        RME_COV_MARKER();
+        
+        Paddr_Dst=Paddr_Src;
+#if(RME_PGT_PHYS_ENABLE!=0U)
+        if(RME_UNLIKELY(Paddr_Dst!=RME_PGT_BASE(Pgt_Dst->Base)))
+        {
+            RME_COV_MARKER();
+
+            return RME_ERR_PGT_ADDR;
+        }
+        else
+        {
+            RME_COV_MARKER();
+            /* No action required */
+        }
+#endif
+    }
+    
+    /* Analyze the flags - we do not allow expansion of access permissions */
+    if(RME_UNLIKELY(((Flag_Dst)&(~Flag_Src))!=0U))
+    {
+        RME_COV_MARKER();
+
+        return RME_ERR_PGT_PERM;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+
+    /* Actually do the mapping - This work is passed down to the HAL. 
+     * Under multi-core, HAL should use CAS to avoid a conflict. */
+    if(RME_UNLIKELY(__RME_Pgt_Page_Map(Pgt_Dst,Paddr_Dst,Pos_Dst,Flag_Dst)<0))
+    {
+        RME_COV_MARKER();
+
+        return RME_ERR_PGT_MAP;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+
+    return 0;
+}
+#endif
+/* End Function:_RME_Pgt_Add_Entry *******************************************/
+
+/* Function:_RME_Pgt_Add ******************************************************
+Description : Delegate a page from one page table to another. This is the only
+              way to add pages to new page tables after the system boots.
+Input       : struct RME_Cap_Cpt* Cpt - The master capability table.
+              rme_cid_t Cap_Pgt_Dst - The capability to the destination page
+                                      directory.
+                                      2-Level.
+              rme_ptr_t Pos_Dst - The position to delegate to in the
+                                  destination page directory.
+              rme_ptr_t Flag_Dst - The page access permission for the
+                                   destination page.
+              rme_cid_t Cap_Pgt_Src - The capability to the source page 
+                                      directory.
+                                      2-Level.
+              rme_ptr_t Pos_Dst - The position to delegate from in the source
+                                  page directory.
+              rme_ptr_t Index - The index of the physical address frame to
+                                delegate. For example, if the destination
+                                directory's page size is 1/4 of that of the
+                                source directory, index=0 will delegate the
+                                first 1/4, index=1 will delegate the second
+                                1/4, index=2 will delegate the third 1/4, and
+                                index=3 will delegate the last 1/4.
+                                All other index values are illegal.
+Output      : None.
+Return      : rme_ret_t - If successful, 0; or an error code.
+******************************************************************************/
+#if(RME_PGT_RAW_ENABLE==0U)
+static rme_ret_t _RME_Pgt_Add(struct RME_Cap_Cpt* Cpt, 
+                              rme_cid_t Cap_Pgt_Dst,
+                              rme_ptr_t Pos_Dst,
+                              rme_ptr_t Flag_Dst,
+                              rme_cid_t Cap_Pgt_Src,
+                              rme_ptr_t Pos_Src,
+                              rme_ptr_t Index)
+{
+    struct RME_Cap_Pgt* Pgt_Src;
+    struct RME_Cap_Pgt* Pgt_Dst;
+    rme_ptr_t Type_Stat;
+
+    /* Get the capability slots */
+    RME_CPT_GETCAP(Cpt,Cap_Pgt_Dst,RME_CAP_TYPE_PGT,
+                   struct RME_Cap_Pgt*,Pgt_Dst,Type_Stat);
+    RME_CPT_GETCAP(Cpt,Cap_Pgt_Src,RME_CAP_TYPE_PGT,
+                   struct RME_Cap_Pgt*,Pgt_Src,Type_Stat);
+    /* Check if both page table caps are not frozen and allows such operations */
+    RME_CAP_CHECK(Pgt_Dst,RME_PGT_FLAG_ADD_DST);
+    RME_CAP_CHECK(Pgt_Src,RME_PGT_FLAG_ADD_SRC);
+    
+    return _RME_Pgt_Add_Entry(Pgt_Dst,Pos_Dst,Flag_Dst,Pgt_Src,Pos_Src,Index);
+}
+#endif
+/* End Function:_RME_Pgt_Add *************************************************/
+
+/* Function:_RME_Pgt_Add_Rng **************************************************
+Description : Delegate a run of consecutive pages from one page table to
+              another in a single call. The destination positions start from
+              Pos_Dst, and the source frames follow each other starting from
+              frame Index of position Pos_Src, carrying over to the next source
+              position when a source page is used up. Both capabilities are
+              looked up only once, and the HAL is allowed to defer its hardware
+              metadata update (e.g. MPU) to the end of the batch. The operation
+              stops at the first entry that fails.
+Input       : struct RME_Cap_Cpt* Cpt - The master capability table.
+              rme_cid_t Cap_Pgt_Dst - The capability to the destination page
+                                      directory.
+                                      2-Level.
+              rme_ptr_t Pos_Dst - The first position to delegate to in the
+                                  destination page directory.
+              rme_ptr_t Flag_Dst - The page access permission for the
+                                   destination pages.
+              rme_cid_t Cap_Pgt_Src - The capability to the source page 
+                                      directory.
+                                      2-Level.
+              rme_ptr_t Pos_Src - The first position to delegate from in the
+                                  source page directory.
+              rme_ptr_t Index - The first frame index in the source page.
+              rme_ptr_t Num - The number of pages to delegate. At most
+                              RME_PGT_ADD_MAX pages are done per call.
+Output      : None.
+Return      : rme_ret_t - If at least one page is mapped, the number of pages
+                          mapped; or the error code of the first entry.
+******************************************************************************/
+#if(RME_PGT_RAW_ENABLE==0U)
+static rme_ret_t _RME_Pgt_Add_Rng(struct RME_Cap_Cpt* Cpt, 
+                                  rme_cid_t Cap_Pgt_Dst,
+                                  rme_ptr_t Pos_Dst,
+                                  rme_ptr_t Flag_Dst,
+                                  rme_cid_t Cap_Pgt_Src,
+                                  rme_ptr_t Pos_Src,
+                                  rme_ptr_t Index,
+                                  rme_ptr_t Num)
+{
+    struct RME_Cap_Pgt* Pgt_Src;
+    struct RME_Cap_Pgt* Pgt_Dst;
+    rme_ptr_t Type_Stat;
+    rme_ptr_t Szord_Src;
+    rme_ptr_t Szord_Dst;
+    rme_ptr_t Count;
+    rme_ret_t Retval;
+
+    /* Get the capability slots */
+    RME_CPT_GETCAP(Cpt,Cap_Pgt_Dst,RME_CAP_TYPE_PGT,
+                   struct RME_Cap_Pgt*,Pgt_Dst,Type_Stat);
+    RME_CPT_GETCAP(Cpt,Cap_Pgt_Src,RME_CAP_TYPE_PGT,
+                   struct RME_Cap_Pgt*,Pgt_Src,Type_Stat);
+    /* Check if both page table caps are not frozen and allows such operations */
+    RME_CAP_CHECK(Pgt_Dst,RME_PGT_FLAG_ADD_DST);
+    RME_CAP_CHECK(Pgt_Src,RME_PGT_FLAG_ADD_SRC);
+    
+    /* Bound the amount of work done in a single call */
+    if(Num>RME_PGT_ADD_MAX)
+    {
+        RME_COV_MARKER();
+        
+        Num=RME_PGT_ADD_MAX;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+    
+    Szord_Dst=RME_PGT_SZORD(Pgt_Dst->Order);
+    Szord_Src=RME_PGT_SZORD(Pgt_Src->Order);
+    Retval=0;
+    
+    RME_PGT_BATCH_BEGIN(Pgt_Dst);
+    for(Count=0U;Count<Num;Count++)
+    {
+        /* Move on to the next source page if this one is used up - no UB
+         * because the entry check guarantees Szord_Dst<=Szord_Src */
+        if((Szord_Src<RME_WORD_BIT)&&(RME_POW2(Szord_Src)<=(Index<<Szord_Dst)))
+        {
+            RME_COV_MARKER();
+            
+            Pos_Src++;
+            Index=0U;
         }
         else
         {
             RME_COV_MARKER();
             /* No action required */
         }
-#endif
-    }
-    /* The destination is also full range */
-    else
-    {
-        RME_COV_MARKER();
         
-        Paddr_Dst=Paddr_Src;
-#if(RME_PGT_PHYS_ENABLE!=0U)
-        if(RME_UNLIKELY(Paddr_Dst!=RME_PGT_BASE(Pgt_Dst->Base)))
+        Retval=_RME_Pgt_Add_Entry(Pgt_Dst,Pos_Dst+Count,Flag_Dst,
+                                  Pgt_Src,Pos_Src,Index);
+        if(RME_UNLIKELY(Retval<0))
         {
             RME_COV_MARKER();
-
-            return RME_ERR_PGT_ADDR;
+            
+            break;
         }
         else
         {
             RME_COV_MARKER();
             /* No action required */
         }
-#endif
+        
+        Index++;
     }
     
-    /* Analyze the flags - we do not allow expansion of access permissions */
-    if(RME_UNLIKELY(((Flag_Dst)&(~Flag_Src))!=0U))
+    /* Commit the hardware metadata once; if that fails, nothing is mapped */
+    if(RME_UNLIKELY(RME_PGT_BATCH_END(Pgt_Dst)<0))
     {
         RME_COV_MARKER();
-
-        return RME_ERR_PGT_PERM;
+        
+        while(Count>0U)
+        {
+            Count--;
+            RME_ASSERT(__RME_Pgt_Page_Unmap(Pgt_Dst,Pos_Dst+Count)==0);
+        }
+        
+        return RME_ERR_PGT_MAP;
     }
     else
     {
         RME_COV_MARKER();
         /* No action required */
     }
-
-    /* Actually do the mapping - This work is passed down to the HAL. 
-     * Under multi-core, HAL should use CAS to avoid a conflict. */
-    if(RME_UNLIKELY(__RME_Pgt_Page_Map(Pgt_Dst,Paddr_Dst,Pos_Dst,Flag_Dst)<0))
+    
+    /* Nothing mapped at all, report why */
+    if(Count==0U)
     {
         RME_COV_MARKER();
-
-        return RME_ERR_PGT_MAP;
+        
+        return Retval;
     }
     else
     {
         RME_COV_MARKER();
         /* No action required */
     }
-
-    return 0;
+    
+    return (rme_ret_t)Count;
 }
 #endif
-/* End Function:_RME_Pgt_Add *************************************************/
+/* End Function:_RME_Pgt_Add_Rng *********************************************/
 
 /* Function:_RME_Pgt_Rem ******************************************************
 Description : Remove a page from the page table. We are doing unmapping of a
@@ -3860,6 +4590,142 @@ static rme_ret_t _RME_Pgt_Des(struct RME_Cap_Cpt* Cpt,
 #endif
 /* End Function:_RME_Pgt_Des *************************************************/
 
+/* Function:_RME_Pgt_Query ****************************************************
+Description : Query a range of positions in a page directory in one go. For
+              each position that holds a page, a (position, physical address,
+              RME standard flags) tuple is written to the buffer, in ascending
+              order of position; empty positions and child directories are
+              skipped. The buffer must be able to hold a tuple for each of the
+              positions queried, and must lie within a single writable page of
+              the caller's current page table. The tuples are written through
+              the kernel's own mapping of that page, so that another CPU
+              unmapping it in the meantime can neither make the kernel fault
+              nor redirect the writes.
+              This is a kernel function rather than a system call.
+Input       : struct RME_Cap_Cpt* Cpt - The master capability table.
+              rme_cid_t Cap_Pgt - The capability to the page directory.
+                                  2-Level.
+              rme_ptr_t Pos - The first position to query.
+              rme_ptr_t Num - The number of positions to query.
+              rme_ptr_t Buf - The user buffer to write the tuples to.
+Output      : None.
+Return      : rme_ret_t - If successful, the number of tuples; or an error
+                          code.
+******************************************************************************/
+#if(RME_PGT_RAW_ENABLE==0U)
+static rme_ret_t _RME_Pgt_Query(struct RME_Cap_Cpt* Cpt,
+                                rme_cid_t Cap_Pgt,
+                                rme_ptr_t Pos,
+                                rme_ptr_t Num,
+                                rme_ptr_t Buf)
+{
+    struct RME_Cap_Pgt* Pgt_Op;
+    struct RME_Cap_Pgt* Pgt_Cur;
+    rme_ptr_t* Tuple;
+    rme_ptr_t Map_Vaddr;
+    rme_ptr_t Map_Paddr;
+    rme_ptr_t Map_End;
+    rme_ptr_t Size_Order;
+    rme_ptr_t Flag;
+    rme_ptr_t Paddr;
+    rme_ptr_t Count;
+    rme_ptr_t Type_Stat;
+    
+    /* Get the capability slot */
+    RME_CPT_GETCAP(Cpt,Cap_Pgt,RME_CAP_TYPE_PGT,
+                   struct RME_Cap_Pgt*,Pgt_Op,Type_Stat);
+    /* Reading the pages out is what using the table as a source does */
+    RME_CAP_CHECK(Pgt_Op,RME_PGT_FLAG_ADD_SRC);
+    
+    /* Check the operation range - the sum won't overflow as both are bounded */
+    if(RME_UNLIKELY((Num==0U)||((Num>>RME_PGT_NMORD(Pgt_Op->Order))!=0U)||
+                    (Pos<RME_PGT_FLAG_LOW(Pgt_Op->Head.Flag))||
+                    (Pos>RME_PGT_FLAG_HIGH(Pgt_Op->Head.Flag))||
+                    ((Pos+Num-1U)>RME_PGT_FLAG_HIGH(Pgt_Op->Head.Flag))||
+                    (((Pos+Num-1U)>>RME_PGT_NMORD(Pgt_Op->Order))!=0U)))
+    {
+        RME_COV_MARKER();
+
+        return RME_ERR_PGT_ADDR;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+    
+    /* The buffer must be word-aligned and mapped writable by the caller */
+    Pgt_Cur=_RME_Thd_Pgt(RME_CPU_LOCAL()->Thd_Cur);
+    if(RME_UNLIKELY((RME_IS_ALIGNED(Buf)==0U)||
+                    (__RME_Pgt_Walk(Pgt_Cur,Buf,RME_NULL,&Map_Vaddr,&Map_Paddr,
+                                    &Size_Order,RME_NULL,&Flag)!=0)||
+                    ((Flag&RME_PGT_WRITE)==0U)))
+    {
+        RME_COV_MARKER();
+
+        return RME_ERR_PGT_PERM;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+    
+    /* The whole buffer must be in that page - avoid UB */
+    if(Size_Order<RME_WORD_BIT)
+    {
+        RME_COV_MARKER();
+        
+        Map_End=Map_Vaddr+RME_POW2(Size_Order)-1U;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        
+        Map_End=RME_MASK_FULL;
+    }
+    
+    /* The last byte written must not be past the end - Num is bounded by the
+     * directory size, so the product does not overflow */
+    if(RME_UNLIKELY(((Num*3U*RME_WORD_BYTE)-1U)>(Map_End-Buf)))
+    {
+        RME_COV_MARKER();
+
+        return RME_ERR_PGT_PERM;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+    
+    /* Fill in the tuples, through the kernel address of the page we checked */
+    Tuple=(rme_ptr_t*)RME_PGT_KADDR(Buf,Map_Paddr+(Buf-Map_Vaddr));
+    Count=0U;
+    for(Num+=Pos;Pos<Num;Pos++)
+    {
+        if(__RME_Pgt_Lookup(Pgt_Op,Pos,&Paddr,&Flag)==0)
+        {
+            RME_COV_MARKER();
+            
+            Tuple[0]=Pos;
+            Tuple[1]=Paddr;
+            Tuple[2]=Flag;
+            Tuple=&Tuple[3];
+            Count++;
+        }
+        else
+        {
+            RME_COV_MARKER();
+            /* No action required */
+        }
+    }
+    
+    return (rme_ret_t)Count;
+}
+#endif
+/* End Function:_RME_Pgt_Query ***********************************************/
+
 /* Function:_RME_Kot_Init *****************************************************
 Description : Initialize the kernel object table according to the total kernel
               memory size, which decides the number of words in the table.
@@ -3889,13 +4755,94 @@ rme_ret_t _RME_Kot_Init(rme_ptr_t Word)
     {
         RME_KOT_VA_BASE[Count]=0U;
     }
+    
+#if(RME_KOT_ZERO_NUM!=0U)
+    /* Nothing is known to be clean at boot */
+    for(Count=0U;Count<RME_KOT_WORD_NUM;Count++)
+    {
+        RME_Kot_Clean[Count]=0U;
+    }
+#endif
 
     return 0;
 }
 /* End Function:_RME_Kot_Init ************************************************/
 
+/* Function:_RME_Kot_Mark_Part ************************************************
+Description : Populate some bits in a kernel object bitmap word that may be
+              shared with other objects. A CAS failure here may be caused by
+              neighbors marking unrelated bits in the same word, so we retry
+              for a bounded number of times as long as our bits are still clear.
+Input       : struct RME_CPU_Local* Local - The CPU-local data structure.
+              rme_ptr_t Pos - The position of the word in the bitmap.
+              rme_ptr_t Mask - The bits to populate.
+Output      : None.
+Return      : rme_ret_t - If successful, 0; or an error code.
+******************************************************************************/
+static rme_ret_t _RME_Kot_Mark_Part(struct RME_CPU_Local* Local,
+                                    rme_ptr_t Pos,
+                                    rme_ptr_t Mask)
+{
+    rme_ptr_t Retry;
+    rme_ptr_t Old_Val;
+    
+    for(Retry=0U;;Retry++)
+    {
+        /* Someone already populated something here - this is a real conflict */
+        Old_Val=RME_KOT_VA_BASE[Pos];
+        if(RME_UNLIKELY((Old_Val&Mask)!=0U))
+        {
+            RME_COV_MARKER();
+            
+            return RME_ERR_KOT_BMP;
+        }
+        else
+        {
+            RME_COV_MARKER();
+            /* No action required */
+        }
+        
+        /* Check done, do the marking with CAS */
+        if(RME_LIKELY(RME_COMP_SWAP(&RME_KOT_VA_BASE[Pos],
+                                    Old_Val,
+                                    Old_Val|Mask)!=RME_CASFAIL))
+        {
+            RME_COV_MARKER();
+            
+            return 0;
+        }
+        else
+        {
+            RME_COV_MARKER();
+            /* No action required */
+        }
+        
+        /* Lost the race to a neighbor, see if we still have retries left */
+        if(RME_UNLIKELY(Retry>=RME_KOT_RETRY_MAX))
+        {
+            RME_COV_MARKER();
+            
+            return RME_ERR_KOT_BMP;
+        }
+        else
+        {
+            RME_COV_MARKER();
+            /* No action required */
+        }
+        
+        Local->Kot_Stat.Retry++;
+    }
+}
+/* End Function:_RME_Kot_Mark_Part *******************************************/
+
 /* Function:_RME_Kot_Mark *****************************************************
-Description : Populate the kernel object bitmap contiguously.
+Description : Populate the kernel object bitmap contiguously. The whole range
+              is validated with plain reads first, so that most conflicts fail
+              early without writing anything. Then the words that are fully
+              covered by the range are claimed with full-word CAS from zero,
+              which only fail upon real conflicts; the partial words at both
+              ends are claimed with bounded retries. Failures, retries and
+              rollbacks are counted in the CPU-local statistics.
 Input       : rme_ptr_t Kaddr - The kernel virtual address.
               rme_ptr_t Size - The size of the memory to populate.
 Output      : None.
@@ -3905,10 +4852,6 @@ rme_ret_t _RME_Kot_Mark(rme_ptr_t Kaddr,
                         rme_ptr_t Size)
 {
     rme_ptr_t Count;
-    /* The old value */
-    rme_ptr_t Old_Val;
-    /* Whether we need to undo our operations because of CAS failure */
-    rme_ptr_t Undo;
     /* The actual word to start the marking */
     rme_ptr_t Start;
     /* The actual word to end the marking */
@@ -3917,6 +4860,8 @@ rme_ret_t _RME_Kot_Mark(rme_ptr_t Kaddr,
     rme_ptr_t Mask_Begin;
     /* The mask at the end word */
     rme_ptr_t Mask_End;
+    /* The CPU-local statistics */
+    struct RME_CPU_Local* Local;
 
     /* Check if the marking is well aligned */
     if(RME_UNLIKELY((Kaddr&RME_MASK_END(RME_KOM_SLOT_ORDER-1U))!=0U))
@@ -3940,65 +4885,44 @@ rme_ret_t _RME_Kot_Mark(rme_ptr_t Kaddr,
     Mask_End=RME_MASK_END(End&RME_MASK_END(RME_WORD_ORDER-1U));
     End=End>>RME_WORD_ORDER;
     
-    /* See if the start and end are in the same word */
+    /* Both ends are in the same word */
     if(Start==End)
     {
         RME_COV_MARKER();
-
-        /* Someone already populated something here */
-        Old_Val=RME_KOT_VA_BASE[Start];
-        if(RME_UNLIKELY((Old_Val&(Mask_Begin&Mask_End))!=0U))
-        {
-            RME_COV_MARKER();
-
-            return RME_ERR_KOT_BMP;
-        }
-        else
-        {
-            RME_COV_MARKER();
-            /* No action required */
-        }
         
-        /* Check done, do the marking with CAS */
-        if(RME_UNLIKELY(RME_COMP_SWAP(&RME_KOT_VA_BASE[Start],
-                                      Old_Val,
-                                      Old_Val|(Mask_Begin&Mask_End))==RME_CASFAIL))
-        {
-            RME_COV_MARKER();
-
-            return RME_ERR_KOT_BMP;
-        }
-        else
-        {
-            RME_COV_MARKER();
-            /* No action required */
-        }
+        Mask_Begin&=Mask_End;
+        Mask_End=Mask_Begin;
     }
     else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+    
+    Local=RME_CPU_LOCAL();
+    
+    /* Validate the whole range read-only before writing anything */
+    if(RME_UNLIKELY(((RME_KOT_VA_BASE[Start]&Mask_Begin)!=0U)||
+                    ((RME_KOT_VA_BASE[End]&Mask_End)!=0U)))
     {
         RME_COV_MARKER();
         
-        Undo=0U;
-        /* Check&Mark the start */
-        Old_Val=RME_KOT_VA_BASE[Start];
-        if(RME_UNLIKELY((Old_Val&Mask_Begin)!=0U))
-        {
-            RME_COV_MARKER();
-
-            return RME_ERR_KOT_BMP;
-        }
-        else
-        {
-            RME_COV_MARKER();
-            /* No action required */
-        }
-        
-        if(RME_UNLIKELY(RME_COMP_SWAP(&RME_KOT_VA_BASE[Start],
-                                      Old_Val,
-                                      Old_Val|Mask_Begin)==RME_CASFAIL))
+        Local->Kot_Stat.Fail++;
+        return RME_ERR_KOT_BMP;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+    
+    for(Count=Start+1U;Count<End;Count++)
+    {
+        if(RME_UNLIKELY(RME_KOT_VA_BASE[Count]!=0U))
         {
             RME_COV_MARKER();
-
+            
+            Local->Kot_Stat.Fail++;
             return RME_ERR_KOT_BMP;
         }
         else
@@ -4006,90 +4930,63 @@ rme_ret_t _RME_Kot_Mark(rme_ptr_t Kaddr,
             RME_COV_MARKER();
             /* No action required */
         }
+    }
+    
+    /* Claim the start */
+    if(RME_UNLIKELY(_RME_Kot_Mark_Part(Local,Start,Mask_Begin)!=0))
+    {
+        RME_COV_MARKER();
         
-        /* Check&Mark the middle */
-        for(Count=Start+1U;Count<End;Count++)
-        {
-            Old_Val=RME_KOT_VA_BASE[Count];
-            if(RME_UNLIKELY(Old_Val!=0U))
-            {
-                RME_COV_MARKER();
-
-                Undo=1U;
-                break;
-            }
-            else
-            {
-                RME_COV_MARKER();
-                
-                if(RME_UNLIKELY(RME_COMP_SWAP(&RME_KOT_VA_BASE[Count],
-                                              Old_Val,
-                                              RME_MASK_FULL)==RME_CASFAIL))
-                {
-                    RME_COV_MARKER();
-                    
-                    Undo=1U;
-                    break;
-                }
-                else
-                {
-                    RME_COV_MARKER();
-                    /* No action required */
-                }
-            }
-        }
+        Local->Kot_Stat.Fail++;
+        return RME_ERR_KOT_BMP;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+    
+    /* Start and end in the same word, all done */
+    if(Start==End)
+    {
+        RME_COV_MARKER();
         
-        /* See if the middle part failed. If yes, we skip the end marking */
-        if(Undo==0U)
+        return 0;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+    
+    /* Claim the middle - these words are exclusively ours, so a failure is a real conflict */
+    for(Count=Start+1U;Count<End;Count++)
+    {
+        if(RME_UNLIKELY(RME_COMP_SWAP(&RME_KOT_VA_BASE[Count],
+                                      0U,
+                                      RME_MASK_FULL)==RME_CASFAIL))
         {
             RME_COV_MARKER();
-
-            /* Check&Mark the end */
-            Old_Val=RME_KOT_VA_BASE[End];
-            if(RME_UNLIKELY((Old_Val&Mask_End)!=0U))
-            {
-                RME_COV_MARKER();
-
-                Undo=1U;
-            }
-            else
-            {
-                RME_COV_MARKER();
-
-                if(RME_UNLIKELY(RME_COMP_SWAP(&RME_KOT_VA_BASE[End],
-                                              Old_Val,
-                                              Old_Val|Mask_End)==RME_CASFAIL))
-                {
-                    RME_COV_MARKER();
-
-                    Undo=1U;
-                }
-                else
-                {
-                    RME_COV_MARKER();
-                    /* No action required */
-                }
-            }
+            
+            break;
         }
         else
         {
             RME_COV_MARKER();
+            /* No action required */
         }
+    }
+    
+    /* Claim the end if the middle succeeded */
+    if(RME_LIKELY(Count==End))
+    {
+        RME_COV_MARKER();
         
-        /* See if we need to undo. If yes, proceed to unroll and return error */
-        if(RME_UNLIKELY(Undo!=0U))
+        if(RME_LIKELY(_RME_Kot_Mark_Part(Local,End,Mask_End)==0))
         {
             RME_COV_MARKER();
-
-            /* Undo the middle part - no CAS neeeded, write back is always atomic */
-            for(Count--;Count>Start;Count--)
-            {
-                RME_KOT_VA_BASE[Count]=0U;
-            }
-            /* Undo the first word - need atomic instructions */
-            RME_FETCH_AND(&(RME_KOT_VA_BASE[Start]),~Mask_Begin);
-            /* Return failure */
-            return RME_ERR_KOT_BMP;
+            
+            return 0;
         }
         else
         {
@@ -4097,8 +4994,23 @@ rme_ret_t _RME_Kot_Mark(rme_ptr_t Kaddr,
             /* No action required */
         }
     }
-
-    return 0;
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+    
+    /* Undo the middle part - no CAS neeeded, nobody else can write these words */
+    for(Count--;Count>Start;Count--)
+    {
+        RME_WRITE_RELEASE(&(RME_KOT_VA_BASE[Count]),0U);
+    }
+    /* Undo the first word - need atomic instructions */
+    RME_FETCH_AND(&(RME_KOT_VA_BASE[Start]),~Mask_Begin);
+    
+    Local->Kot_Stat.Fail++;
+    Local->Kot_Stat.Undo++;
+    return RME_ERR_KOT_BMP;
 }
 /* End Function:_RME_Kot_Mark ************************************************/
 
@@ -4113,6 +5025,9 @@ Return      : rme_ret_t - If successful, 0; or an error code.
 rme_ret_t _RME_Kot_Erase(rme_ptr_t Kaddr,
                          rme_ptr_t Size)
 {
+#if(RME_KOT_ZERO_NUM!=0U)
+    struct RME_CPU_Local* Local;
+#endif
     /* The actual word to start the marking */
     rme_ptr_t Start;
     /* The actual word to end the marking */
@@ -4136,6 +5051,13 @@ rme_ret_t _RME_Kot_Erase(rme_ptr_t Kaddr,
         /* No action required */
     }
     
+#if(RME_KOT_ZERO_NUM!=0U)
+    /* The memory is dirty from now on - this must happen before the range is
+     * released, lest a new creator see the stale bits from before this object.
+     * Doing this on a range that turns out not to be ours is harmless */
+    _RME_Kot_Bmp_Mod(RME_Kot_Clean,Kaddr,Size,0U);
+#endif
+    
     /* Get the starting position and the ending position of the marking */
     Start=(Kaddr-RME_KOM_VA_BASE)>>RME_KOM_SLOT_ORDER;
     Mask_Begin=RME_MASK_BEGIN(Start&RME_MASK_END(RME_WORD_ORDER-1U));
@@ -4184,7 +5106,7 @@ rme_ret_t _RME_Kot_Erase(rme_ptr_t Kaddr,
         }
         
         /* Check the middle */
-        for(Count=Start+1U;Count<End-1U;Count++)
+        for(Count=Start+1U;Count<End;Count++)
         {
             if(RME_UNLIKELY(RME_KOT_VA_BASE[Count]!=RME_MASK_FULL))
             {
@@ -4212,20 +5134,355 @@ rme_ret_t _RME_Kot_Erase(rme_ptr_t Kaddr,
             /* No action required */
         }
         
-        /* Erase the start - make it atomic */
-        RME_FETCH_AND(&(RME_KOT_VA_BASE[Start]),~Mask_Begin);
-        /* Erase the middle - do not need atomics here */
-        for(Count=Start+1U;Count<End-1U;Count++)
-        {
-            RME_KOT_VA_BASE[Count]=0U;
-        }
-        /* Erase the end - make it atomic */
-        RME_FETCH_AND(&(RME_KOT_VA_BASE[End]),~Mask_End);
+        /* Erase the start - make it atomic */
+        RME_FETCH_AND(&(RME_KOT_VA_BASE[Start]),~Mask_Begin);
+        /* Erase the middle - do not need atomics here */
+        for(Count=Start+1U;Count<End;Count++)
+        {
+            RME_KOT_VA_BASE[Count]=0U;
+        }
+        /* Erase the end - make it atomic */
+        RME_FETCH_AND(&(RME_KOT_VA_BASE[End]),~Mask_End);
+    }
+    
+#if(RME_KOT_ZERO_NUM!=0U)
+    /* Queue it up for zeroing only now that the release succeeded, if we still
+     * have room; otherwise it just stays dirty */
+    Local=RME_CPU_LOCAL();
+    if(RME_LIKELY(Local->Dirty_Num<RME_KOT_ZERO_NUM))
+    {
+        RME_COV_MARKER();
+        
+        Local->Dirty[Local->Dirty_Num].Addr=Kaddr;
+        Local->Dirty[Local->Dirty_Num].Size=RME_KOM_ROUND(Size);
+        Local->Dirty_Num++;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+#endif
+
+    return 0;
+}
+/* End Function:_RME_Kot_Erase ***********************************************/
+
+#if(RME_KOT_ZERO_NUM!=0U)
+/* Function:_RME_Kot_Bmp_Mod **************************************************
+Description : Set or clear the bits of a kernel memory range in a bitmap that
+              has the same layout as the kernel object table. The caller must
+              own the range in the kernel object table. Setting bits in words
+              shared with neighbors is attempted for a bounded number of times
+              only; giving up just leaves the bits clear, which is always safe.
+Input       : rme_ptr_t* Bmp - The bitmap.
+              rme_ptr_t Kaddr - The kernel virtual address.
+              rme_ptr_t Size - The size of the memory range.
+              rme_ptr_t Set - 1 to set the bits; 0 to clear them.
+Output      : None.
+Return      : None.
+******************************************************************************/
+static void _RME_Kot_Bmp_Mod(rme_ptr_t* Bmp,
+                             rme_ptr_t Kaddr,
+                             rme_ptr_t Size,
+                             rme_ptr_t Set)
+{
+    rme_ptr_t Start;
+    rme_ptr_t End;
+    rme_ptr_t Mask[2];
+    rme_ptr_t Pos[2];
+    rme_ptr_t Edge;
+    rme_ptr_t Count;
+    rme_ptr_t Retry;
+    rme_ptr_t Old_Val;
+    
+    /* Get the starting position and the ending position of the range */
+    Start=(Kaddr-RME_KOM_VA_BASE)>>RME_KOM_SLOT_ORDER;
+    Mask[0]=RME_MASK_BEGIN(Start&RME_MASK_END(RME_WORD_ORDER-1U));
+    Start=Start>>RME_WORD_ORDER;
+    
+    End=(Kaddr+Size-1U-RME_KOM_VA_BASE)>>RME_KOM_SLOT_ORDER;
+    Mask[1]=RME_MASK_END(End&RME_MASK_END(RME_WORD_ORDER-1U));
+    End=End>>RME_WORD_ORDER;
+    
+    Pos[0]=Start;
+    Pos[1]=End;
+    
+    /* Both edges are in the same word */
+    if(Start==End)
+    {
+        RME_COV_MARKER();
+        
+        Mask[0]&=Mask[1];
+        Edge=1U;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        
+        Edge=2U;
+        /* The middle words are exclusively ours */
+        for(Count=Start+1U;Count<End;Count++)
+        {
+            if(Set!=0U)
+            {
+                RME_COV_MARKER();
+                
+                RME_WRITE_RELEASE(&(Bmp[Count]),RME_MASK_FULL);
+            }
+            else
+            {
+                RME_COV_MARKER();
+                
+                RME_WRITE_RELEASE(&(Bmp[Count]),0U);
+            }
+        }
+    }
+    
+    /* The edge words may be shared with neighbors */
+    for(Count=0U;Count<Edge;Count++)
+    {
+        if(Set==0U)
+        {
+            RME_COV_MARKER();
+            
+            RME_FETCH_AND(&(Bmp[Pos[Count]]),~Mask[Count]);
+            continue;
+        }
+        else
+        {
+            RME_COV_MARKER();
+            /* No action required */
+        }
+        
+        for(Retry=0U;Retry<RME_KOT_RETRY_MAX;Retry++)
+        {
+            Old_Val=Bmp[Pos[Count]];
+            if(RME_LIKELY(RME_COMP_SWAP(&(Bmp[Pos[Count]]),
+                                        Old_Val,
+                                        Old_Val|Mask[Count])!=RME_CASFAIL))
+            {
+                RME_COV_MARKER();
+                
+                break;
+            }
+            else
+            {
+                RME_COV_MARKER();
+                /* No action required */
+            }
+        }
+    }
+}
+/* End Function:_RME_Kot_Bmp_Mod *********************************************/
+
+/* Function:_RME_Kot_Zero *****************************************************
+Description : Zero a chunk of the kernel memory released by deletions on this
+              CPU, and mark it as clean so that the next creation over it can
+              skip the clearing. The range is temporarily marked in the kernel
+              object table while it is being zeroed so no creation can race
+              with us; if it is already taken again, it is simply dropped.
+Input       : struct RME_CPU_Local* Local - The CPU-local data structure.
+Output      : None.
+Return      : rme_ptr_t - The number of ranges still waiting to be zeroed.
+******************************************************************************/
+static rme_ptr_t _RME_Kot_Zero(struct RME_CPU_Local* Local)
+{
+    struct RME_Kot_Dirty* Dirty;
+    rme_ptr_t Left;
+    rme_ptr_t Size;
+    
+    /* Each call is bounded by the chunk size */
+    Left=RME_KOT_ZERO_CHUNK;
+    while((Local->Dirty_Num!=0U)&&(Left!=0U))
+    {
+        Dirty=&(Local->Dirty[Local->Dirty_Num-1U]);
+        
+        if(Dirty->Size>Left)
+        {
+            RME_COV_MARKER();
+            
+            Size=Left;
+        }
+        else
+        {
+            RME_COV_MARKER();
+            
+            Size=Dirty->Size;
+        }
+        
+        /* Own the range, zero it, then mark it clean before releasing it */
+        if(_RME_Kot_Mark(Dirty->Addr,Size)==0)
+        {
+            RME_COV_MARKER();
+            
+            _RME_Clear((void*)(Dirty->Addr),Size);
+            _RME_Kot_Bmp_Mod(RME_Kot_Clean,Dirty->Addr,Size,1U);
+            _RME_Kot_Bmp_Mod(RME_KOT_VA_BASE,Dirty->Addr,Size,0U);
+        }
+        else
+        {
+            RME_COV_MARKER();
+            /* No action required */
+        }
+        
+        Dirty->Addr+=Size;
+        Dirty->Size-=Size;
+        Left-=Size;
+        
+        if(Dirty->Size==0U)
+        {
+            RME_COV_MARKER();
+            
+            Local->Dirty_Num--;
+        }
+        else
+        {
+            RME_COV_MARKER();
+            /* No action required */
+        }
+    }
+    
+    return Local->Dirty_Num;
+}
+/* End Function:_RME_Kot_Zero ************************************************/
+
+/* Function:_RME_Kot_Clean_Chk ************************************************
+Description : Check whether a kernel memory range was all zero when it was
+              marked. The caller must own the range in the kernel object table.
+              The clean bits are not cleared here; they stay until the range
+              is erased, which happens before anyone else could mark it again.
+Input       : rme_ptr_t Kaddr - The kernel virtual address.
+              rme_ptr_t Size - The size of the memory range.
+Output      : None.
+Return      : rme_ptr_t - 1 if the range is known to be clean; 0 otherwise.
+******************************************************************************/
+rme_ptr_t _RME_Kot_Clean_Chk(rme_ptr_t Kaddr,
+                             rme_ptr_t Size)
+{
+    rme_ptr_t Start;
+    rme_ptr_t End;
+    rme_ptr_t Mask_Begin;
+    rme_ptr_t Mask_End;
+    rme_ptr_t Count;
+    
+    /* Get the starting position and the ending position of the range */
+    Start=(Kaddr-RME_KOM_VA_BASE)>>RME_KOM_SLOT_ORDER;
+    Mask_Begin=RME_MASK_BEGIN(Start&RME_MASK_END(RME_WORD_ORDER-1U));
+    Start=Start>>RME_WORD_ORDER;
+    
+    End=(Kaddr+Size-1U-RME_KOM_VA_BASE)>>RME_KOM_SLOT_ORDER;
+    Mask_End=RME_MASK_END(End&RME_MASK_END(RME_WORD_ORDER-1U));
+    End=End>>RME_WORD_ORDER;
+    
+    /* See if the start and end are in the same word */
+    if(Start==End)
+    {
+        RME_COV_MARKER();
+        
+        Mask_Begin&=Mask_End;
+        Mask_End=Mask_Begin;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        
+        for(Count=Start+1U;Count<End;Count++)
+        {
+            if(RME_Kot_Clean[Count]!=RME_MASK_FULL)
+            {
+                RME_COV_MARKER();
+                
+                return 0U;
+            }
+            else
+            {
+                RME_COV_MARKER();
+                /* No action required */
+            }
+        }
+    }
+    
+    /* Check the edges */
+    if(((RME_Kot_Clean[Start]&Mask_Begin)!=Mask_Begin)||
+       ((RME_Kot_Clean[End]&Mask_End)!=Mask_End))
+    {
+        RME_COV_MARKER();
+        
+        return 0U;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+    
+    return 1U;
+}
+/* End Function:_RME_Kot_Clean_Chk *******************************************/
+#endif
+
+/* Function:_RME_Kot_Stat_Get *************************************************
+Description : Read one of the kernel object table contention counters of this
+              CPU, and optionally clear it so that the next read only covers
+              what happens in between. The counters wrap around; the top bit
+              is dropped so that the value never looks like an error code.
+Input       : struct RME_CPU_Local* Local - The CPU-local data structure.
+              rme_ptr_t Counter - The counter to read, RME_KOT_STAT_FAIL,
+                                  RME_KOT_STAT_RETRY or RME_KOT_STAT_UNDO.
+              rme_ptr_t Clear - If not zero, clear the counter after reading.
+Output      : None.
+Return      : rme_ret_t - If successful, the counter value; or an error code.
+******************************************************************************/
+static rme_ret_t _RME_Kot_Stat_Get(struct RME_CPU_Local* Local,
+                                   rme_ptr_t Counter,
+                                   rme_ptr_t Clear)
+{
+    rme_ptr_t* Stat;
+    rme_ptr_t Value;
+    
+    if(Counter==RME_KOT_STAT_FAIL)
+    {
+        RME_COV_MARKER();
+        
+        Stat=&(Local->Kot_Stat.Fail);
+    }
+    else if(Counter==RME_KOT_STAT_RETRY)
+    {
+        RME_COV_MARKER();
+        
+        Stat=&(Local->Kot_Stat.Retry);
     }
-
-    return 0;
+    else if(Counter==RME_KOT_STAT_UNDO)
+    {
+        RME_COV_MARKER();
+        
+        Stat=&(Local->Kot_Stat.Undo);
+    }
+    else
+    {
+        RME_COV_MARKER();
+        
+        return RME_ERR_KFN_FAIL;
+    }
+    
+    /* Only this CPU ever writes its own counters, so no atomics needed */
+    Value=*Stat;
+    if(Clear!=0U)
+    {
+        RME_COV_MARKER();
+        
+        *Stat=0U;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+    
+    return (rme_ret_t)(Value&RME_MASK_END(RME_WORD_BIT-2U));
 }
-/* End Function:_RME_Kot_Erase ***********************************************/
+/* End Function:_RME_Kot_Stat_Get ********************************************/
 
 /* Function:_RME_Kom_Boot_Crt *************************************************
 Description : Create boot-time kernel memory capability. Kernel memory allow
@@ -4313,18 +5570,35 @@ void _RME_CPU_Local_Init(struct RME_CPU_Local* Local,
                          rme_ptr_t CPUID)
 {
     rme_ptr_t Prio_Cnt;
+#if(RME_CPT_CACHE_NUM!=0U)
+    rme_ptr_t Cache_Cnt;
+#endif
     
     Local->CPUID=CPUID;
     Local->Thd_Cur=RME_NULL;
     Local->Sig_Vct=RME_NULL;
     Local->Sig_Tim=RME_NULL;
     
+    /* Clear the kernel object table statistics */
+    Local->Kot_Stat.Fail=0U;
+    Local->Kot_Stat.Retry=0U;
+    Local->Kot_Stat.Undo=0U;
+#if(RME_KOT_ZERO_NUM!=0U)
+    Local->Dirty_Num=0U;
+#endif
+    
     /* Initialize the run-queue and bitmap */
     for(Prio_Cnt=0U;Prio_Cnt<RME_PREEMPT_PRIO_NUM;Prio_Cnt++)
     {
         Local->Run.Bitmap[Prio_Cnt>>RME_WORD_ORDER]=0U;
         _RME_List_Crt(&(Local->Run.List[Prio_Cnt]));
     }
+
+#if(RME_CPT_CACHE_NUM!=0U)
+    /* Initialize the capability lookup cache - no master table is at address zero */
+    for(Cache_Cnt=0U;Cache_Cnt<RME_CPT_CACHE_NUM;Cache_Cnt++)
+        Local->Cpt_Cache[Cache_Cnt].Cpt=RME_NULL;
+#endif
 }
 /* End Function:_RME_CPU_Local_Init ******************************************/
 
@@ -4334,9 +5608,11 @@ Description : The fatal fault handler of RME. This handler will be called by
               exception has happened and we need to see if this thread is in a
               synchronous invocation. If yes, we stop the invocation, and
               possibly return a fault value to the old register set. If not, we
-              just kill the thread. If the thread is killed, a notification
-              will be sent to its scheduler. An Exec_Set is required to clear
-              the exception pending status of the thread.
+              just kill the thread. If the thread is killed, the fault will be
+              forwarded to the pager of its process if it is waiting on this
+              core, or a notification will be sent to its scheduler. An
+              Exec_Set is required to clear the exception pending status of
+              the thread.
               Some processors may raise some exceptions that are difficult to
               attribute to a particular thread, either due to the fact that
               they are asynchronous, or they are derived from exception entry.
@@ -4383,9 +5659,19 @@ void _RME_Thd_Fatal(struct RME_Reg_Struct* Reg)
         /* Remove from runqueue */
         _RME_Run_Del(Thd_Cur);
         
-        /* Exception pending and notify parent */
+        /* Exception pending, and notify pager or parent */
         Thd_Cur->Sched.State=RME_THD_EXCPEND;
-        _RME_Run_Notif(Thd_Cur);
+        if(_RME_Run_Pgr(Thd_Cur)!=0)
+        {
+            RME_COV_MARKER();
+            
+            _RME_Run_Notif(Thd_Cur);
+        }
+        else
+        {
+            RME_COV_MARKER();
+            /* No action required */
+        }
         
         /* All kernel send complete, now pick the highest priority thread to run */
         _RME_Kern_High(Reg,Local);
@@ -4546,6 +5832,77 @@ static void _RME_Run_Notif(struct RME_Thd_Struct* Thd)
 }
 /* End Function:_RME_Run_Notif ***********************************************/
 
+/* Function:_RME_Run_Pgr ******************************************************
+Description : Try to forward a fault of the thread to the pager endpoint of its
+              process. This only succeeds when a pager thread is blocked on
+              that endpoint on the same core; the pager thread is then woken
+              up with the kernel send routine, and only after that succeeds
+              is the fault information written into its parameter registers.
+              Fault notifications that cannot take this fast path are sent to
+              the scheduler thread as usual.
+              This function includes kernel send, so we need to call 
+              _RME_Kern_High after this.
+Input       : struct RME_Thd_Struct* Thd - The faulting thread.
+Output      : None.
+Return      : rme_ret_t - If forwarded, 0; else RME_ERR_SIV_ACT.
+******************************************************************************/
+static rme_ret_t _RME_Run_Pgr(struct RME_Thd_Struct* Thd)
+{
+    struct RME_Cap_Sig* Pgr;
+    struct RME_Thd_Struct* Pgr_Thd;
+    
+    Pgr=Thd->Sched.Prc->Pgr;
+    
+    /* See if this process have a pager endpoint at all */
+    if(RME_LIKELY(Pgr==RME_NULL))
+    {
+        RME_COV_MARKER();
+        
+        return RME_ERR_SIV_ACT;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+    
+    /* The pager must be waiting on our core. Blocked threads can only be
+     * unblocked by the core that they are on, so this can't change under us */
+    Pgr_Thd=Pgr->Thd;
+    if(RME_UNLIKELY((Pgr_Thd==RME_NULL)||(Pgr_Thd->Sched.Local!=RME_CPU_LOCAL())))
+    {
+        RME_COV_MARKER();
+        
+        return RME_ERR_SIV_ACT;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+    
+    /* Wake the pager up first - if this fails, its registers must stay intact */
+    if(RME_UNLIKELY(_RME_Kern_Snd(Pgr,1U)!=0))
+    {
+        RME_COV_MARKER();
+        
+        return RME_ERR_SIV_ACT;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+    
+    /* Put the fault information in the pager's registers. It has not run yet,
+     * and this does not touch the return value set by the kernel send */
+    __RME_Svc_Pgr_Set(&(Pgr_Thd->Ctx.Reg->Reg),Thd->Sched.TID,
+                      &(Thd->Ctx.Reg->Exc));
+    
+    return 0;
+}
+/* End Function:_RME_Run_Pgr *************************************************/
+
 /* Function:_RME_Thd_Pgt ******************************************************
 Description : Get a thread's page table. 
 Input       : struct RME_Thd_Struct* Thd - The thread.
@@ -4734,6 +6091,7 @@ rme_ret_t _RME_Prc_Boot_Crt(struct RME_Cap_Cpt* Cpt,
 #else
     Prc_Crt->Pgt=Raw_Pgt;
 #endif
+    Prc_Crt->Pgr=RME_NULL;
     
     /* Reference objects */
     RME_FETCH_ADD(&(Prc_Cpt->Head.Root_Ref),1);
@@ -4835,6 +6193,7 @@ static rme_ret_t _RME_Prc_Crt(struct RME_Cap_Cpt* Cpt,
 #else
     Prc_Crt->Pgt=Raw_Pgt;
 #endif
+    Prc_Crt->Pgr=RME_NULL;
     
     /* Reference objects */
     RME_FETCH_ADD(&(Prc_Cpt->Head.Root_Ref),1);
@@ -4874,6 +6233,7 @@ static rme_ret_t _RME_Prc_Del(struct RME_Cap_Cpt* Cpt,
 #if(RME_PGT_RAW_ENABLE==0U)
     struct RME_Cap_Pgt* Prc_Pgt;
 #endif
+    struct RME_Cap_Sig* Prc_Pgr;
 
     /* Get the capability slot */
     RME_CPT_GETCAP(Cpt,Cap_Cpt,RME_CAP_TYPE_CPT,
@@ -4891,6 +6251,7 @@ static rme_ret_t _RME_Prc_Del(struct RME_Cap_Cpt* Cpt,
 #if(RME_PGT_RAW_ENABLE==0U)
     Prc_Pgt=Prc_Del->Pgt;
 #endif
+    Prc_Pgr=Prc_Del->Pgr;
 
     /* Now we can safely delete the cap */
     RME_CAP_DELETE(Prc_Del,Type_Stat);
@@ -4900,6 +6261,17 @@ static rme_ret_t _RME_Prc_Del(struct RME_Cap_Cpt* Cpt,
 #if(RME_PGT_RAW_ENABLE==0U)
     RME_FETCH_ADD(&(Prc_Pgt->Head.Root_Ref),-1);
 #endif
+    if(Prc_Pgr!=RME_NULL)
+    {
+        RME_COV_MARKER();
+        
+        RME_FETCH_ADD(&(Prc_Pgr->Head.Root_Ref),-1);
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
     
     return 0;
 }
@@ -5043,6 +6415,106 @@ static rme_ret_t _RME_Prc_Pgt(struct RME_Cap_Cpt* Cpt,
 }
 /* End Function:_RME_Prc_Pgt *************************************************/
 
+/* Function:_RME_Prc_Pgr ******************************************************
+Description : Change a process's pager endpoint. When a thread of this process
+              faults outside of any invocation and a pager thread is blocked
+              on this endpoint on the same core, the fault is forwarded to the
+              pager directly rather than to the scheduler thread. The pager
+              receives the TID of the faulting thread and the fault information
+              in its registers, and resumes the faulting thread with a single
+              Exec_Set call that has no new entry and stack.
+              The pager endpoint should be dedicated to this purpose.
+Input       : struct RME_Cap_Cpt* Cpt - The master capability table.
+              rme_cid_t Cap_Prc - The capability to the process that have been
+                                  created already.
+                                  2-Level.
+              rme_cid_t Cap_Sig - The capability to the signal endpoint to use
+                                  as the pager endpoint. If this is
+                                  RME_CID_NULL, the pager endpoint is removed.
+                                  2-Level.
+Output      : None.
+Return      : rme_ret_t - If successful, 0; or an error code.
+******************************************************************************/
+static rme_ret_t _RME_Prc_Pgr(struct RME_Cap_Cpt* Cpt,
+                              rme_cid_t Cap_Prc,
+                              rme_cid_t Cap_Sig)
+{
+    struct RME_Cap_Prc* Prc_Op;
+    struct RME_Cap_Sig* Sig_New;
+    struct RME_Cap_Sig* Sig_Old;
+    rme_ptr_t Type_Stat;
+    
+    /* Get the capability slot */
+    RME_CPT_GETCAP(Cpt,Cap_Prc,RME_CAP_TYPE_PRC,
+                   struct RME_Cap_Prc*,Prc_Op,Type_Stat); 
+    /* Check if the target caps is not frozen and allows such operations */
+    RME_CAP_CHECK(Prc_Op,RME_PRC_FLAG_PGR);
+    
+    /* Check if we need the signal endpoint for this operation */
+    if(Cap_Sig!=RME_CID_NULL)
+    {
+        RME_COV_MARKER();
+
+        RME_CPT_GETCAP(Cpt,Cap_Sig,RME_CAP_TYPE_SIG,
+                       struct RME_Cap_Sig*,Sig_New,Type_Stat);
+        RME_CAP_CHECK(Sig_New,RME_SIG_FLAG_PGR);
+        /* Convert to root */
+        Sig_New=RME_CAP_CONV_ROOT(Sig_New,struct RME_Cap_Sig*);
+    }
+    else
+    {
+        RME_COV_MARKER();
+
+        Sig_New=RME_NULL;
+    }
+    
+    /* Threads only see the root process capability */
+    Prc_Op=RME_CAP_CONV_ROOT(Prc_Op,struct RME_Cap_Prc*);
+    
+    /* Commit the change */
+    Sig_Old=Prc_Op->Pgr;
+    if(RME_UNLIKELY(RME_COMP_SWAP((rme_ptr_t*)(&(Prc_Op->Pgr)),
+                                  (rme_ptr_t)Sig_Old,(rme_ptr_t)Sig_New)==RME_CASFAIL))
+    {
+        RME_COV_MARKER();
+        
+        return RME_ERR_PTH_CONFLICT;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+    
+    /* Reference new endpoint and dereference the old endpoint */
+    if(Sig_New!=RME_NULL)
+    {
+        RME_COV_MARKER();
+        
+        RME_FETCH_ADD(&(Sig_New->Head.Root_Ref),1);
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+    
+    if(Sig_Old!=RME_NULL)
+    {
+        RME_COV_MARKER();
+        
+        RME_FETCH_ADD(&(Sig_Old->Head.Root_Ref),-1);
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+
+    return 0;
+}
+/* End Function:_RME_Prc_Pgr *************************************************/
+
 /* Function:_RME_Thd_Boot_Crt *************************************************
 Description : Create a boot-time thread. The boot-time thread is per-core, and
               will have infinite budget, and has no parent. This function
@@ -7082,6 +8554,91 @@ rme_ret_t _RME_Kern_Snd(struct RME_Cap_Sig* Cap_Sig,
 }
 /* End Function:_RME_Kern_Snd ************************************************/
 
+/* Function:_RME_Kern_Sig_Bind ************************************************
+Description : Bind a signal endpoint to a kernel slot, so that the interrupt
+              routines can send to it directly. This is intended to be called
+              by the kernel functions of each port, and the slot is usually a
+              per-vector entry that the port keeps. The slot always holds the
+              root capability, and holds a reference to it so that it cannot
+              be deleted while bound.
+Input       : struct RME_Cap_Cpt* Cpt - The master capability table.
+              rme_cid_t Cap_Sig - The capability to the signal endpoint. If
+                                  this is RME_CID_NULL, the slot is cleared.
+                                  2-Level.
+              struct RME_Cap_Sig** Slot - The slot to bind the endpoint to.
+Output      : struct RME_Cap_Sig** Slot - The updated slot.
+Return      : rme_ret_t - If successful, 0, or an error code.
+******************************************************************************/
+rme_ret_t _RME_Kern_Sig_Bind(struct RME_Cap_Cpt* Cpt,
+                             rme_cid_t Cap_Sig,
+                             struct RME_Cap_Sig** Slot)
+{
+    struct RME_Cap_Sig* Sig_New;
+    struct RME_Cap_Sig* Sig_Old;
+    rme_ptr_t Type_Stat;
+    
+    /* Check if we need the signal endpoint for this operation */
+    if(Cap_Sig!=RME_CID_NULL)
+    {
+        RME_COV_MARKER();
+
+        RME_CPT_GETCAP(Cpt,Cap_Sig,RME_CAP_TYPE_SIG,
+                       struct RME_Cap_Sig*,Sig_New,Type_Stat);
+        RME_CAP_CHECK(Sig_New,RME_SIG_FLAG_VCT);
+        /* Convert to root */
+        Sig_New=RME_CAP_CONV_ROOT(Sig_New,struct RME_Cap_Sig*);
+    }
+    else
+    {
+        RME_COV_MARKER();
+
+        Sig_New=RME_NULL;
+    }
+    
+    /* Commit the change */
+    Sig_Old=*Slot;
+    if(RME_UNLIKELY(RME_COMP_SWAP((rme_ptr_t*)Slot,
+                                  (rme_ptr_t)Sig_Old,(rme_ptr_t)Sig_New)==RME_CASFAIL))
+    {
+        RME_COV_MARKER();
+        
+        return RME_ERR_PTH_CONFLICT;
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+    
+    /* Reference new endpoint and dereference the old endpoint */
+    if(Sig_New!=RME_NULL)
+    {
+        RME_COV_MARKER();
+        
+        RME_FETCH_ADD(&(Sig_New->Head.Root_Ref),1);
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+    
+    if(Sig_Old!=RME_NULL)
+    {
+        RME_COV_MARKER();
+        
+        RME_FETCH_ADD(&(Sig_Old->Head.Root_Ref),-1);
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+
+    return 0;
+}
+/* End Function:_RME_Kern_Sig_Bind *******************************************/
+
 /* Function:_RME_Sig_Snd ******************************************************
 Description : Try to send to a signal endpoint. This system call can cause
               a potential context switch.
@@ -7937,6 +9494,55 @@ static rme_ret_t _RME_Kfn_Act(struct RME_Cap_Cpt* Cpt,
         /* No action required */
     }
 
+#if(RME_PGT_RAW_ENABLE==0U)
+    /* Bulk queries only use the generic page table interface */
+    if(Func_ID==RME_KFN_PGT_ENTRY_QUERY)
+    {
+        RME_COV_MARKER();
+        
+        return _RME_Pgt_Query(Cpt,
+                              (rme_cid_t)Sub_ID,                            /* rme_cid_t Cap_Pgt */
+                              RME_PARAM_D1(Param1),                         /* rme_ptr_t Pos */
+                              RME_PARAM_D0(Param1),                         /* rme_ptr_t Num */
+                              Param2);                                      /* rme_ptr_t Buf */
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+#endif
+
+#if(RME_KOT_ZERO_NUM!=0U)
+    /* Deferred zeroing is generic, so the HAL does not see it */
+    if(Func_ID==RME_KFN_KOM_ZERO)
+    {
+        RME_COV_MARKER();
+        
+        return (rme_ret_t)_RME_Kot_Zero(RME_CPU_LOCAL());
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+#endif
+
+    /* Contention statistics are generic, so the HAL does not see them */
+    if(Func_ID==RME_KFN_KOT_STAT_GET)
+    {
+        RME_COV_MARKER();
+        
+        return _RME_Kot_Stat_Get(RME_CPU_LOCAL(),
+                                 Sub_ID,                                    /* rme_ptr_t Counter */
+                                 Param1);                                   /* rme_ptr_t Clear */
+    }
+    else
+    {
+        RME_COV_MARKER();
+        /* No action required */
+    }
+
     /* Return whatever the function returns */
     return __RME_Kfn_Handler(Cpt,Reg,Func_ID,Sub_ID,Param1,Param2);
 }
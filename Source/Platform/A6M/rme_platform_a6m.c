@@ -142,10 +142,8 @@ void __RME_A6M_Flag_Fast(rme_ptr_t Base,
 {
     volatile struct __RME_RVM_Flag* Set;
     
-    /* Choose a data structure that is not locked at the moment */
-    Set=RME_RVM_FLAG_SET(Base,Size,0U);
-    if(Set->Lock!=0U)
-        Set=RME_RVM_FLAG_SET(Base,Size,0U);
+    /* Write to the buffer that the consumer is not draining at the moment */
+    Set=RME_RVM_FLAG_SET(Base,Size,RME_RVM_FLAG_CUR(Base)&1U);
     
     /* Set the flags for this interrupt source */
     Set->Fast|=Flag;
@@ -154,6 +152,7 @@ void __RME_A6M_Flag_Fast(rme_ptr_t Base,
 
 /* Function:__RME_A6M_Flag_Slow ***********************************************
 Description : Set a slow flag in a flag set. Works for both vectors and events.
+              The size of the flagset decides whether there is a summary level.
 Input       : rme_ptr_t Base - The base address of the flagset.
               rme_ptr_t Size - The size of the flagset.
               rme_ptr_t Pos - The position in the flagset to set.
@@ -165,15 +164,23 @@ void __RME_A6M_Flag_Slow(rme_ptr_t Base,
                          rme_ptr_t Pos)
 {
     volatile struct __RME_RVM_Flag* Set;
+    rme_ptr_t Word;
+    rme_ptr_t Sum;
     
-    /* Choose a data structure that is not locked at the moment */
-    Set=RME_RVM_FLAG_SET(Base,Size,0U);
-    if(Set->Lock!=0U)
-        Set=RME_RVM_FLAG_SET(Base,Size,1U);
+    /* Write to the buffer that the consumer is not draining at the moment */
+    Set=RME_RVM_FLAG_SET(Base,Size,RME_RVM_FLAG_CUR(Base)&1U);
     
-    /* Set the flags for this interrupt source */
-    Set->Group|=RME_POW2(Pos>>RME_WORD_ORDER);
-    RME_BITMAP_SET(Set->Flag,Pos);
+    /* Set the flag, and mark the path down to it in the summary levels */
+    Word=Pos>>RME_WORD_ORDER;
+    Sum=RME_RVM_FLAG_SUM(Size);
+    if(Sum==0U)
+        Set->Group|=RME_POW2(Word);
+    else
+    {
+        Set->Group|=RME_POW2(Word>>RME_WORD_ORDER);
+        RME_BITMAP_SET(Set->Data,Word);
+    }
+    RME_BITMAP_SET(&(Set->Data[Sum]),Pos);
 }
 /* End Function:__RME_A6M_Flag_Slow ******************************************/
 
@@ -187,6 +194,20 @@ Return      : None.
 ******************************************************************************/
 void __RME_A6M_Vct_Handler(struct RME_Reg_Struct* Reg, rme_ptr_t Vct_Num)
 {
+    struct RME_Cap_Sig* Sig;
+    
+    /* If the vector has its own endpoint, wake the driver in one hop. The vector
+     * is masked until the driver has serviced it and enables it again */
+    Sig=RME_A6M_Vct_Sig[Vct_Num];
+    if(Sig!=RME_NULL)
+    {
+        RME_A6M_NVIC_ICER(Vct_Num)=RME_POW2(Vct_Num&0x1FU);
+        _RME_Kern_Snd(Sig,1U);
+        _RME_Kern_High(Reg,&RME_A6M_Local);
+        RME_A6M_EXC_RET_FIX(Reg);
+        return;
+    }
+    
 #if(RME_RVM_GEN_ENABLE!=0U)
     /* If the user wants to bypass, we skip the flag marshalling & sending process */
     if(RME_Boot_Vct_Handler(Reg,Vct_Num)!=0U)
@@ -288,13 +309,19 @@ rme_ret_t __RME_A6M_Pgt_Entry_Mod(struct RME_Cap_Cpt* Cpt,
 
 /* Function:__RME_A6M_Int_Local_Mod *******************************************
 Description : Consult or modify the local interrupt controller's vector state.
-Input       : rme_ptr_t Int_Num - The interrupt number to consult or modify.
+              A vector can also be bound to its own signal endpoint, so that
+              its driver is woken directly rather than through Sig_Vct.
+Input       : struct RME_Cap_Cpt* Cpt - The current capability table.
+              rme_ptr_t Int_Num - The interrupt number to consult or modify.
               rme_ptr_t Operation - The operation to conduct.
-              rme_ptr_t Param - The parameter, could be state or priority.
+              rme_ptr_t Param - The parameter, could be state, priority, or
+                                signal endpoint capability; RME_CID_NULL
+                                unbinds the endpoint.
 Output      : None.
 Return      : rme_ret_t - If successful, 0 or the desired value; else RME_ERR_KFN_FAIL.
 ******************************************************************************/
-rme_ret_t __RME_A6M_Int_Local_Mod(rme_ptr_t Int_Num,
+rme_ret_t __RME_A6M_Int_Local_Mod(struct RME_Cap_Cpt* Cpt,
+                                  rme_ptr_t Int_Num,
                                   rme_ptr_t Operation,
                                   rme_ptr_t Param)
 {
@@ -331,6 +358,12 @@ rme_ret_t __RME_A6M_Int_Local_Mod(rme_ptr_t Int_Num,
             RME_A6M_NVIC_IPR_SET(Int_Num, Param);
             return 0U;
         }
+        case RME_A6M_KFN_INT_LOCAL_MOD_SIG_SET:
+        {
+            return _RME_Kern_Sig_Bind(Cpt,
+                                      (rme_cid_t)Param,
+                                      &(RME_A6M_Vct_Sig[Int_Num]));
+        }
         default:break;
     }
     
@@ -734,7 +767,8 @@ rme_ret_t __RME_Kfn_Handler(struct RME_Cap_Cpt* Cpt,
 /* Interrupt controller operations *******************************************/
         case RME_KFN_INT_LOCAL_MOD:
         {
-            Retval=__RME_A6M_Int_Local_Mod(Sub_ID,
+            Retval=__RME_A6M_Int_Local_Mod(Cpt,
+                                           Sub_ID,
                                            Param1,
                                            Param2);
             break;
@@ -1179,6 +1213,25 @@ void __RME_Svc_Retval_Set(struct RME_Reg_Struct* Reg,
 }
 /* End Function:__RME_Svc_Retval_Set *****************************************/
 
+/* Function:__RME_Svc_Pgr_Set *************************************************
+Description : Set the fault information for a pager thread that is woken up
+              by a fault. R4 carries the signal number as usual; there is no
+              fault address on this architecture.
+Input       : rme_ptr_t TID - The thread ID of the faulting thread.
+              struct RME_Exc_Struct* Exc - The fault information.
+Output      : struct RME_Reg_Struct* Reg - The register set of the pager.
+Return      : None.
+******************************************************************************/
+void __RME_Svc_Pgr_Set(struct RME_Reg_Struct* Reg,
+                       rme_ptr_t TID,
+                       struct RME_Exc_Struct* Exc)
+{
+    Reg->R5=TID;
+    Reg->R6=Exc->Cause;
+    Reg->R7=0U;
+}
+/* End Function:__RME_Svc_Pgr_Set ********************************************/
+
 /* Function:__RME_Thd_Reg_Init ************************************************
 Description : Initialize the register set for the thread.
 Input       : rme_ptr_t Attr - Always RME_A6M_ATTR_NONE.
@@ -1329,6 +1382,12 @@ void __RME_Pgt_Set(rme_ptr_t Pgt)
     MPU_Data=(struct __RME_A6M_MPU_Data*)(RME_CAP_GETOBJ(Pgt, rme_ptr_t)+
                                           sizeof(struct __RME_A6M_Pgt_Meta));
     Raw_Pgt=&(MPU_Data->Raw);
+    
+    /* Skip the reload if this MPU data is already loaded and did not change since */
+    if((MPU_Data==RME_A6M_MPU_Cur)&&(MPU_Data->Gen==RME_A6M_MPU_Cur_Gen))
+        return;
+    RME_A6M_MPU_Cur=MPU_Data;
+    RME_A6M_MPU_Cur_Gen=MPU_Data->Gen;
 #else
     Raw_Pgt=(struct __RME_A6M_Raw_Pgt*)Pgt;
 #endif
@@ -1397,19 +1456,33 @@ rme_ret_t __RME_Pgt_Init(struct RME_Cap_Pgt* Pgt_Op)
      * environments, if it is top-level, we need to add kernel pages as well */
     if(((Pgt_Op->Base)&RME_PGT_TOP)!=0U)
     {
+        /* A new generation, so that memory reused from a loaded table is loaded again */
+        RME_A6M_MPU_Gen++;
+        ((struct __RME_A6M_MPU_Data*)Ptr)->Gen=RME_A6M_MPU_Gen;
+        
         for(Count=0;Count<RME_A6M_REGION_NUM;Count++)
         {
             ((struct __RME_A6M_MPU_Data*)Ptr)->Raw.Data[Count].RBAR=RME_A6M_MPU_VALID|Count;
             ((struct __RME_A6M_MPU_Data*)Ptr)->Raw.Data[Count].RASR=0U;
         }
         
+#if(RME_PGT_WALK_CACHE_NUM!=0U)
+        ((struct __RME_A6M_MPU_Data*)Ptr)->Cache_Hand=0U;
+        for(Count=0U;Count<RME_PGT_WALK_CACHE_NUM;Count++)
+            ((struct __RME_A6M_MPU_Data*)Ptr)->Cache[Count].Meta=RME_NULL;
+#endif
+        
         Ptr+=sizeof(struct __RME_A6M_MPU_Data)/sizeof(rme_ptr_t);
     }
     
     /* Clean up the table itself - This is could be virtually unbounded if the user
-     * pass in some very large length value */
-    for(Count=0U;Count<RME_POW2(RME_PGT_NMORD(Pgt_Op->Order));Count++)
-        Ptr[Count]=0U;
+     * pass in some very large length value. This is skipped if the table was
+     * zeroed in advance. */
+    if(RME_KOT_CLEAN_CHK(Ptr,RME_POW2(RME_PGT_NMORD(Pgt_Op->Order))*RME_WORD_BYTE)==0U)
+    {
+        for(Count=0U;Count<RME_POW2(RME_PGT_NMORD(Pgt_Op->Order));Count++)
+            Ptr[Count]=0U;
+    }
     
     return 0;
 }
@@ -1555,6 +1628,9 @@ rme_ret_t ___RME_A6M_MPU_Clear(struct __RME_A6M_MPU_Data* Top_MPU,
                 /* Clean it up and return */
                 Top_MPU->Raw.Data[Count].RBAR=RME_A6M_MPU_VALID|Count;
                 Top_MPU->Raw.Data[Count].RASR=0U;
+                /* The MPU data changed, and must be loaded again */
+                RME_A6M_MPU_Gen++;
+                Top_MPU->Gen=RME_A6M_MPU_Gen;
                 return 0;
             }
         }
@@ -1599,6 +1675,9 @@ rme_ret_t ___RME_A6M_MPU_Add(struct __RME_A6M_MPU_Data* Top_MPU,
             {
                 /* Update the RASR - all flag changes are reflected here */
                 Top_MPU->Raw.Data[Count].RASR=RASR;
+                /* The MPU data changed, and must be loaded again */
+                RME_A6M_MPU_Gen++;
+                Top_MPU->Gen=RME_A6M_MPU_Gen;
                 return 0U;
             }
         }
@@ -1619,6 +1698,9 @@ rme_ret_t ___RME_A6M_MPU_Add(struct __RME_A6M_MPU_Data* Top_MPU,
     /* Put the data to this slot */
     Top_MPU->Raw.Data[Count].RBAR=RME_A6M_MPU_ADDR(Base_Addr)|RME_A6M_MPU_VALID|Count;
     Top_MPU->Raw.Data[Count].RASR=RASR;
+    /* The MPU data changed, and must be loaded again */
+    RME_A6M_MPU_Gen++;
+    Top_MPU->Gen=RME_A6M_MPU_Gen;
 
     return 0;
 }
@@ -1829,6 +1911,13 @@ rme_ret_t __RME_Pgt_Page_Map(struct RME_Cap_Pgt* Pgt_Op,
     {
         if((Flag&RME_PGT_STATIC)!=0U)
         {
+            /* In a batch, the MPU representation is updated once at the end */
+            if(RME_A6M_Pgt_Batch!=RME_A6M_PGT_BATCH_NONE)
+            {
+                RME_A6M_Pgt_Batch=RME_A6M_PGT_BATCH_DIRTY;
+                return 0;
+            }
+            
             /* Mapping static pages, update the MPU representation */
             if(___RME_A6M_MPU_Update(Meta,RME_A6M_MPU_UPD)==RME_ERR_HAL_FAIL)
             {
@@ -1845,6 +1934,50 @@ rme_ret_t __RME_Pgt_Page_Map(struct RME_Cap_Pgt* Pgt_Op,
 }
 /* End Function:__RME_Pgt_Page_Map *******************************************/
 
+/* Function:__RME_A6M_Pgt_Batch_Begin *****************************************
+Description : Begin a batch of page mappings into a single page directory. The
+              MPU representation is not updated for each page in the batch.
+Input       : struct RME_Cap_Pgt* Pgt_Op - The page table to map into.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_A6M_Pgt_Batch_Begin(struct RME_Cap_Pgt* Pgt_Op)
+{
+    RME_A6M_Pgt_Batch=RME_A6M_PGT_BATCH_CLEAN;
+}
+/* End Function:__RME_A6M_Pgt_Batch_Begin ************************************/
+
+/* Function:__RME_A6M_Pgt_Batch_End *******************************************
+Description : End a batch of page mappings, and update the MPU representation
+              once if any static page got mapped in the batch. All pages in the
+              batch are in the same directory, so this is exactly what mapping
+              them one by one would have done.
+Input       : struct RME_Cap_Pgt* Pgt_Op - The page table mapped into.
+Output      : None.
+Return      : rme_ret_t - If successful, 0; else RME_ERR_HAL_FAIL, in which case
+                          the caller shall unmap all pages in the batch.
+******************************************************************************/
+rme_ret_t __RME_A6M_Pgt_Batch_End(struct RME_Cap_Pgt* Pgt_Op)
+{
+    rme_ptr_t Batch;
+    
+    Batch=RME_A6M_Pgt_Batch;
+    RME_A6M_Pgt_Batch=RME_A6M_PGT_BATCH_NONE;
+    
+    if(Batch!=RME_A6M_PGT_BATCH_DIRTY)
+        return 0;
+    
+    if(___RME_A6M_MPU_Update(RME_CAP_GETOBJ(Pgt_Op,struct __RME_A6M_Pgt_Meta*),
+                              RME_A6M_MPU_UPD)==RME_ERR_HAL_FAIL)
+        return RME_ERR_HAL_FAIL;
+    
+    /* Update MPU in case we're manipulating the current page table */
+    ___RME_A6M_Pgt_Refresh();
+    
+    return 0;
+}
+/* End Function:__RME_A6M_Pgt_Batch_End **************************************/
+
 /* Function:__RME_Pgt_Page_Unmap **********************************************
 Description : Unmap a page from the page table.
 Input       : struct RME_Cap_Pgt* - The capability to the page table to operate on.
@@ -1881,6 +2014,10 @@ rme_ret_t __RME_Pgt_Page_Unmap(struct RME_Cap_Pgt* Pgt_Op,
 
     Temp=Table[Pos];
     Table[Pos]=0U;
+#if(RME_PGT_WALK_CACHE_NUM!=0U)
+    /* Invalidate all walk cache entries */
+    RME_A6M_Pgt_Gen++;
+#endif
     /* If we are top-level or we have a top-level, do MPU updates */
     if((Meta->Toplevel!=0U)||(((Pgt_Op->Base)&RME_PGT_TOP)!=0U))
     {
@@ -2025,6 +2162,10 @@ rme_ret_t __RME_Pgt_Pgdir_Unmap(struct RME_Cap_Pgt* Pgt_Parent,
 
     Table[Pos]=0U;
     Meta_Parent->Toplevel=0U;
+#if(RME_PGT_WALK_CACHE_NUM!=0U)
+    /* Invalidate all walk cache entries */
+    RME_A6M_Pgt_Gen++;
+#endif
 
     return 0;
 }
@@ -2067,6 +2208,73 @@ rme_ret_t __RME_Pgt_Lookup(struct RME_Cap_Pgt* Pgt_Op,
 }
 /* End Function:__RME_Pgt_Lookup *********************************************/
 
+/* Function:___RME_A6M_Pgt_Cache_Find *****************************************
+Description : Look up a virtual address in the walk cache of a top-level page
+              table. Entries filled in before the last unmapping are stale.
+Input       : struct __RME_A6M_Pgt_Meta* Top - The top-level page table.
+              rme_ptr_t Vaddr - The virtual address to look up.
+Output      : None.
+Return      : struct __RME_A6M_Pgt_Cache* - The cache entry, or RME_NULL if missed.
+******************************************************************************/
+#if((RME_PGT_RAW_ENABLE==0U)&&(RME_PGT_WALK_CACHE_NUM!=0U))
+struct __RME_A6M_Pgt_Cache* ___RME_A6M_Pgt_Cache_Find(struct __RME_A6M_Pgt_Meta* Top,
+                                                      rme_ptr_t Vaddr)
+{
+    rme_ptr_t Count;
+    struct __RME_A6M_Pgt_Cache* Cache;
+    
+    for(Count=0U;Count<RME_PGT_WALK_CACHE_NUM;Count++)
+    {
+        Cache=&(RME_A6M_PGT_MPU(Top)->Cache[Count]);
+        if((Cache->Meta!=RME_NULL)&&(Cache->Gen==RME_A6M_Pgt_Gen)&&
+           (Vaddr>=Cache->Start)&&(Vaddr<=Cache->End))
+            return Cache;
+    }
+    
+    return RME_NULL;
+}
+#endif
+/* End Function:___RME_A6M_Pgt_Cache_Find ************************************/
+
+/* Function:___RME_A6M_Pgt_Cache_Fill *****************************************
+Description : Remember a page found by a walk in the walk cache of a top-level
+              page table. The entries are replaced in a round-robin fashion.
+Input       : struct __RME_A6M_Pgt_Meta* Top - The top-level page table.
+              struct __RME_A6M_Pgt_Meta* Meta - The page directory of the page.
+              rme_ptr_t Start - The start address of the page.
+              rme_ptr_t Flag - The RME standard flags of the page.
+Output      : None.
+Return      : None.
+******************************************************************************/
+#if((RME_PGT_RAW_ENABLE==0U)&&(RME_PGT_WALK_CACHE_NUM!=0U))
+void ___RME_A6M_Pgt_Cache_Fill(struct __RME_A6M_Pgt_Meta* Top,
+                               struct __RME_A6M_Pgt_Meta* Meta,
+                               rme_ptr_t Start,
+                               rme_ptr_t Flag)
+{
+    struct __RME_A6M_MPU_Data* Top_Data;
+    struct __RME_A6M_Pgt_Cache* Cache;
+    
+    Top_Data=RME_A6M_PGT_MPU(Top);
+    Cache=&(Top_Data->Cache[Top_Data->Cache_Hand]);
+    
+    Cache->Gen=RME_A6M_Pgt_Gen;
+    Cache->Start=Start;
+    /* Shifting by RME_WORD_BIT or more is UB */
+    if(RME_PGT_SZORD(Meta->Order)>=RME_WORD_BIT)
+        Cache->End=RME_MASK_FULL;
+    else
+        Cache->End=Start+RME_POW2(RME_PGT_SZORD(Meta->Order))-1U;
+    Cache->Flag=Flag;
+    Cache->Meta=Meta;
+    
+    Top_Data->Cache_Hand++;
+    if(Top_Data->Cache_Hand>=RME_PGT_WALK_CACHE_NUM)
+        Top_Data->Cache_Hand=0U;
+}
+#endif
+/* End Function:___RME_A6M_Pgt_Cache_Fill ************************************/
+
 /* Function:__RME_Pgt_Walk ****************************************************
 Description : Walking function for the page table. This function just does page
               table lookups. The page table that is being walked must be the top-
@@ -2092,71 +2300,90 @@ rme_ret_t __RME_Pgt_Walk(struct RME_Cap_Pgt* Pgt_Op,
                          rme_ptr_t* Flag)
 {
     struct __RME_A6M_Pgt_Meta* Meta;
+    struct __RME_A6M_Pgt_Cache* Cache;
     rme_ptr_t* Table;
     rme_ptr_t Pos;
     rme_ptr_t Shift;
+    rme_ptr_t Start;
+    rme_ptr_t Page_Flag;
+#if(RME_PGT_WALK_CACHE_NUM!=0U)
+    struct __RME_A6M_Pgt_Meta* Top;
+#endif
     
     /* This must the top-level page table */
     RME_ASSERT(((Pgt_Op->Base)&RME_PGT_TOP)!=0U);
     
-    /* Get the table and start lookup */
+    /* Get the table and see if the page was walked to recently */
     Meta=RME_CAP_GETOBJ(Pgt_Op,struct __RME_A6M_Pgt_Meta*);
-    Table=RME_A6M_PGT_TBL_TOP(Meta);
+#if(RME_PGT_WALK_CACHE_NUM!=0U)
+    Top=Meta;
+    Cache=___RME_A6M_Pgt_Cache_Find(Top,Vaddr);
+#else
+    Cache=RME_NULL;
+#endif
     
-    /* Do lookup recursively */
-    while(1)
+    if(Cache!=RME_NULL)
     {
-        /* Check if the virtual address is in our range */
-        if(Vaddr<RME_PGT_BASE(Meta->Base))
-            return RME_ERR_HAL_FAIL;
-        /* Calculate entry position - shifting by RME_WORD_BITS or more is UB */
-        Shift=RME_PGT_SZORD(Meta->Order);
-        if(Shift>=RME_WORD_BIT)
-            Pos=0U;
-        else
-            Pos=(Vaddr-RME_PGT_BASE(Meta->Base))>>Shift;
-        /* See if the entry is overrange */
-        if((Pos>>RME_PGT_NMORD(Meta->Order))!=0U)
-            return RME_ERR_HAL_FAIL;
-        /* Find the position of the entry - Is there a page, a directory, or nothing? */
-        if((Table[Pos]&RME_A6M_PGT_PRESENT)==0U)
-            return RME_ERR_HAL_FAIL;
-        if((Table[Pos]&RME_A6M_PGT_TERMINAL)!=0U)
+        Meta=Cache->Meta;
+        Start=Cache->Start;
+        Page_Flag=Cache->Flag;
+    }
+    else
+    {
+        Table=RME_A6M_PGT_TBL_TOP(Meta);
+        /* Do lookup recursively */
+        while(1)
         {
-            /* This is a page - we found it */
-            if(Pgt!=RME_NULL)
-                *Pgt=(rme_ptr_t)Meta;
-            if(Map_Vaddr!=RME_NULL)
+            /* Check if the virtual address is in our range */
+            if(Vaddr<RME_PGT_BASE(Meta->Base))
+                return RME_ERR_HAL_FAIL;
+            /* Calculate entry position - shifting by RME_WORD_BIT or more is UB */
+            Shift=RME_PGT_SZORD(Meta->Order);
+            if(Shift>=RME_WORD_BIT)
+                Pos=0U;
+            else
+                Pos=(Vaddr-RME_PGT_BASE(Meta->Base))>>Shift;
+            /* See if the entry is overrange */
+            if((Pos>>RME_PGT_NMORD(Meta->Order))!=0U)
+                return RME_ERR_HAL_FAIL;
+            /* Find the position of the entry - Is there a page, a directory, or nothing? */
+            if((Table[Pos]&RME_A6M_PGT_PRESENT)==0U)
+                return RME_ERR_HAL_FAIL;
+            if((Table[Pos]&RME_A6M_PGT_TERMINAL)!=0U)
             {
+                /* This is a page - we found it */
                 if(Shift>=RME_WORD_BIT)
-                    *Map_Vaddr=RME_PGT_BASE(Meta->Base);
+                    Start=RME_PGT_BASE(Meta->Base);
                 else
-                    *Map_Vaddr=RME_PGT_BASE(Meta->Base)+(Pos<<Shift);
+                    Start=RME_PGT_BASE(Meta->Base)+(Pos<<Shift);
+                Page_Flag=Meta->Page_Flag;
+                break;
             }
-            if(Paddr!=RME_NULL)
+            else
             {
-                if(Shift>=RME_WORD_BIT)
-                    *Paddr=RME_PGT_BASE(Meta->Base);
-                else
-                    *Paddr=RME_PGT_BASE(Meta->Base)+(Pos<<Shift);
+                /* This is a directory, we goto that directory to continue walking */
+                Meta=(struct __RME_A6M_Pgt_Meta*)RME_A6M_PGT_PGD_ADDR(Table[Pos]);
+                Table=RME_A6M_PGT_TBL_NOM(Meta);
             }
-            if(Size_Order!=RME_NULL)
-                *Size_Order=RME_PGT_SZORD(Meta->Order);
-            if(Num_Order!=RME_NULL)
-                *Num_Order=RME_PGT_NMORD(Meta->Order);
-            if(Flag!=RME_NULL)
-                *Flag=Meta->Page_Flag;
-            
-            break;
-        }
-        else
-        {
-            /* This is a directory, we goto that directory to continue walking */
-            Meta=(struct __RME_A6M_Pgt_Meta*)RME_A6M_PGT_PGD_ADDR(Table[Pos]);
-            Table=RME_A6M_PGT_TBL_NOM(Meta);
         }
+#if(RME_PGT_WALK_CACHE_NUM!=0U)
+        ___RME_A6M_Pgt_Cache_Fill(Top,Meta,Start,Page_Flag);
+#endif
     }
     
+    if(Pgt!=RME_NULL)
+        *Pgt=(rme_ptr_t)Meta;
+    if(Map_Vaddr!=RME_NULL)
+        *Map_Vaddr=Start;
+    if(Paddr!=RME_NULL)
+        *Paddr=Start;
+    if(Size_Order!=RME_NULL)
+        *Size_Order=RME_PGT_SZORD(Meta->Order);
+    if(Num_Order!=RME_NULL)
+        *Num_Order=RME_PGT_NMORD(Meta->Order);
+    if(Flag!=RME_NULL)
+        *Flag=Page_Flag;
+
     return 0;
 }
 #endif
@@ -77,10 +77,10 @@ Input       : None.
 Output      : None.
 Return      : struct RME_CPU_Local* - The CPU-local data structures.
 ******************************************************************************/
-/*struct RME_CPU_Local* __RME_A7A_CPU_Local_Get(void)
+struct RME_CPU_Local* __RME_A7A_CPU_Local_Get(void)
 {
-    return &RME_A7A_Local[__RME_A7A_MPIDR_Get()&0x03];
-}*/
+    return &RME_A7A_Local[__RME_A7A_MPIDR_Get()&0x03U];
+}
 /* End Function:__RME_A7A_CPU_Local_Get *************************************/
 
 /* Function:__RME_A7A_Int_Init ***********************************************
@@ -282,36 +282,49 @@ void __RME_A7A_Int_Local_Init(void)
 }
 /* End Function:__RME_A7A_Int_Local_Init ************************************/
 
-/* Function:__RME_A7A_Timer_Init *********************************************
-Description : Initialize the interrupt controller of the Cortex-A ARMv7 platform.
-              This will only initialize the distributor and will only be run by
-              the first CPU. This will initialize the timer as well.
+/* Function:__RME_A7A_Timer_Local_Init ***************************************
+Description : Initialize the private timer of the processor. Each core has its
+              own private timer and its own copy of the timer interrupt, so this
+              is run by every CPU, and each CPU enforces its own time slices.
 Input       : None.
 Output      : None.
 Return      : None.
 ******************************************************************************/
-void __RME_A7A_Timer_Init(void)
+void __RME_A7A_Timer_Local_Init(void)
 {
-    RME_DBG_S("\r\ntimer init begin");
 #if((RME_A7A_CPU_TYPE==RME_A7A_CPU_CORTEX_A5)|| \
     (RME_A7A_CPU_TYPE==RME_A7A_CPU_CORTEX_A9))
     /* Writing this will also write the counter register as well */
     RME_A7A_PTWD_PTLR=RME_A7A_SYSTICK_VAL;
     /* Clear the interrupt flag */
     RME_A7A_PTWD_PTISR=0;
-     //Start the timer
-    /*RME_A7A_PTWD_PTCTLR=RME_A7A_PTWD_PTCTLR_PRESC(0)|
-                         RME_A7A_PTWD_PTCTLR_IRQEN|
-                         RME_A7A_PTWD_PTCTLR_AUTOREL|
-                         RME_A7A_PTWD_PTCTLR_TIMEN;*/
-//RME_A7A_PTWD_PTLR
-    /* Enable the timer interrupt in the GIC */
-    RME_A7A_GICD_ISENABLER(0)|=1<<29;
+    /* Start the timer */
+    RME_A7A_PTWD_PTCTLR=RME_A7A_PTWD_PTCTLR_PRESC(0)|
+                        RME_A7A_PTWD_PTCTLR_IRQEN|
+                        RME_A7A_PTWD_PTCTLR_AUTOREL|
+                        RME_A7A_PTWD_PTCTLR_TIMEN;
+    /* Enable the timer interrupt in the GIC - this register is banked */
+    RME_A7A_GICD_ISENABLER(0)=1U<<29;
 #else
     #error Cortex-A7/8/15/17 is not supported at the moment.
     Cortex-A7/15/17 use the new generic timer, and Cortex-A8 does not
     have a processor timer due to very early release dates.
 #endif
+}
+/* End Function:__RME_A7A_Timer_Local_Init **********************************/
+
+/* Function:__RME_A7A_Timer_Init *********************************************
+Description : Initialize the timers of the Cortex-A ARMv7 platform. This will
+              only be run by the first CPU, and initializes the global timer
+              as well as the first CPU's private timer.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_A7A_Timer_Init(void)
+{
+    RME_DBG_S("\r\ntimer init begin");
+    __RME_A7A_Timer_Local_Init();
 
     // init global timer here
     // global timer free-running
@@ -368,18 +381,6 @@ void __RME_A7A_SMP_Init(void)
 }
 /* End Function:__RME_A7A_SMP_Init ******************************************/
 
-/* Function:__RME_A7A_SMP_Tick ***********************************************
-Description : Send IPI to all other cores,to run their handler on the time.
-Input       : None.
-Output      : None.
-Return      : None.
-******************************************************************************/
-void __RME_A7A_SMP_Tick(void)
-{
-
-}
-/* End Function:__RME_A7A_SMP_Tick *******************************************/
-
 /* Function:__RME_Lowlvl_Init **********************************************
 Description : Initialize the low-level hardware. This assumes that we are already
               in Supervisor (SVC) mode.
@@ -393,7 +394,7 @@ void __RME_Lowlvl_Init(void)
     RME_A7A_LOW_LEVEL_INIT();
 
     /* Initialize our own CPU-local data structure */
-    _RME_CPU_Local_Init(&RME_A7A_Local,0);
+    _RME_CPU_Local_Init(&RME_A7A_Local[0],0);
 
     /* Initialize the interrupt controller */
     __RME_A7A_Int_Init();
@@ -428,17 +429,27 @@ rme_ptr_t __RME_Pgt_Kom_Init(void)
 /* End Function:__RME_Pgt_Kom_Init ****************************************/
 
 /* Function:__RME_SMP_Low_Level_Init ******************************************
-Description : Low-level initialization for all other cores.
+Description : Low-level initialization for all other cores. The booting processor
+              does not yet wake the other cores, nor create their init threads
+              and endpoints, so this only sets up the CPU-local state. The private
+              timer is left stopped and the core is not marked booted, because a
+              tick would have no thread or endpoint to go to; starting them belongs
+              with the secondary core boot sequence.
 Input       : None.
 Output      : None.
 Return      : None.
 ******************************************************************************/
 rme_ptr_t __RME_SMP_Low_Level_Init(void)
 {
+    rme_ptr_t CPUID;
+
     /* Initialize hardware */
     RME_A7A_SMP_LOW_LEVEL_INIT();
     /* Initialize our own CPU-local variables */
-   // _RME_CPU_Local_Init(&RME_A7A_Local[RME_A7A_CPU_Cnt],RME_A7A_CPU_Cnt);
+    CPUID=__RME_A7A_MPIDR_Get()&0x03U;
+    _RME_CPU_Local_Init(&RME_A7A_Local[CPUID],CPUID);
+    /* Initialize CPU-local interrupt resources */
+    __RME_A7A_Int_Local_Init();
     return 0;
 }
 /* End Function:__RME_SMP_Low_Level_Init *************************************/
@@ -562,7 +573,7 @@ void __RME_Boot(void)
                                  RME_BOOT_INIT_PRC,
                                  Cur_Addr,
                                  0U,
-                                 &RME_A7A_Local)==0);
+                                 &RME_A7A_Local[0])==0);
     Cur_Addr+=RME_KOM_ROUND(RME_THD_SIZE(0U));
     RME_DBG_S("\r\nFinish creating boot-time thread @ ");
     RME_DBG_H(Cur_Addr);
@@ -580,15 +591,19 @@ void __RME_Boot(void)
                                  RME_KOM_FLAG_ALL)==0U);
     
     /* Create the initial kernel endpoint for timer ticks and interrupts */
-    RME_A7A_Local.Sig_Tim=(struct RME_Cap_Sig*)&(RME_A7A_CPT[RME_BOOT_INIT_VCT]);
-    RME_A7A_Local.Sig_Vct=(struct RME_Cap_Sig*)&(RME_A7A_CPT[RME_BOOT_INIT_VCT]);
+    RME_A7A_Local[0].Sig_Tim=(struct RME_Cap_Sig*)&(RME_A7A_CPT[RME_BOOT_INIT_VCT]);
+    RME_A7A_Local[0].Sig_Vct=(struct RME_Cap_Sig*)&(RME_A7A_CPT[RME_BOOT_INIT_VCT]);
     RME_DBG_S("\r\nCreate the initial kernel endpoint for timer ticks and interrupts");
     RME_ASSERT(_RME_Sig_Boot_Crt(RME_A7A_CPT,
                                  RME_BOOT_INIT_CPT,
                                  RME_BOOT_INIT_VCT)==0);
+    RME_A7A_CPU_Boot[0]=1U;
+    
+    /* Start ASIDs from generation 1 so that each core flushes its TLB once */
+    RME_A7A_ASID_Next=RME_POW2(RME_A7A_ASID_BITS);
     
     /* Set page table as current */
-    __RME_Pgt_Set(RME_A7A_Local.Thd_Cur->Sched.Prc->Pgt);
+    __RME_Pgt_Set(RME_A7A_Local[0].Thd_Cur->Sched.Prc->Pgt);
 
     /* Initialize timer and enable interrupts */
     RME_DBG_S("\r\nenable interrupts\r\n");
@@ -662,6 +677,24 @@ void __RME_Svc_Retval_Set(struct RME_Reg_Struct* Reg,rme_ret_t Retval)
 }
 /* End Function:__RME_Set_Syscall_Retval *************************************/
 
+/* Function:__RME_Svc_Pgr_Set *************************************************
+Description : Set the fault information for a pager thread that is woken up
+              by a fault. R0 carries the signal number as usual.
+Input       : rme_ptr_t TID - The thread ID of the faulting thread.
+              struct RME_Exc_Struct* Exc - The fault information.
+Output      : struct RME_Reg_Struct* Reg - The register set of the pager.
+Return      : None.
+******************************************************************************/
+void __RME_Svc_Pgr_Set(struct RME_Reg_Struct* Reg,
+                       rme_ptr_t TID,
+                       struct RME_Exc_Struct* Exc)
+{
+    Reg->R1=TID;
+    Reg->R2=Exc->Cause;
+    Reg->R3=0U;
+}
+/* End Function:__RME_Svc_Pgr_Set ********************************************/
+
 
 
 /* Function:__RME_Thd_Reg_Init ************************************************
@@ -879,11 +912,97 @@ rme_ret_t __RME_Kfn_Handler(struct RME_Cap_Cpt* Cpt,
                                            rme_ptr_t Param1,
                                            rme_ptr_t Param2)
 {
-    /* Currently no kernel function implemented */
+    /* Routing of shared interrupts across cores */
+    if(Func_ID==RME_KFN_INT_GLOBAL_MOD)
+        return __RME_A7A_Int_Global_Mod(Sub_ID,Param1,Param2);
+
+    /* No other kernel function implemented */
     return 0;
 }
 /* End Function:__RME_Kern_Func_Handler **************************************/
 
+/* Function:__RME_A7A_Int_Global_Mod *****************************************
+Description : Consult or modify the distributor's view of a shared peripheral
+              interrupt, which is where it is routed and whether it is enabled,
+              or read how many device interrupts a core has taken. Each core
+              sends what it takes to its own vector endpoint, so routing an
+              interrupt to a core lets the driver follow the core that its
+              thread is pinned on, and the counters tell where the load is.
+              Only cores that have finished booting can be routed to. A shared
+              interrupt is masked each time it is taken, and the driver enables
+              it again through the state setting operation.
+Input       : rme_ptr_t Int_Num - The interrupt number. Unused when reading the
+                                  counters.
+              rme_ptr_t Operation - The operation to conduct.
+              rme_ptr_t Param - The CPUID to route to or to read the counter of,
+                                or the state to set.
+Output      : None.
+Return      : rme_ret_t - If successful, 0 or the desired value; else RME_ERR_KFN_FAIL.
+******************************************************************************/
+rme_ret_t __RME_A7A_Int_Global_Mod(rme_ptr_t Int_Num,
+                                   rme_ptr_t Operation,
+                                   rme_ptr_t Param)
+{
+    rme_ptr_t Lines;
+    rme_ptr_t Target;
+
+    if(Operation==RME_A7A_KFN_INT_GLOBAL_MOD_CNT_GET)
+    {
+        if(Param>=RME_A7A_CPU_NUM_MAX)
+            return RME_ERR_KFN_FAIL;
+        /* Drop the top bit so that a wrapped counter never looks like an error */
+        return (rme_ret_t)(RME_A7A_Int_Cnt[Param]&(RME_MASK_FULL>>1));
+    }
+
+    /* Only shared peripheral interrupts are routed; the rest are per-core */
+    Lines=((RME_A7A_GICD_TYPER&0x1FU)+1U)*32U;
+    if((Int_Num<32U)||(Int_Num>=Lines))
+        return RME_ERR_KFN_FAIL;
+
+    switch(Operation)
+    {
+        case RME_A7A_KFN_INT_GLOBAL_MOD_AFF_GET:
+        {
+            /* If it is routed to more than one core, report the highest one */
+            Target=RME_A7A_GICD_ITARGETSR_B(Int_Num);
+            if(Target==0U)
+                return RME_ERR_KFN_FAIL;
+            return (rme_ret_t)RME_MSB_GET(Target);
+        }
+        case RME_A7A_KFN_INT_GLOBAL_MOD_AFF_SET:
+        {
+            /* A core that has not booted has no vector endpoint to send to */
+            if(Param>=RME_A7A_CPU_NUM_MAX)
+                return RME_ERR_KFN_FAIL;
+            if(RME_A7A_CPU_Boot[Param]==0U)
+                return RME_ERR_KFN_FAIL;
+            /* The target registers are byte accessible, so no other
+             * interrupt's routing is touched */
+            RME_A7A_GICD_ITARGETSR_B(Int_Num)=(rme_u8_t)RME_POW2(Param);
+            return 0;
+        }
+        case RME_A7A_KFN_INT_GLOBAL_MOD_STATE_GET:
+        {
+            if((RME_A7A_GICD_ISENABLER(Int_Num>>5)&RME_POW2(Int_Num&0x1FU))==0U)
+                return 0;
+            else
+                return 1;
+        }
+        case RME_A7A_KFN_INT_GLOBAL_MOD_STATE_SET:
+        {
+            if(Param==0U)
+                RME_A7A_GICD_ICENABLER(Int_Num>>5)=RME_POW2(Int_Num&0x1FU);
+            else
+                RME_A7A_GICD_ISENABLER(Int_Num>>5)=RME_POW2(Int_Num&0x1FU);
+            return 0;
+        }
+        default:break;
+    }
+
+    return RME_ERR_KFN_FAIL;
+}
+/* End Function:__RME_A7A_Int_Global_Mod ************************************/
+
 /* Function:__RME_A7A_Undefined_Handler **************************************
 Description : The undefined instruction vector handler of RME.
 Input       : struct RME_Reg_Struct* Reg - The register set when entering the handler.
@@ -958,6 +1077,7 @@ void __RME_A7A_IRQ_Handler(struct RME_Reg_Struct* Reg)
 {
     rme_ptr_t Int_ID;
     rme_ptr_t CPUID;
+    struct RME_CPU_Local* Local;
 
     /* What interrupt is this? */
     Int_ID=RME_A7A_GICC_IAR;
@@ -971,7 +1091,7 @@ void __RME_A7A_IRQ_Handler(struct RME_Reg_Struct* Reg)
     RME_ASSERT(Int_ID!=1022);
     if(Int_ID==1023)
         return;
-    /* Only the booting processor will receive timer interrupts */
+    /* Every processor receives the interrupts of its own private timer */
 #if((RME_A7A_CPU_TYPE==RME_A7A_CPU_CORTEX_A5)|| \
     (RME_A7A_CPU_TYPE==RME_A7A_CPU_CORTEX_A9))
     /* Is is an timer interrupt? (we know that it is at 29) */
@@ -979,11 +1099,13 @@ void __RME_A7A_IRQ_Handler(struct RME_Reg_Struct* Reg)
     {
         /* Clear the interrupt flag */
         RME_A7A_PTWD_PTISR=0;
-        //_RME_Tick_Handler(Reg);
-        _RME_Tim_Handler(Reg,1);
-        /* Send interrupt to all other processors to notify them about this */
         /* EOI the interrupt */
         RME_A7A_GICC_EOIR=Int_ID;
+        /* Only the booting processor keeps the time */
+        if(RME_CPU_LOCAL()->CPUID==0U)
+            RME_A7A_Timestamp++;
+        /* Time slices are enforced by each processor locally */
+        _RME_Tim_Handler(Reg,1U);
         return;
     }
 #else
@@ -993,18 +1115,7 @@ void __RME_A7A_IRQ_Handler(struct RME_Reg_Struct* Reg)
 #else
 
 #endif
-    /* Is this a coprocessor timer interrupt? (We use interrupt number 0 for these) */
-    if(Int_ID==0)
-    {
-        /* This must have originated from interface 0 */
-        RME_ASSERT(CPUID==0);
-        //_RME_Tick_SMP_Handler(Reg);
-        /* EOI the interrupt */
-        RME_A7A_GICC_EOIR=Int_ID;
-        return;
-    }
-
-    /* Is this an other IPI? (All the rest of the SGIs are these) */
+    /* Is this an IPI? (All the SGIs are these) */
     if(Int_ID<16)
     {
         _RME_A7A_SGI_Handler(Reg,CPUID,Int_ID);
@@ -1016,6 +1127,18 @@ void __RME_A7A_IRQ_Handler(struct RME_Reg_Struct* Reg)
     /* Is this an casual interrupt? */
     RME_ASSERT(CPUID==0);
 
+    /* Send it to the vector endpoint of the core that the distributor routed
+     * it to. A shared interrupt is masked until the driver has serviced it and
+     * enables it again, or a level-triggered device would fire again as soon
+     * as it is ended */
+    Local=RME_CPU_LOCAL();
+    RME_A7A_Int_Cnt[Local->CPUID]++;
+    if(Int_ID>=32U)
+        RME_A7A_GICD_ICENABLER(Int_ID>>5)=RME_POW2(Int_ID&0x1FU);
+    RME_A7A_GICC_EOIR=Int_ID;
+    _RME_Kern_Snd(Local->Sig_Vct,1U);
+    /* Pick the highest priority thread after we did all sends */
+    _RME_Kern_High(Reg,Local);
 }
 /* End Function:__RME_A7A_IRQ_Handler ***************************************/
 
@@ -1056,8 +1179,44 @@ void __RME_A7A_Generic_Handler(struct RME_Reg_Struct* Reg, rme_ptr_t Int_Num)
 }
 /* End Function:__RME_A7A_Generic_Handler ***********************************/
 
+/* Function:___RME_A7A_ASID_Get *********************************************
+Description : Get an ASID for the page table that is about to be switched to.
+              A table keeps its ASID as long as its generation is current; once
+              the 8-bit space is used up, the counter rolls over into the next
+              generation, and every table picks a fresh ASID the next time it
+              runs. The generation could only wrap after 2^24 rollovers, which
+              is ignored here.
+Input       : struct RME_Cap_Pgt* Pgt - The top-level page table.
+Output      : None.
+Return      : rme_ptr_t - The ASID, with the generation in the upper bits.
+******************************************************************************/
+rme_ptr_t ___RME_A7A_ASID_Get(struct RME_Cap_Pgt* Pgt)
+{
+    rme_ptr_t ASID;
+
+    ASID=Pgt->ASID;
+    if((ASID!=0U)&&(RME_A7A_ASID_GEN(ASID)==RME_A7A_ASID_GEN(RME_A7A_ASID_Next)))
+        return ASID;
+
+    /* Skip ASID 0 of each generation - it is the one used during switching */
+    do
+    {
+        ASID=RME_FETCH_ADD(&RME_A7A_ASID_Next,1)+1U;
+    }
+    while((ASID&RME_A7A_ASID_MASK)==0U);
+
+    Pgt->ASID=ASID;
+    return ASID;
+}
+/* End Function:___RME_A7A_ASID_Get ****************************************/
+
 /* Function:__RME_Pgt_Set ***************************************************
-Description : Set the processor's page table.
+Description : Set the processor's page table. User mappings are non-global and
+              tagged with the ASID of the table, so there is no need to flush
+              the TLB on every switch. A core only invalidates its local TLB
+              the first time it runs a table from a new ASID generation,
+              because entries of the old one may still carry the ASIDs that
+              are being handed out again.
 Input       : rme_ptr_t Pgt - The virtual address of the page table.
 Output      : None.
 Return      : None.
@@ -1065,6 +1224,9 @@ Return      : None.
 void __RME_Pgt_Set(struct RME_Cap_Pgt* Pgt)
 {
     rme_ptr_t* Ptr;
+    rme_ptr_t ASID;
+    rme_ptr_t CPUID;
+    rme_ptr_t Flush;
 
     /* Get the actual table */
     Ptr=RME_CAP_GETOBJ(Pgt,rme_ptr_t*);
@@ -1072,8 +1234,17 @@ void __RME_Pgt_Set(struct RME_Cap_Pgt* Pgt)
     /*RME_DBG_S("\r\n__RME_Pgt_Set table kernel VA @ ");
     RME_DBG_H(Ptr);*/
 
-    __RME_A7A_TTBR0_Set(RME_A7A_VA2PA(Ptr)|0x4A);
-    __RME_A7A_TLBIALL_Set(0);
+    ASID=___RME_A7A_ASID_Get(Pgt);
+    CPUID=RME_CPU_LOCAL()->CPUID;
+    if(RME_A7A_ASID_Flush[CPUID]!=RME_A7A_ASID_GEN(ASID))
+    {
+        RME_A7A_ASID_Flush[CPUID]=RME_A7A_ASID_GEN(ASID);
+        Flush=1U;
+    }
+    else
+        Flush=0U;
+
+    __RME_A7A_ASID_Switch(RME_A7A_VA2PA(Ptr)|0x4A,ASID&RME_A7A_ASID_MASK,Flush);
 }
 /* End Function:__RME_Pgt_Set **********************************************/
 
@@ -1154,21 +1325,28 @@ rme_ptr_t __RME_Pgt_Init(struct RME_Cap_Pgt* Pgt_Op)
     /* Get the actual table */
     Ptr=RME_CAP_GETOBJ(Pgt_Op,rme_ptr_t*);  //*((volatile rme_ptr_t*)0x12345678)
 
-    /* Is this a first-level or a second-level? */
+    /* Is this a first-level or a second-level? The clearing is skipped if the
+     * table was zeroed in advance */
     if((Pgt_Op->Base&RME_PGT_TOP)!=0)
     {
         /* First-level - clean up the first half and map in the second half as kernel entries */
-        for(Count=0;Count<2048;Count++)
-            Ptr[Count]=0;
+        if(RME_KOT_CLEAN_CHK(Ptr,4096U*RME_WORD_BYTE)==0U)
+        {
+            for(Count=0;Count<2048;Count++)
+                Ptr[Count]=0;
+        }
 
-        for(;Count<4096;Count++)
+        for(Count=2048;Count<4096;Count++)
             Ptr[Count]=(&__RME_A7A_Kern_Pgt)[Count];
     }
     else
     {
         /* Second-level - just clean it up to all zeros */
-        for(Count=0;Count<256;Count++)
-            Ptr[Count]=0;
+        if(RME_KOT_CLEAN_CHK(Ptr,256U*RME_WORD_BYTE)==0U)
+        {
+            for(Count=0;Count<256;Count++)
+                Ptr[Count]=0;
+        }
     }
 
     return 0;
@@ -1300,6 +1478,9 @@ rme_ptr_t __RME_Pgt_Page_Unmap(struct RME_Cap_Pgt* Pgt_Op, rme_ptr_t Pos)
     if(RME_COMP_SWAP(&(Table[Pos]),Temp,0)==0)
         return RME_ERR_HAL_FAIL;
 
+    /* Make sure no core can still access the page */
+    __RME_A7A_TLB_Shootdown();
+
     return 0;
 }
 /* End Function:__RME_Pgt_Page_Unmap ***************************************/
@@ -1346,16 +1527,46 @@ rme_ptr_t __RME_Pgt_Pgdir_Map(struct RME_Cap_Pgt* Pgt_Parent, rme_ptr_t Pos,
 
 /* Function:__RME_Pgt_Pgdir_Unmap *******************************************
 Description : Unmap a page directory from the page table.
-Input       : struct RME_Cap_Pgt* Pgt_Op - The page table to operate on.
+Input       : struct RME_Cap_Pgt* Pgt_Parent - The parent page table to unmap from.
               rme_ptr_t Pos - The position in the page table.
+              struct RME_Cap_Pgt* Pgt_Child - The child page table to unmap.
 Output      : None.
-Return      : rme_ptr_t - If successful, 0; else RME_ERR_HAL_FAIL.
+Return      : rme_ret_t - If successful, 0; else RME_ERR_HAL_FAIL.
 ******************************************************************************/
 rme_ret_t __RME_Pgt_Pgdir_Unmap(struct RME_Cap_Pgt* Pgt_Parent,rme_ptr_t Pos,
                                 struct RME_Cap_Pgt* Pgt_Child)
 {
+    rme_ptr_t* Parent_Table;
+    rme_ptr_t* Child_Table;
+    rme_ptr_t Temp;
 
-   return 0;
+    /* Are we trying to unmap the kernel space on the top level? */
+    if(((Pgt_Parent->Base&RME_PGT_TOP)!=0)&&(Pos>=2048))
+        return RME_ERR_HAL_FAIL;
+
+    /* Get the table */
+    Parent_Table=RME_CAP_GETOBJ(Pgt_Parent,rme_ptr_t*);
+    Child_Table=RME_CAP_GETOBJ(Pgt_Child,rme_ptr_t*);
+
+    /* Make sure that there is something */
+    Temp=Parent_Table[Pos];
+    if(Temp==0)
+        return RME_ERR_HAL_FAIL;
+
+    /* Is this the child page directory? We cannot unmap pages like this */
+    if((Temp&RME_A7A_MMU_1M_PGDIR_PRESENT)==0)
+        return RME_ERR_HAL_FAIL;
+    if(RME_A7A_MMU_1M_PGT_ADDR(Temp)!=RME_A7A_MMU_1M_PGT_ADDR(RME_A7A_VA2PA(Child_Table)))
+        return RME_ERR_HAL_FAIL;
+
+    /* Try to unmap it. Use CAS just in case */
+    if(RME_COMP_SWAP(&(Parent_Table[Pos]),Temp,0)==0)
+        return RME_ERR_HAL_FAIL;
+
+    /* Make sure no core can still access the directory */
+    __RME_A7A_TLB_Shootdown();
+
+    return 0;
 }
 /* End Function:__RME_Pgt_Pgdir_Unmap **************************************/
 
@@ -91,6 +91,10 @@ The ARM Cortex-A also include various FPU implementations.
     /* Read acquire/Write release for Cortex-A (ARMv7) */
     .global             __RME_A7A_Read_Acquire
     .global             __RME_A7A_Write_Release
+    /* TLB shootdown for Cortex-A (ARMv7) */
+    .global             __RME_A7A_TLB_Shootdown
+    /* Address space switching with ASIDs */
+    .global             __RME_A7A_ASID_Switch
     /* Get the MSB in a word */
     .global             __RME_A7A_MSB_Get
     /* Kernel main function wrapper */
@@ -360,8 +364,6 @@ The ARM Cortex-A also include various FPU implementations.
     .global             _RME_Tim_Handler
     /* The entry of SMP after they have finished their initialization */
     .global             __RME_SMP_Low_Level_Init
-    /* All other processor's timer interrupt handler */
-    .global             __RME_A7A_SMP_Tick
     /* Memory layout information - This is the actual page table mapping */
     .global             RME_A7A_Mem_Info
 /* End Import ****************************************************************/
@@ -1363,6 +1365,51 @@ __RME_A7A_Write_Release:
     BX                  LR
 /* End Function:__RME_A7A_Write_Release *************************************/
 
+/* Function:__RME_A7A_TLB_Shootdown *******************************************
+Description : Invalidate the TLBs of all cores in the inner shareable domain,
+              and wait until this is done. The multiprocessing extensions
+              broadcast the invalidation in hardware, so no IPI is needed. The
+              first DSB makes sure that the walkers see the removed entry.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+__RME_A7A_TLB_Shootdown:
+    DSB
+    MOV                 R0,#0
+    MCR                 P15,0,R0,C8,C3,0
+    DSB
+    ISB
+    BX                  LR
+/* End Function:__RME_A7A_TLB_Shootdown **************************************/
+
+/* Function:__RME_A7A_ASID_Switch ********************************************
+Description : Switch to another page table and ASID. CONTEXTIDR goes through
+              the reserved ASID 0 while TTBR0 changes, so that no walk can ever
+              combine the new table with the old ASID or vice versa. If asked,
+              the local TLB is invalidated before the new ASID takes effect.
+Input       : R0 - The new TTBR0 value.
+              R1 - The new ASID.
+              R2 - Whether to invalidate the local TLB.
+Output      : None.
+Return      : None.
+******************************************************************************/
+__RME_A7A_ASID_Switch:
+    MOV                 R3,#0
+    MCR                 P15,0,R3,C13,C0,1
+    ISB
+    MCR                 P15,0,R0,C2,C0,0
+    ISB
+    CMP                 R2,#0
+    BEQ                 asid_noflush
+    MCR                 P15,0,R3,C8,C7,0
+    DSB
+asid_noflush:
+    MCR                 P15,0,R1,C13,C0,1
+    ISB
+    BX                  LR
+/* End Function:__RME_A7A_ASID_Switch ***************************************/
+
 /* Function:__RME_Int_Disable *************************************************
 Description : The function for disabling all interrupts.
 Input       : None.
@@ -176,7 +176,10 @@ void __RME_A7M_Exc_Handler(struct RME_Reg_Struct* Reg)
                 _RME_Thd_Fatal(Reg);
             }
             else
+            {
+                RME_A7M_PGT_MPU(RME_CAP_GETOBJ(Pgt,rme_ptr_t))->Miss++;
                 __RME_Pgt_Set(Pgt);
+            }
         }
     }
     /* This is an instruction access violation. We need to know where that instruction is.
@@ -227,7 +230,10 @@ void __RME_A7M_Exc_Handler(struct RME_Reg_Struct* Reg)
                         _RME_Thd_Fatal(Reg);
                     }
                     else
+                    {
+                        RME_A7M_PGT_MPU(RME_CAP_GETOBJ(Pgt,rme_ptr_t))->Miss++;
                         __RME_Pgt_Set(Pgt);
+                    }
                 }
             }
         }
@@ -287,10 +293,8 @@ void __RME_A7M_Flag_Fast(rme_ptr_t Base,
 {
     volatile struct __RME_RVM_Flag* Set;
     
-    /* Choose a data structure that is not locked at the moment */
-    Set=RME_RVM_FLAG_SET(Base,Size,0U);
-    if(Set->Lock!=0U)
-        Set=RME_RVM_FLAG_SET(Base,Size,1U);
+    /* Write to the buffer that the consumer is not draining at the moment */
+    Set=RME_RVM_FLAG_SET(Base,Size,RME_RVM_FLAG_CUR(Base)&1U);
     
     /* Set the flags for this interrupt source */
     Set->Fast|=Flag;
@@ -299,6 +303,7 @@ void __RME_A7M_Flag_Fast(rme_ptr_t Base,
 
 /* Function:__RME_A7M_Flag_Slow ***********************************************
 Description : Set a slow flag in a flag set. Works for both vectors and events.
+              The size of the flagset decides whether there is a summary level.
 Input       : rme_ptr_t Base - The base address of the flagset.
               rme_ptr_t Size - The size of the flagset.
               rme_ptr_t Pos - The position in the flagset to set.
@@ -310,18 +315,337 @@ void __RME_A7M_Flag_Slow(rme_ptr_t Base,
                          rme_ptr_t Pos)
 {
     volatile struct __RME_RVM_Flag* Set;
+    rme_ptr_t Word;
+    rme_ptr_t Sum;
     
-    /* Choose a data structure that is not locked at the moment */
-    Set=RME_RVM_FLAG_SET(Base,Size,0U);
-    if(Set->Lock!=0U)
-        Set=RME_RVM_FLAG_SET(Base,Size,1U);
+    /* Write to the buffer that the consumer is not draining at the moment */
+    Set=RME_RVM_FLAG_SET(Base,Size,RME_RVM_FLAG_CUR(Base)&1U);
     
-    /* Set the flags for this interrupt source */
-    Set->Group|=RME_POW2(Pos>>RME_WORD_ORDER);
-    RME_BITMAP_SET(Set->Flag,Pos);
+    /* Set the flag, and mark the path down to it in the summary levels */
+    Word=Pos>>RME_WORD_ORDER;
+    Sum=RME_RVM_FLAG_SUM(Size);
+    if(Sum==0U)
+        Set->Group|=RME_POW2(Word);
+    else
+    {
+        Set->Group|=RME_POW2(Word>>RME_WORD_ORDER);
+        RME_BITMAP_SET(Set->Data,Word);
+    }
+    RME_BITMAP_SET(&(Set->Data[Sum]),Pos);
 }
 /* End Function:__RME_A7M_Flag_Slow ******************************************/
 
+#if(RME_A7M_VCT_COAL_ENABLE!=0U)
+/* Function:__RME_A7M_Vct_Coal ************************************************
+Description : Apply the coalescing policy of a vector on a hit. Each hit is
+              counted; a signal is let through once per the policy's number of
+              hits, and no sooner than the policy's window after the last one.
+              When the window holds a signal back, the vector is masked and
+              the timer handler sends that signal once the window ends.
+Input       : rme_ptr_t Vct_Num - The vector number.
+Output      : None.
+Return      : rme_ptr_t - If the signal should be sent now, 1; else 0.
+******************************************************************************/
+rme_ptr_t __RME_A7M_Vct_Coal(rme_ptr_t Vct_Num)
+{
+    struct __RME_A7M_Vct_Coal* Coal;
+    
+    Coal=&(RME_A7M_Vct_Coal[Vct_Num]);
+    
+    /* Saturate the count so that the acknowledgement can never look like an error */
+    if(Coal->Hit<(RME_MASK_FULL>>1))
+        Coal->Hit++;
+    
+    if(Coal->Num==0U)
+        return 1U;
+    
+    Coal->Pend++;
+    if(Coal->Pend<Coal->Num)
+        return 0U;
+    
+    if((RME_A7M_Timestamp-Coal->Last)<Coal->Window)
+    {
+        RME_A7M_NVIC_ICER(Vct_Num)=RME_POW2(Vct_Num&0x1FU);
+        RME_BITMAP_SET(RME_A7M_Vct_Defer,Vct_Num);
+        return 0U;
+    }
+    
+    Coal->Pend=0U;
+    Coal->Last=RME_A7M_Timestamp;
+    if(Coal->Mask!=0U)
+        RME_A7M_NVIC_ICER(Vct_Num)=RME_POW2(Vct_Num&0x1FU);
+    
+    return 1U;
+}
+/* End Function:__RME_A7M_Vct_Coal *******************************************/
+
+/* Function:__RME_A7M_Vct_Coal_Tim ********************************************
+Description : Send the signals that the coalescing windows held back, for the
+              windows that have ended. Vectors bound to their own endpoints
+              stay masked until the driver enables them again; the others are
+              enabled again unless the policy masks them until acknowledged.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_A7M_Vct_Coal_Tim(void)
+{
+    rme_ptr_t Word;
+    rme_ptr_t Bits;
+    rme_ptr_t Vct_Num;
+    struct __RME_A7M_Vct_Coal* Coal;
+    
+    for(Word=0U;Word<(sizeof(RME_A7M_Vct_Defer)/sizeof(rme_ptr_t));Word++)
+    {
+        Bits=RME_A7M_Vct_Defer[Word];
+        while(Bits!=0U)
+        {
+            Vct_Num=RME_MSB_GET(Bits);
+            Bits&=~RME_POW2(Vct_Num);
+            Vct_Num+=Word<<RME_WORD_ORDER;
+            
+            Coal=&(RME_A7M_Vct_Coal[Vct_Num]);
+            if((RME_A7M_Timestamp-Coal->Last)<Coal->Window)
+                continue;
+            
+            RME_BITMAP_CLR(RME_A7M_Vct_Defer,Vct_Num);
+            Coal->Pend=0U;
+            Coal->Last=RME_A7M_Timestamp;
+            
+            if(RME_A7M_Vct_Sig[Vct_Num]!=RME_NULL)
+                _RME_Kern_Snd(RME_A7M_Vct_Sig[Vct_Num],1U);
+            else
+            {
+                _RME_Kern_Snd(RME_A7M_Local.Sig_Vct,1U);
+                if(Coal->Mask==0U)
+                    RME_A7M_NVIC_ISER(Vct_Num)=RME_POW2(Vct_Num&0x1FU);
+            }
+        }
+    }
+}
+/* End Function:__RME_A7M_Vct_Coal_Tim ***************************************/
+#endif
+
+#if((RME_A7M_VCT_BYP_ENABLE!=0U)&&(RME_PGT_RAW_ENABLE==0U))
+/* Function:__RME_A7M_Vct_Byp *************************************************
+Description : Run the bypass top-half of a vector on a hit. The register
+              operations run in order, each being one or two word accesses and
+              none of them looping, so the top-half takes a bounded time. Each
+              hit is counted; a signal is let through once per the top-half's
+              number of hits, or at once when a test does not match.
+Input       : rme_ptr_t Vct_Num - The vector number.
+Output      : None.
+Return      : rme_ptr_t - If the signal should be sent, 1; else 0.
+******************************************************************************/
+rme_ptr_t __RME_A7M_Vct_Byp(rme_ptr_t Vct_Num)
+{
+    struct __RME_A7M_Vct_Byp_Slot* Slot;
+    struct RME_A7M_Vct_Byp_Op* Op;
+    rme_ptr_t Count;
+    rme_ptr_t Signal;
+    
+    Slot=&(RME_A7M_Vct_Byp[RME_A7M_Vct_Byp_Map[Vct_Num]-1U]);
+    Signal=0U;
+    
+    for(Count=0U;Count<Slot->Byp.Op_Num;Count++)
+    {
+        Op=&(Slot->Byp.Op[Count]);
+        switch(Op->Type)
+        {
+            case RME_A7M_VCT_BYP_OP_WRITE:
+            {
+                RME_A7M_REG(Op->Addr)=Op->Value;
+                break;
+            }
+            case RME_A7M_VCT_BYP_OP_MODIFY:
+            {
+                RME_A7M_REG(Op->Addr)=(RME_A7M_REG(Op->Addr)&(~Op->Mask))|(Op->Value&Op->Mask);
+                break;
+            }
+            /* Write back the bits that are set, for write-one-to-clear registers */
+            case RME_A7M_VCT_BYP_OP_CLEAR:
+            {
+                RME_A7M_REG(Op->Addr)=RME_A7M_REG(Op->Addr)&Op->Mask;
+                break;
+            }
+            /* The only other type that registration lets in is the test */
+            default:
+            {
+                if((RME_A7M_REG(Op->Addr)&Op->Mask)!=Op->Value)
+                    Signal=1U;
+                break;
+            }
+        }
+    }
+    
+    /* Saturate the count so that the acknowledgement can never look like an error */
+    if(Slot->Hit<(RME_MASK_FULL>>1))
+        Slot->Hit++;
+    
+    if(Slot->Byp.Num!=0U)
+    {
+        Slot->Pend++;
+        if(Slot->Pend>=Slot->Byp.Num)
+            Signal=1U;
+    }
+    
+    if(Signal!=0U)
+        Slot->Pend=0U;
+    
+    return Signal;
+}
+/* End Function:__RME_A7M_Vct_Byp ********************************************/
+
+/* Function:__RME_A7M_Vct_Byp_Check *******************************************
+Description : Check that a word is accessible to the caller with the flags
+              given, so that a bypass top-half never reaches memory that its
+              driver could not reach itself.
+Input       : struct RME_Cap_Pgt* Pgt - The top-level page table of the caller.
+              rme_ptr_t Addr - The address of the word.
+              rme_ptr_t Flag - The page flags that are needed.
+Output      : None.
+Return      : rme_ret_t - If accessible, 0; else RME_ERR_KFN_FAIL.
+******************************************************************************/
+rme_ret_t __RME_A7M_Vct_Byp_Check(struct RME_Cap_Pgt* Pgt,
+                                  rme_ptr_t Addr,
+                                  rme_ptr_t Flag)
+{
+    rme_ptr_t Page_Flag;
+    
+    /* The kernel could reach the system region even where the user cannot */
+    if(((Addr&0x3U)!=0U)||(Addr>=RME_A7M_VCT_BYP_SYS_BASE))
+        return RME_ERR_KFN_FAIL;
+    
+    if(__RME_Pgt_Walk(Pgt,Addr,0U,0U,0U,0U,0U,&Page_Flag)!=0)
+        return RME_ERR_KFN_FAIL;
+    
+    if((Page_Flag&Flag)!=Flag)
+        return RME_ERR_KFN_FAIL;
+    
+    return 0;
+}
+/* End Function:__RME_A7M_Vct_Byp_Check **************************************/
+
+/* Function:__RME_A7M_Vct_Byp_Set *********************************************
+Description : Install, replace or remove the bypass top-half of a vector. The
+              top-half is copied from the caller's memory, and each register it
+              touches must be readable and writable by the caller at this time.
+Input       : rme_ptr_t Vct_Num - The vector number.
+              rme_ptr_t Addr - The address of the top-half in the caller's
+                               memory; 0 removes the top-half.
+Output      : None.
+Return      : rme_ret_t - If successful, 0; else RME_ERR_KFN_FAIL.
+******************************************************************************/
+rme_ret_t __RME_A7M_Vct_Byp_Set(rme_ptr_t Vct_Num,
+                                rme_ptr_t Addr)
+{
+    struct RME_Cap_Pgt* Pgt;
+    struct RME_A7M_Vct_Byp Byp;
+    struct __RME_A7M_Vct_Byp_Slot* Slot;
+    rme_ptr_t Count;
+    rme_ptr_t Slot_Num;
+    
+    Slot_Num=RME_A7M_Vct_Byp_Map[Vct_Num];
+    
+    if(Addr==0U)
+    {
+        if(Slot_Num==0U)
+            return RME_ERR_KFN_FAIL;
+        
+        RME_A7M_Vct_Byp_Map[Vct_Num]=0U;
+        RME_A7M_Vct_Byp[Slot_Num-1U].Vct=0U;
+        return 0;
+    }
+    
+    /* Copy the top-half in before checking it, so it cannot change under us */
+    Pgt=_RME_Thd_Pgt(RME_A7M_Local.Thd_Cur);
+    for(Count=0U;Count<sizeof(struct RME_A7M_Vct_Byp);Count+=RME_WORD_BYTE)
+    {
+        if(__RME_A7M_Vct_Byp_Check(Pgt,Addr+Count,RME_PGT_READ)!=0)
+            return RME_ERR_KFN_FAIL;
+    }
+    _RME_Memcpy(&Byp,(void*)Addr,sizeof(struct RME_A7M_Vct_Byp));
+    
+    if(Byp.Op_Num>RME_A7M_VCT_BYP_OP_NUM)
+        return RME_ERR_KFN_FAIL;
+    
+    for(Count=0U;Count<Byp.Op_Num;Count++)
+    {
+        if(Byp.Op[Count].Type>RME_A7M_VCT_BYP_OP_TEST)
+            return RME_ERR_KFN_FAIL;
+        if(__RME_A7M_Vct_Byp_Check(Pgt,Byp.Op[Count].Addr,RME_PGT_READ|RME_PGT_WRITE)!=0)
+            return RME_ERR_KFN_FAIL;
+    }
+    
+    /* Reuse the slot of the vector if there is one, or find a free one */
+    if(Slot_Num==0U)
+    {
+        for(Count=0U;Count<RME_A7M_VCT_BYP_NUM;Count++)
+        {
+            if(RME_A7M_Vct_Byp[Count].Vct==0U)
+                break;
+        }
+        
+        if(Count>=RME_A7M_VCT_BYP_NUM)
+            return RME_ERR_KFN_FAIL;
+        
+        Slot_Num=Count+1U;
+    }
+    
+    /* Take the vector off the top-half while copying, so a hit never sees half of it */
+    RME_A7M_Vct_Byp_Map[Vct_Num]=0U;
+    Slot=&(RME_A7M_Vct_Byp[Slot_Num-1U]);
+    Slot->Vct=Vct_Num+1U;
+    Slot->Hit=0U;
+    Slot->Pend=0U;
+    _RME_Memcpy(&(Slot->Byp),&Byp,sizeof(struct RME_A7M_Vct_Byp));
+    RME_A7M_Vct_Byp_Map[Vct_Num]=(rme_u8_t)Slot_Num;
+    
+    return 0;
+}
+/* End Function:__RME_A7M_Vct_Byp_Set ****************************************/
+
+/* Function:__RME_A7M_Vct_Byp_Drop ********************************************
+Description : Remove the bypass top-halves that touch any register in a range
+              that is being unmapped or deleted, so that the kernel never
+              reaches memory that the driver no longer has. The top-halves of
+              other processes that touch the same range are removed as well,
+              and their drivers need to register them again.
+Input       : rme_ptr_t Start - The first address of the range.
+              rme_ptr_t Order - The size order of the range.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_A7M_Vct_Byp_Drop(rme_ptr_t Start,
+                            rme_ptr_t Order)
+{
+    struct __RME_A7M_Vct_Byp_Slot* Slot;
+    rme_ptr_t Count;
+    rme_ptr_t Op;
+    
+    for(Count=0U;Count<RME_A7M_VCT_BYP_NUM;Count++)
+    {
+        Slot=&(RME_A7M_Vct_Byp[Count]);
+        if(Slot->Vct==0U)
+            continue;
+        
+        for(Op=0U;Op<Slot->Byp.Op_Num;Op++)
+        {
+            if((Order>=RME_WORD_BIT)||(((Slot->Byp.Op[Op].Addr-Start)>>Order)==0U))
+                break;
+        }
+        
+        /* Take the vector off first, so that a hit never runs a dropped top-half */
+        if(Op<Slot->Byp.Op_Num)
+        {
+            RME_A7M_Vct_Byp_Map[Slot->Vct-1U]=0U;
+            Slot->Vct=0U;
+        }
+    }
+}
+/* End Function:__RME_A7M_Vct_Byp_Drop ***************************************/
+#endif
+
 /* Function:__RME_A7M_Vct_Handler *********************************************
 Description : The generic interrupt handler of RME for ARMv7-M.
 Input       : struct RME_Reg_Struct* Reg - The register set.
@@ -333,6 +657,40 @@ Return      : None.
 void __RME_A7M_Vct_Handler(struct RME_Reg_Struct* Reg,
                            rme_ptr_t Vct_Num)
 {
+    struct RME_Cap_Sig* Sig;
+    
+#if((RME_A7M_VCT_BYP_ENABLE!=0U)&&(RME_PGT_RAW_ENABLE==0U))
+    /* A bypass top-half that has handled the hit on its own needs no signal */
+    if(RME_A7M_Vct_Byp_Map[Vct_Num]!=0U)
+    {
+        if(__RME_A7M_Vct_Byp(Vct_Num)==0U)
+        {
+            RME_A7M_EXC_RET_FIX(Reg);
+            return;
+        }
+    }
+    
+#endif
+    /* If the vector has its own endpoint, wake the driver in one hop. The vector
+     * is masked until the driver has serviced it and enables it again */
+    Sig=RME_A7M_Vct_Sig[Vct_Num];
+    if(Sig!=RME_NULL)
+    {
+#if(RME_A7M_VCT_COAL_ENABLE!=0U)
+        /* Hits that the coalescing policy holds back are only counted */
+        if(__RME_A7M_Vct_Coal(Vct_Num)!=0U)
+        {
+#endif
+            RME_A7M_NVIC_ICER(Vct_Num)=RME_POW2(Vct_Num&0x1FU);
+            _RME_Kern_Snd(Sig,1U);
+            _RME_Kern_High(Reg,&RME_A7M_Local);
+#if(RME_A7M_VCT_COAL_ENABLE!=0U)
+        }
+#endif
+        RME_A7M_EXC_RET_FIX(Reg);
+        return;
+    }
+    
 #if(RME_RVM_GEN_ENABLE!=0U)
     /* If the user wants to bypass, we skip the flag marshalling & sending process */
     if(RME_Boot_Vct_Handler(Reg,Vct_Num)!=0U)
@@ -340,10 +698,18 @@ void __RME_A7M_Vct_Handler(struct RME_Reg_Struct* Reg,
         /* Set the vector flag */
         __RME_A7M_Flag_Slow(RME_RVM_PHYS_VCTF_BASE,RME_RVM_PHYS_VCTF_SIZE,Vct_Num);
 #endif
-        /* Send to the kernel endpoint */
-        _RME_Kern_Snd(RME_A7M_Local.Sig_Vct,1U);
-        /* Pick the highest priority thread after we did all sends */
-        _RME_Kern_High(Reg,&RME_A7M_Local);
+#if(RME_A7M_VCT_COAL_ENABLE!=0U)
+        /* Hits that the coalescing policy holds back are left in the flag set */
+        if(__RME_A7M_Vct_Coal(Vct_Num)!=0U)
+        {
+#endif
+            /* Send to the kernel endpoint */
+            _RME_Kern_Snd(RME_A7M_Local.Sig_Vct,1U);
+            /* Pick the highest priority thread after we did all sends */
+            _RME_Kern_High(Reg,&RME_A7M_Local);
+#if(RME_A7M_VCT_COAL_ENABLE!=0U)
+        }
+#endif
 #if(RME_RVM_GEN_ENABLE!=0U)
     }
 #endif
@@ -366,6 +732,11 @@ void __RME_A7M_Tim_Handler(struct RME_Reg_Struct* Reg)
 #if(RME_RVM_GEN_ENABLE!=0U)
     __RME_A7M_Flag_Fast(RME_RVM_PHYS_VCTF_BASE,RME_RVM_PHYS_VCTF_SIZE,1U);
 #endif
+
+#if(RME_A7M_VCT_COAL_ENABLE!=0U)
+    /* Send what the coalescing windows held back before picking a thread */
+    __RME_A7M_Vct_Coal_Tim();
+#endif
     
     /* Not tickless */
     _RME_Tim_Handler(Reg,1U);
@@ -393,7 +764,8 @@ void __RME_A7M_Svc_Handler(struct RME_Reg_Struct* Reg)
 /* Function:__RME_A7M_Pgt_Entry_Mod *******************************************
 Description : Consult or modify the page table attributes. ARMv7-M only allows 
               consulting page table attributes but does not allow modifying them,
-              because there are no architecture-specific flags.
+              because there are no architecture-specific flags. The dynamic region
+              miss counter of a process can be read or cleared via its top-level.
 Input       : struct RME_Cap_Cpt* Cpt - The current capability table.
               rme_cid_t Cap_Pgt - The capability to the top-level page table to consult.
               rme_ptr_t Vaddr - The virtual address to consult.
@@ -408,6 +780,7 @@ rme_ret_t __RME_A7M_Pgt_Entry_Mod(struct RME_Cap_Cpt* Cpt,
                                   rme_ptr_t Type)
 {
     struct RME_Cap_Pgt* Pgt_Op;
+    struct __RME_A7M_MPU_Data* Top_MPU;
     rme_ptr_t Type_Stat;
     rme_ptr_t Size_Order;
     rme_ptr_t Num_Order;
@@ -417,6 +790,21 @@ rme_ret_t __RME_A7M_Pgt_Entry_Mod(struct RME_Cap_Cpt* Cpt,
     RME_CPT_GETCAP(Cpt,Cap_Pgt,RME_CAP_TYPE_PGT,
                    struct RME_Cap_Pgt*,Pgt_Op,Type_Stat);
     
+    /* Region miss counters are per-process, and live in the top-level */
+    if((Type==RME_A7M_KFN_PGT_ENTRY_MOD_MISS_GET)||
+       (Type==RME_A7M_KFN_PGT_ENTRY_MOD_MISS_CLR))
+    {
+        if(((Pgt_Op->Base)&RME_PGT_TOP)==0U)
+            return RME_ERR_KFN_FAIL;
+        
+        Top_MPU=RME_A7M_PGT_MPU(RME_CAP_GETOBJ(Pgt_Op,rme_ptr_t));
+        Flags=Top_MPU->Miss;
+        if(Type==RME_A7M_KFN_PGT_ENTRY_MOD_MISS_CLR)
+            Top_MPU->Miss=0U;
+        
+        return (rme_ret_t)Flags;
+    }
+    
     if(__RME_Pgt_Walk(Pgt_Op,Vaddr,0U,0U,0U,&Size_Order,&Num_Order,&Flags)!=0U)
         return RME_ERR_KFN_FAIL;
     
@@ -435,16 +823,38 @@ rme_ret_t __RME_A7M_Pgt_Entry_Mod(struct RME_Cap_Cpt* Cpt,
 
 /* Function:__RME_A7M_Int_Local_Mod *******************************************
 Description : Consult or modify the local interrupt controller's vector state.
-Input       : rme_ptr_t Int_Num - The interrupt number to consult or modify.
+              A vector can also be bound to its own signal endpoint, so that
+              its driver is woken directly rather than through Sig_Vct, and
+              be given a coalescing policy that limits how often it signals.
+              Acknowledging a coalesced vector returns the hits since the last
+              acknowledgement and enables the vector again. A vector can also
+              be given a bypass top-half, which acknowledges the device and
+              counts hits in the handler, and only signals when it decides to.
+Input       : struct RME_Cap_Cpt* Cpt - The current capability table.
+              rme_ptr_t Int_Num - The interrupt number to consult or modify.
               rme_ptr_t Operation - The operation to conduct.
-              rme_ptr_t Param - The parameter, could be state or priority.
+              rme_ptr_t Param - The parameter, could be state, priority, or
+                                signal endpoint capability; RME_CID_NULL
+                                unbinds the endpoint. For the coalescing
+                                policy, D1 is the window in ticks, Q1 is the
+                                number of hits per signal with 0 removing the
+                                policy, and Q0 is nonzero to keep the vector
+                                masked after a signal until acknowledged. For
+                                the bypass top-half, the address of it in the
+                                caller's memory, with 0 removing it.
 Output      : None.
 Return      : rme_ret_t - If successful, 0 or the desired value; else RME_ERR_KFN_FAIL.
 ******************************************************************************/
-rme_ret_t __RME_A7M_Int_Local_Mod(rme_ptr_t Int_Num,
+rme_ret_t __RME_A7M_Int_Local_Mod(struct RME_Cap_Cpt* Cpt,
+                                  rme_ptr_t Int_Num,
                                   rme_ptr_t Operation,
                                   rme_ptr_t Param)
 {
+#if((RME_A7M_VCT_COAL_ENABLE!=0U)|| \
+    ((RME_A7M_VCT_BYP_ENABLE!=0U)&&(RME_PGT_RAW_ENABLE==0U)))
+    rme_ptr_t Hit;
+    
+#endif
     if(Int_Num>=RME_RVM_PHYS_VCT_NUM)
         return RME_ERR_KFN_FAIL;
     
@@ -478,6 +888,54 @@ rme_ret_t __RME_A7M_Int_Local_Mod(rme_ptr_t Int_Num,
             RME_A7M_NVIC_IPR(Int_Num)=(rme_u8_t)Param;
             return 0U;
         }
+        case RME_A7M_KFN_INT_LOCAL_MOD_SIG_SET:
+        {
+            return _RME_Kern_Sig_Bind(Cpt,
+                                      (rme_cid_t)Param,
+                                      &(RME_A7M_Vct_Sig[Int_Num]));
+        }
+#if(RME_A7M_VCT_COAL_ENABLE!=0U)
+        case RME_A7M_KFN_INT_LOCAL_MOD_COAL_SET:
+        {
+            RME_A7M_Vct_Coal[Int_Num].Num=RME_PARAM_Q1(Param);
+            RME_A7M_Vct_Coal[Int_Num].Window=RME_PARAM_D1(Param);
+            RME_A7M_Vct_Coal[Int_Num].Mask=RME_PARAM_Q0(Param);
+            RME_A7M_Vct_Coal[Int_Num].Pend=0U;
+            return 0U;
+        }
+        case RME_A7M_KFN_INT_LOCAL_MOD_COAL_ACK:
+        {
+            /* Vectors placed above SVC may hit in between, so read and clear at once */
+            __RME_Int_Disable();
+            Hit=RME_A7M_Vct_Coal[Int_Num].Hit;
+            RME_A7M_Vct_Coal[Int_Num].Hit=0U;
+            __RME_Int_Enable();
+            
+            /* A vector held back by its window is enabled when the window ends */
+            if(RME_BITMAP_IS_SET(RME_A7M_Vct_Defer,Int_Num)==0U)
+                RME_A7M_NVIC_ISER(Int_Num)=RME_POW2(Int_Num&0x1FU);
+            
+            return (rme_ret_t)Hit;
+        }
+#endif
+#if((RME_A7M_VCT_BYP_ENABLE!=0U)&&(RME_PGT_RAW_ENABLE==0U))
+        case RME_A7M_KFN_INT_LOCAL_MOD_BYP_SET:
+        {
+            return __RME_A7M_Vct_Byp_Set(Int_Num,Param);
+        }
+        case RME_A7M_KFN_INT_LOCAL_MOD_BYP_ACK:
+        {
+            if(RME_A7M_Vct_Byp_Map[Int_Num]==0U)
+                return RME_ERR_KFN_FAIL;
+            
+            /* Vectors placed above SVC may hit in between, so read and clear at once */
+            __RME_Int_Disable();
+            Hit=RME_A7M_Vct_Byp[RME_A7M_Vct_Byp_Map[Int_Num]-1U].Hit;
+            RME_A7M_Vct_Byp[RME_A7M_Vct_Byp_Map[Int_Num]-1U].Hit=0U;
+            __RME_Int_Enable();
+            return (rme_ret_t)Hit;
+        }
+#endif
         default:break;
     }
     
@@ -1328,7 +1786,8 @@ rme_ret_t __RME_Kfn_Handler(struct RME_Cap_Cpt* Cpt,
 /* Interrupt controller operations *******************************************/
         case RME_KFN_INT_LOCAL_MOD:
         {
-            Retval=__RME_A7M_Int_Local_Mod(Sub_ID,
+            Retval=__RME_A7M_Int_Local_Mod(Cpt,
+                                           Sub_ID,
                                            Param1,
                                            Param2);
             break;
@@ -1868,6 +2327,24 @@ void __RME_Svc_Retval_Set(struct RME_Reg_Struct* Reg,
 }
 /* End Function:__RME_Svc_Retval_Set *****************************************/
 
+/* Function:__RME_Svc_Pgr_Set *************************************************
+Description : Set the fault information for a pager thread that is woken up
+              by a fault. R4 carries the signal number as usual.
+Input       : rme_ptr_t TID - The thread ID of the faulting thread.
+              struct RME_Exc_Struct* Exc - The fault information.
+Output      : struct RME_Reg_Struct* Reg - The register set of the pager.
+Return      : None.
+******************************************************************************/
+void __RME_Svc_Pgr_Set(struct RME_Reg_Struct* Reg,
+                       rme_ptr_t TID,
+                       struct RME_Exc_Struct* Exc)
+{
+    Reg->R5=TID;
+    Reg->R6=Exc->Cause;
+    Reg->R7=Exc->Addr;
+}
+/* End Function:__RME_Svc_Pgr_Set ********************************************/
+
 /* Function:__RME_Thd_Reg_Init ************************************************
 Description : Initialize the register set for the thread.
 Input       : rme_ptr_t Attr - The context attributes.
@@ -2225,6 +2702,12 @@ void __RME_Pgt_Set(rme_ptr_t Pgt)
     MPU_Data=(struct __RME_A7M_MPU_Data*)(RME_CAP_GETOBJ(Pgt, rme_ptr_t)+
                                           sizeof(struct __RME_A7M_Pgt_Meta));
     Raw_Pgt=&(MPU_Data->Raw);
+    
+    /* Skip the reload if this MPU data is already loaded and did not change since */
+    if((MPU_Data==RME_A7M_MPU_Cur)&&(MPU_Data->Gen==RME_A7M_MPU_Cur_Gen))
+        return;
+    RME_A7M_MPU_Cur=MPU_Data;
+    RME_A7M_MPU_Cur_Gen=MPU_Data->Gen;
 #else
     Raw_Pgt=(struct __RME_A7M_Raw_Pgt*)Pgt;
 #endif
@@ -2294,6 +2777,12 @@ rme_ret_t __RME_Pgt_Init(struct RME_Cap_Pgt* Pgt_Op)
     if(((Pgt_Op->Base)&RME_PGT_TOP)!=0U)
     {
         ((struct __RME_A7M_MPU_Data*)Ptr)->Static=0U;
+        ((struct __RME_A7M_MPU_Data*)Ptr)->Hand=0U;
+        ((struct __RME_A7M_MPU_Data*)Ptr)->Miss=0U;
+        
+        /* A new generation, so that memory reused from a loaded table is loaded again */
+        RME_A7M_MPU_Gen++;
+        ((struct __RME_A7M_MPU_Data*)Ptr)->Gen=RME_A7M_MPU_Gen;
         
         for(Count=0;Count<RME_A7M_REGION_NUM;Count++)
         {
@@ -2301,13 +2790,23 @@ rme_ret_t __RME_Pgt_Init(struct RME_Cap_Pgt* Pgt_Op)
             ((struct __RME_A7M_MPU_Data*)Ptr)->Raw.Data[Count].RASR=0U;
         }
         
+#if(RME_PGT_WALK_CACHE_NUM!=0U)
+        ((struct __RME_A7M_MPU_Data*)Ptr)->Cache_Hand=0U;
+        for(Count=0U;Count<RME_PGT_WALK_CACHE_NUM;Count++)
+            ((struct __RME_A7M_MPU_Data*)Ptr)->Cache[Count].Meta=RME_NULL;
+#endif
+        
         Ptr+=sizeof(struct __RME_A7M_MPU_Data)/RME_WORD_BYTE;
     }
     
     /* Clean up the table itself - This is could be virtually unbounded if the user
-     * pass in some very large length value */
-    for(Count=0U;Count<RME_POW2(RME_PGT_NMORD(Pgt_Op->Order));Count++)
-        Ptr[Count]=0U;
+     * pass in some very large length value. This is skipped if the table was
+     * zeroed in advance. */
+    if(RME_KOT_CLEAN_CHK(Ptr,RME_POW2(RME_PGT_NMORD(Pgt_Op->Order))*RME_WORD_BYTE)==0U)
+    {
+        for(Count=0U;Count<RME_POW2(RME_PGT_NMORD(Pgt_Op->Order));Count++)
+            Ptr[Count]=0U;
+    }
     
     return 0;
 }
@@ -2353,6 +2852,11 @@ rme_ret_t __RME_Pgt_Del_Check(struct RME_Cap_Pgt* Pgt_Op)
 {
     /* We don't need to check the directory mapping status (whether we are 
      * parent or children) anymore because this is done in the kernel */
+#if(RME_A7M_VCT_BYP_ENABLE!=0U)
+    /* The pages in it go away with it */
+    __RME_A7M_Vct_Byp_Drop((Pgt_Op->Base)&(~RME_PGT_TOP),
+                           RME_PGT_SZORD(Pgt_Op->Order)+RME_PGT_NMORD(Pgt_Op->Order));
+#endif
     return 0;
 }
 /* End Function:__RME_Pgt_Del_Check ******************************************/
@@ -2364,6 +2868,7 @@ Input       : None.
 Output      : None.
 Return      : rme_ptr_t - The random number returned.
 ******************************************************************************/
+#if(RME_A7M_MPU_REPL!=RME_A7M_MPU_REPL_FIFO)
 rme_ptr_t __RME_A7M_Rand(void)
 {   
     static rme_ptr_t LFSR=0xACE1ACE1U;
@@ -2378,6 +2883,7 @@ rme_ptr_t __RME_A7M_Rand(void)
     
     return LFSR;
 }
+#endif
 /* End Function:__RME_A7M_Rand ***********************************************/
 
 /* Function:___RME_A7M_MPU_RASR_Gen *******************************************
@@ -2477,6 +2983,9 @@ rme_ret_t ___RME_A7M_MPU_Clear(struct __RME_A7M_MPU_Data* Top_MPU,
                 /* Clean it up and return */
                 Top_MPU->Raw.Data[Count].RBAR=RME_A7M_MPU_VALID|Count;
                 Top_MPU->Raw.Data[Count].RASR=0U;
+                /* The MPU data changed, and must be loaded again */
+                RME_A7M_MPU_Gen++;
+                Top_MPU->Gen=RME_A7M_MPU_Gen;
                 /* Clean the static flag as well */
                 Top_MPU->Static&=~RME_POW2(Count);
                 return 0;
@@ -2488,6 +2997,44 @@ rme_ret_t ___RME_A7M_MPU_Clear(struct __RME_A7M_MPU_Data* Top_MPU,
 }
 /* End Function:___RME_A7M_MPU_Clear *****************************************/
 
+/* Function:___RME_A7M_MPU_Victim *********************************************
+Description : Choose a dynamic MPU region to evict. The FIFO policy sweeps the
+              hand across the regions and takes the next dynamic one; a region
+              that is brought in takes the slot the hand just left, so it is the
+              last to go, and the regions leave in the order they came in. The
+              MPU keeps no record of accesses, and a loaded region never faults,
+              so there is nothing better than load order to go by here. A cyclic
+              working set larger than the MPU thus misses on every access under
+              FIFO, which is why the random policy is the default.
+Input       : struct __RME_A7M_MPU_Data* Top_MPU - The top-level MPU metadata.
+              rme_u8_t* Dynamic - The dynamic regions.
+              rme_ptr_t Dynamic_Cnt - The number of dynamic regions, nonzero.
+Output      : None.
+Return      : rme_u8_t - The region to evict.
+******************************************************************************/
+rme_u8_t ___RME_A7M_MPU_Victim(struct __RME_A7M_MPU_Data* Top_MPU,
+                               rme_u8_t* Dynamic,
+                               rme_ptr_t Dynamic_Cnt)
+{
+#if(RME_A7M_MPU_REPL==RME_A7M_MPU_REPL_FIFO)
+    rme_u8_t Count;
+    
+    /* There is at least one dynamic region, so this terminates in one round */
+    while(1)
+    {
+        Count=(rme_u8_t)(Top_MPU->Hand);
+        Top_MPU->Hand=(Top_MPU->Hand+1U)%RME_A7M_REGION_NUM;
+        
+        /* Static regions are never evicted */
+        if((Top_MPU->Static&RME_POW2(Count))==0U)
+            return Count;
+    }
+#else
+    return Dynamic[__RME_A7M_Rand()%Dynamic_Cnt];
+#endif
+}
+/* End Function:___RME_A7M_MPU_Victim ****************************************/
+
 /* Function:___RME_A7M_MPU_Add ************************************************
 Description : Add or update the MPU entry in the top-level MPU table. We guarantee
               that at any time at least two regions are dedicated to dynamic entries.
@@ -2537,6 +3084,9 @@ rme_ret_t ___RME_A7M_MPU_Add(struct __RME_A7M_MPU_Data* Top_MPU,
             {
                 /* Update the RASR - all flag changes except static are reflected here */
                 Top_MPU->Raw.Data[Count].RASR=RASR;
+                /* The MPU data changed, and must be loaded again */
+                RME_A7M_MPU_Gen++;
+                Top_MPU->Gen=RME_A7M_MPU_Gen;
                 /* STATIC or not is reflected in the MPU state; instead it is
                  * maintained by using another standalone word */
                 if(Static!=0U)
@@ -2558,7 +3108,7 @@ rme_ret_t ___RME_A7M_MPU_Add(struct __RME_A7M_MPU_Data* Top_MPU,
      * 1. See if the number of regions left (dynamic+empty) is larger than 3. 
      *    If not, we cannot map. (At least two slots reserved for dynamic regions.)
      * 2. If there is an empty slot, use that slot.
-     * 3. If there is no such slot, use random replacement policy to evict a 
+     * 3. If there is no such slot, use the replacement policy to evict a 
      *    dynamic page in use.
      * If this is a dynamic page:
      * 1. See if there are empty slots, if there is, use it.
@@ -2580,16 +3130,19 @@ rme_ret_t ___RME_A7M_MPU_Add(struct __RME_A7M_MPU_Data* Top_MPU,
         Count=Empty[0];
     /* We must evict an dynamic entry */
     else
-        Count=Dynamic[__RME_A7M_Rand()%Dynamic_Cnt];
+        Count=___RME_A7M_MPU_Victim(Top_MPU,Dynamic,Dynamic_Cnt);
     
     /* Put the data to this slot */
     Top_MPU->Raw.Data[Count].RBAR=RME_A7M_MPU_ADDR(Base_Addr)|RME_A7M_MPU_VALID|Count;
     Top_MPU->Raw.Data[Count].RASR=RASR;
+    /* The MPU data changed, and must be loaded again */
+    RME_A7M_MPU_Gen++;
+    Top_MPU->Gen=RME_A7M_MPU_Gen;
     /* STATIC or not is reflected in the state */
     if(Static!=0U)
         Top_MPU->Static|=RME_POW2(Count);
     else
-        Top_MPU->Static&=!RME_POW2(Count);
+        Top_MPU->Static&=~RME_POW2(Count);
 
     return 0;
 }
@@ -2797,6 +3350,13 @@ rme_ret_t __RME_Pgt_Page_Map(struct RME_Cap_Pgt* Pgt_Op,
     {
         if((Flag&RME_PGT_STATIC)!=0U)
         {
+            /* In a batch, the MPU representation is updated once at the end */
+            if(RME_A7M_Pgt_Batch!=RME_A7M_PGT_BATCH_NONE)
+            {
+                RME_A7M_Pgt_Batch=RME_A7M_PGT_BATCH_DIRTY;
+                return 0;
+            }
+            
             /* Mapping static pages, update the MPU representation */
             if(___RME_A7M_MPU_Update(Meta,RME_A7M_MPU_UPD)==RME_ERR_HAL_FAIL)
             {
@@ -2813,6 +3373,50 @@ rme_ret_t __RME_Pgt_Page_Map(struct RME_Cap_Pgt* Pgt_Op,
 }
 /* End Function:__RME_Pgt_Page_Map *******************************************/
 
+/* Function:__RME_A7M_Pgt_Batch_Begin *****************************************
+Description : Begin a batch of page mappings into a single page directory. The
+              MPU representation is not updated for each page in the batch.
+Input       : struct RME_Cap_Pgt* Pgt_Op - The page table to map into.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_A7M_Pgt_Batch_Begin(struct RME_Cap_Pgt* Pgt_Op)
+{
+    RME_A7M_Pgt_Batch=RME_A7M_PGT_BATCH_CLEAN;
+}
+/* End Function:__RME_A7M_Pgt_Batch_Begin ************************************/
+
+/* Function:__RME_A7M_Pgt_Batch_End *******************************************
+Description : End a batch of page mappings, and update the MPU representation
+              once if any static page got mapped in the batch. All pages in the
+              batch are in the same directory, so this is exactly what mapping
+              them one by one would have done.
+Input       : struct RME_Cap_Pgt* Pgt_Op - The page table mapped into.
+Output      : None.
+Return      : rme_ret_t - If successful, 0; else RME_ERR_HAL_FAIL, in which case
+                          the caller shall unmap all pages in the batch.
+******************************************************************************/
+rme_ret_t __RME_A7M_Pgt_Batch_End(struct RME_Cap_Pgt* Pgt_Op)
+{
+    rme_ptr_t Batch;
+    
+    Batch=RME_A7M_Pgt_Batch;
+    RME_A7M_Pgt_Batch=RME_A7M_PGT_BATCH_NONE;
+    
+    if(Batch!=RME_A7M_PGT_BATCH_DIRTY)
+        return 0;
+    
+    if(___RME_A7M_MPU_Update(RME_CAP_GETOBJ(Pgt_Op,struct __RME_A7M_Pgt_Meta*),
+                              RME_A7M_MPU_UPD)==RME_ERR_HAL_FAIL)
+        return RME_ERR_HAL_FAIL;
+    
+    /* Update MPU in case we're manipulating the current page table */
+    ___RME_A7M_Pgt_Refresh();
+    
+    return 0;
+}
+/* End Function:__RME_A7M_Pgt_Batch_End **************************************/
+
 /* Function:__RME_Pgt_Page_Unmap **********************************************
 Description : Unmap a page from the page table.
 Input       : struct RME_Cap_Pgt* - The capability to the page table to operate on.
@@ -2848,8 +3452,17 @@ rme_ret_t __RME_Pgt_Page_Unmap(struct RME_Cap_Pgt* Pgt_Op,
        ((Table[Pos]&RME_A7M_PGT_TERMINAL)==0U))
         return RME_ERR_HAL_FAIL;
 
+#if(RME_A7M_VCT_BYP_ENABLE!=0U)
+    /* No top-half may touch the page once it is gone */
+    __RME_A7M_Vct_Byp_Drop(((Pgt_Op->Base)&(~RME_PGT_TOP))+(Pos<<RME_PGT_SZORD(Pgt_Op->Order)),
+                           RME_PGT_SZORD(Pgt_Op->Order));
+#endif
     Temp=Table[Pos];
     Table[Pos]=0U;
+#if(RME_PGT_WALK_CACHE_NUM!=0U)
+    /* Invalidate all walk cache entries */
+    RME_A7M_Pgt_Gen++;
+#endif
     /* If we are top-level or we have a top-level, do MPU updates */
     if((Meta->Toplevel!=0U)||(((Pgt_Op->Base)&RME_PGT_TOP)!=0U))
     {
@@ -2992,8 +3605,17 @@ rme_ret_t __RME_Pgt_Pgdir_Unmap(struct RME_Cap_Pgt* Pgt_Parent,
         ___RME_A7M_Pgt_Refresh();
     }
 
+#if(RME_A7M_VCT_BYP_ENABLE!=0U)
+    /* No top-half may touch the pages of the directory once it is gone */
+    __RME_A7M_Vct_Byp_Drop((Pgt_Child->Base)&(~RME_PGT_TOP),
+                           RME_PGT_SZORD(Pgt_Child->Order)+RME_PGT_NMORD(Pgt_Child->Order));
+#endif
     Table[Pos]=0U;
     Meta_Parent->Toplevel=0U;
+#if(RME_PGT_WALK_CACHE_NUM!=0U)
+    /* Invalidate all walk cache entries */
+    RME_A7M_Pgt_Gen++;
+#endif
 
     return 0;
 }
@@ -3036,6 +3658,73 @@ rme_ret_t __RME_Pgt_Lookup(struct RME_Cap_Pgt* Pgt_Op,
 }
 /* End Function:__RME_Pgt_Lookup *********************************************/
 
+/* Function:___RME_A7M_Pgt_Cache_Find *****************************************
+Description : Look up a virtual address in the walk cache of a top-level page
+              table. Entries filled in before the last unmapping are stale.
+Input       : struct __RME_A7M_Pgt_Meta* Top - The top-level page table.
+              rme_ptr_t Vaddr - The virtual address to look up.
+Output      : None.
+Return      : struct __RME_A7M_Pgt_Cache* - The cache entry, or RME_NULL if missed.
+******************************************************************************/
+#if((RME_PGT_RAW_ENABLE==0U)&&(RME_PGT_WALK_CACHE_NUM!=0U))
+struct __RME_A7M_Pgt_Cache* ___RME_A7M_Pgt_Cache_Find(struct __RME_A7M_Pgt_Meta* Top,
+                                                      rme_ptr_t Vaddr)
+{
+    rme_ptr_t Count;
+    struct __RME_A7M_Pgt_Cache* Cache;
+    
+    for(Count=0U;Count<RME_PGT_WALK_CACHE_NUM;Count++)
+    {
+        Cache=&(RME_A7M_PGT_MPU(Top)->Cache[Count]);
+        if((Cache->Meta!=RME_NULL)&&(Cache->Gen==RME_A7M_Pgt_Gen)&&
+           (Vaddr>=Cache->Start)&&(Vaddr<=Cache->End))
+            return Cache;
+    }
+    
+    return RME_NULL;
+}
+#endif
+/* End Function:___RME_A7M_Pgt_Cache_Find ************************************/
+
+/* Function:___RME_A7M_Pgt_Cache_Fill *****************************************
+Description : Remember a page found by a walk in the walk cache of a top-level
+              page table. The entries are replaced in a round-robin fashion.
+Input       : struct __RME_A7M_Pgt_Meta* Top - The top-level page table.
+              struct __RME_A7M_Pgt_Meta* Meta - The page directory of the page.
+              rme_ptr_t Start - The start address of the page.
+              rme_ptr_t Flag - The RME standard flags of the page.
+Output      : None.
+Return      : None.
+******************************************************************************/
+#if((RME_PGT_RAW_ENABLE==0U)&&(RME_PGT_WALK_CACHE_NUM!=0U))
+void ___RME_A7M_Pgt_Cache_Fill(struct __RME_A7M_Pgt_Meta* Top,
+                               struct __RME_A7M_Pgt_Meta* Meta,
+                               rme_ptr_t Start,
+                               rme_ptr_t Flag)
+{
+    struct __RME_A7M_MPU_Data* Top_Data;
+    struct __RME_A7M_Pgt_Cache* Cache;
+    
+    Top_Data=RME_A7M_PGT_MPU(Top);
+    Cache=&(Top_Data->Cache[Top_Data->Cache_Hand]);
+    
+    Cache->Gen=RME_A7M_Pgt_Gen;
+    Cache->Start=Start;
+    /* Shifting by RME_WORD_BIT or more is UB */
+    if(RME_PGT_SZORD(Meta->Order)>=RME_WORD_BIT)
+        Cache->End=RME_MASK_FULL;
+    else
+        Cache->End=Start+RME_POW2(RME_PGT_SZORD(Meta->Order))-1U;
+    Cache->Flag=Flag;
+    Cache->Meta=Meta;
+    
+    Top_Data->Cache_Hand++;
+    if(Top_Data->Cache_Hand>=RME_PGT_WALK_CACHE_NUM)
+        Top_Data->Cache_Hand=0U;
+}
+#endif
+/* End Function:___RME_A7M_Pgt_Cache_Fill ************************************/
+
 /* Function:__RME_Pgt_Walk ****************************************************
 Description : Walking function for the page table. This function just does page
               table lookups. The page table that is being walked must be the top-
@@ -3061,70 +3750,89 @@ rme_ret_t __RME_Pgt_Walk(struct RME_Cap_Pgt* Pgt_Op,
                          rme_ptr_t* Flag)
 {
     struct __RME_A7M_Pgt_Meta* Meta;
+    struct __RME_A7M_Pgt_Cache* Cache;
     rme_ptr_t* Table;
     rme_ptr_t Pos;
     rme_ptr_t Shift;
+    rme_ptr_t Start;
+    rme_ptr_t Page_Flag;
+#if(RME_PGT_WALK_CACHE_NUM!=0U)
+    struct __RME_A7M_Pgt_Meta* Top;
+#endif
     
     /* This must the top-level page table */
     RME_ASSERT(((Pgt_Op->Base)&RME_PGT_TOP)!=0U);
     
-    /* Get the table and start lookup */
+    /* Get the table and see if the page was walked to recently */
     Meta=RME_CAP_GETOBJ(Pgt_Op,struct __RME_A7M_Pgt_Meta*);
-    Table=RME_A7M_PGT_TBL_TOP(Meta);
+#if(RME_PGT_WALK_CACHE_NUM!=0U)
+    Top=Meta;
+    Cache=___RME_A7M_Pgt_Cache_Find(Top,Vaddr);
+#else
+    Cache=RME_NULL;
+#endif
     
-    /* Do lookup recursively */
-    while(1)
+    if(Cache!=RME_NULL)
     {
-        /* Check if the virtual address is in our range */
-        if(Vaddr<RME_PGT_BASE(Meta->Base))
-            return RME_ERR_HAL_FAIL;
-        /* Calculate entry position - shifting by 32 or more is UB */
-        Shift=RME_PGT_SZORD(Meta->Order);
-        if(Shift>=RME_WORD_BIT)
-            Pos=0U;
-        else
-            Pos=(Vaddr-RME_PGT_BASE(Meta->Base))>>Shift;
-        /* See if the entry is overrange */
-        if((Pos>>RME_PGT_NMORD(Meta->Order))!=0U)
-            return RME_ERR_HAL_FAIL;
-        /* Find the position of the entry - Is there a page, a directory, or nothing? */
-        if((Table[Pos]&RME_A7M_PGT_PRESENT)==0U)
-            return RME_ERR_HAL_FAIL;
-        if((Table[Pos]&RME_A7M_PGT_TERMINAL)!=0U)
+        Meta=Cache->Meta;
+        Start=Cache->Start;
+        Page_Flag=Cache->Flag;
+    }
+    else
+    {
+        Table=RME_A7M_PGT_TBL_TOP(Meta);
+        /* Do lookup recursively */
+        while(1)
         {
-            /* This is a page - we found it */
-            if(Pgt!=RME_NULL)
-                *Pgt=(rme_ptr_t)Meta;
-            if(Map_Vaddr!=RME_NULL)
+            /* Check if the virtual address is in our range */
+            if(Vaddr<RME_PGT_BASE(Meta->Base))
+                return RME_ERR_HAL_FAIL;
+            /* Calculate entry position - shifting by RME_WORD_BIT or more is UB */
+            Shift=RME_PGT_SZORD(Meta->Order);
+            if(Shift>=RME_WORD_BIT)
+                Pos=0U;
+            else
+                Pos=(Vaddr-RME_PGT_BASE(Meta->Base))>>Shift;
+            /* See if the entry is overrange */
+            if((Pos>>RME_PGT_NMORD(Meta->Order))!=0U)
+                return RME_ERR_HAL_FAIL;
+            /* Find the position of the entry - Is there a page, a directory, or nothing? */
+            if((Table[Pos]&RME_A7M_PGT_PRESENT)==0U)
+                return RME_ERR_HAL_FAIL;
+            if((Table[Pos]&RME_A7M_PGT_TERMINAL)!=0U)
             {
+                /* This is a page - we found it */
                 if(Shift>=RME_WORD_BIT)
-                    *Map_Vaddr=RME_PGT_BASE(Meta->Base);
+                    Start=RME_PGT_BASE(Meta->Base);
                 else
-                    *Map_Vaddr=RME_PGT_BASE(Meta->Base)+(Pos<<Shift);
+                    Start=RME_PGT_BASE(Meta->Base)+(Pos<<Shift);
+                Page_Flag=Meta->Page_Flag;
+                break;
             }
-            if(Paddr!=RME_NULL)
+            else
             {
-                if(Shift>=RME_WORD_BIT)
-                    *Paddr=RME_PGT_BASE(Meta->Base);
-                else
-                    *Paddr=RME_PGT_BASE(Meta->Base)+(Pos<<Shift);
+                /* This is a directory, we goto that directory to continue walking */
+                Meta=(struct __RME_A7M_Pgt_Meta*)RME_A7M_PGT_PGD_ADDR(Table[Pos]);
+                Table=RME_A7M_PGT_TBL_NOM(Meta);
             }
-            if(Size_Order!=RME_NULL)
-                *Size_Order=RME_PGT_SZORD(Meta->Order);
-            if(Num_Order!=RME_NULL)
-                *Num_Order=RME_PGT_NMORD(Meta->Order);
-            if(Flag!=RME_NULL)
-                *Flag=Meta->Page_Flag;
-            
-            break;
-        }
-        else
-        {
-            /* This is a directory, we goto that directory to continue walking */
-            Meta=(struct __RME_A7M_Pgt_Meta*)RME_A7M_PGT_PGD_ADDR(Table[Pos]);
-            Table=RME_A7M_PGT_TBL_NOM(Meta);
         }
+#if(RME_PGT_WALK_CACHE_NUM!=0U)
+        ___RME_A7M_Pgt_Cache_Fill(Top,Meta,Start,Page_Flag);
+#endif
     }
+    
+    if(Pgt!=RME_NULL)
+        *Pgt=(rme_ptr_t)Meta;
+    if(Map_Vaddr!=RME_NULL)
+        *Map_Vaddr=Start;
+    if(Paddr!=RME_NULL)
+        *Paddr=Start;
+    if(Size_Order!=RME_NULL)
+        *Size_Order=RME_PGT_SZORD(Meta->Order);
+    if(Num_Order!=RME_NULL)
+        *Num_Order=RME_PGT_NMORD(Meta->Order);
+    if(Flag!=RME_NULL)
+        *Flag=Page_Flag;
 
     return 0;
 }
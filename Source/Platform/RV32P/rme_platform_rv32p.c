@@ -207,10 +207,8 @@ void __RME_RV32P_Flag_Fast(rme_ptr_t Base,
 {
     volatile struct __RME_RVM_Flag* Set;
 
-    /* Choose a data structure that is not locked at the moment */
-    Set=RME_RVM_FLAG_SET(Base,Size,0U);
-    if(Set->Lock!=0U)
-        Set=RME_RVM_FLAG_SET(Base,Size,1U);
+    /* Write to the buffer that the consumer is not draining at the moment */
+    Set=RME_RVM_FLAG_SET(Base,Size,RME_RVM_FLAG_CUR(Base)&1U);
 
     /* Set the flags for this interrupt source */
     Set->Fast|=Flag;
@@ -219,6 +217,7 @@ void __RME_RV32P_Flag_Fast(rme_ptr_t Base,
 
 /* Function:__RME_RV32P_Flag_Slow *********************************************
 Description : Set a slow flag in a flag set. Works for both vectors and events.
+              The size of the flagset decides whether there is a summary level.
 Input       : rme_ptr_t Base - The base address of the flagset.
               rme_ptr_t Size - The size of the flagset.
               rme_ptr_t Pos - The position in the flagset to set.
@@ -230,18 +229,247 @@ void __RME_RV32P_Flag_Slow(rme_ptr_t Base,
                            rme_ptr_t Pos)
 {
     volatile struct __RME_RVM_Flag* Set;
+    rme_ptr_t Word;
+    rme_ptr_t Sum;
     
-    /* Choose a data structure that is not locked at the moment */
-    Set=RME_RVM_FLAG_SET(Base,Size,0U);
-    if(Set->Lock!=0U)
-        Set=RME_RVM_FLAG_SET(Base,Size,1U);
+    /* Write to the buffer that the consumer is not draining at the moment */
+    Set=RME_RVM_FLAG_SET(Base,Size,RME_RVM_FLAG_CUR(Base)&1U);
     
-    /* Set the flags for this interrupt source */
-    Set->Group|=RME_POW2(Pos>>RME_WORD_ORDER);
-    Set->Flag[Pos>>RME_WORD_ORDER]|=RME_POW2(Pos&RME_MASK_END(RME_WORD_ORDER-1U));
+    /* Set the flag, and mark the path down to it in the summary levels */
+    Word=Pos>>RME_WORD_ORDER;
+    Sum=RME_RVM_FLAG_SUM(Size);
+    if(Sum==0U)
+        Set->Group|=RME_POW2(Word);
+    else
+    {
+        Set->Group|=RME_POW2(Word>>RME_WORD_ORDER);
+        RME_BITMAP_SET(Set->Data,Word);
+    }
+    RME_BITMAP_SET(&(Set->Data[Sum]),Pos);
 }
 /* End Function:__RME_RV32P_Flag_Slow ****************************************/
 
+#if((RME_RV32P_VCT_BYP_ENABLE!=0U)&&(RME_PGT_RAW_ENABLE==0U))
+/* Function:__RME_RV32P_Vct_Byp ***********************************************
+Description : Run the bypass top-half of a vector on a hit. The register
+              operations run in order, each being one or two word accesses and
+              none of them looping, so the top-half takes a bounded time. Each
+              hit is counted; a signal is let through once per the top-half's
+              number of hits, or at once when a test does not match.
+Input       : rme_ptr_t Vct_Num - The vector number.
+Output      : None.
+Return      : rme_ptr_t - If the signal should be sent, 1; else 0.
+******************************************************************************/
+rme_ptr_t __RME_RV32P_Vct_Byp(rme_ptr_t Vct_Num)
+{
+    struct __RME_RV32P_Vct_Byp_Slot* Slot;
+    struct RME_RV32P_Vct_Byp_Op* Op;
+    rme_ptr_t Count;
+    rme_ptr_t Signal;
+    
+    Slot=&(RME_RV32P_Vct_Byp[RME_RV32P_Vct_Byp_Map[Vct_Num]-1U]);
+    Signal=0U;
+    
+    for(Count=0U;Count<Slot->Byp.Op_Num;Count++)
+    {
+        Op=&(Slot->Byp.Op[Count]);
+        switch(Op->Type)
+        {
+            case RME_RV32P_VCT_BYP_OP_WRITE:
+            {
+                RME_RV32P_REG(Op->Addr)=Op->Value;
+                break;
+            }
+            case RME_RV32P_VCT_BYP_OP_MODIFY:
+            {
+                RME_RV32P_REG(Op->Addr)=(RME_RV32P_REG(Op->Addr)&(~Op->Mask))|(Op->Value&Op->Mask);
+                break;
+            }
+            /* Write back the bits that are set, for write-one-to-clear registers */
+            case RME_RV32P_VCT_BYP_OP_CLEAR:
+            {
+                RME_RV32P_REG(Op->Addr)=RME_RV32P_REG(Op->Addr)&Op->Mask;
+                break;
+            }
+            /* The only other type that registration lets in is the test */
+            default:
+            {
+                if((RME_RV32P_REG(Op->Addr)&Op->Mask)!=Op->Value)
+                    Signal=1U;
+                break;
+            }
+        }
+    }
+    
+    /* Saturate the count so that the acknowledgement can never look like an error */
+    if(Slot->Hit<(RME_MASK_FULL>>1))
+        Slot->Hit++;
+    
+    if(Slot->Byp.Num!=0U)
+    {
+        Slot->Pend++;
+        if(Slot->Pend>=Slot->Byp.Num)
+            Signal=1U;
+    }
+    
+    if(Signal!=0U)
+        Slot->Pend=0U;
+    
+    return Signal;
+}
+/* End Function:__RME_RV32P_Vct_Byp ******************************************/
+
+/* Function:__RME_RV32P_Vct_Byp_Check *****************************************
+Description : Check that a word is accessible to the caller with the flags
+              given, so that a bypass top-half never reaches memory that its
+              driver could not reach itself.
+Input       : struct RME_Cap_Pgt* Pgt - The top-level page table of the caller.
+              rme_ptr_t Addr - The address of the word.
+              rme_ptr_t Flag - The page flags that are needed.
+Output      : None.
+Return      : rme_ret_t - If accessible, 0; else RME_ERR_KFN_FAIL.
+******************************************************************************/
+rme_ret_t __RME_RV32P_Vct_Byp_Check(struct RME_Cap_Pgt* Pgt,
+                                  rme_ptr_t Addr,
+                                  rme_ptr_t Flag)
+{
+    rme_ptr_t Page_Flag;
+    
+    /* PMP also binds user mode in the interrupt controller, so no range is
+     * reachable by the kernel alone once it is in the page table */
+    if((Addr&0x3U)!=0U)
+        return RME_ERR_KFN_FAIL;
+    
+    if(__RME_Pgt_Walk(Pgt,Addr,0U,0U,0U,0U,0U,&Page_Flag)!=0)
+        return RME_ERR_KFN_FAIL;
+    
+    if((Page_Flag&Flag)!=Flag)
+        return RME_ERR_KFN_FAIL;
+    
+    return 0;
+}
+/* End Function:__RME_RV32P_Vct_Byp_Check ************************************/
+
+/* Function:__RME_RV32P_Vct_Byp_Set *******************************************
+Description : Install, replace or remove the bypass top-half of a vector. The
+              top-half is copied from the caller's memory, and each register it
+              touches must be readable and writable by the caller at this time.
+Input       : rme_ptr_t Vct_Num - The vector number.
+              rme_ptr_t Addr - The address of the top-half in the caller's
+                               memory; 0 removes the top-half.
+Output      : None.
+Return      : rme_ret_t - If successful, 0; else RME_ERR_KFN_FAIL.
+******************************************************************************/
+rme_ret_t __RME_RV32P_Vct_Byp_Set(rme_ptr_t Vct_Num,
+                                rme_ptr_t Addr)
+{
+    struct RME_Cap_Pgt* Pgt;
+    struct RME_RV32P_Vct_Byp Byp;
+    struct __RME_RV32P_Vct_Byp_Slot* Slot;
+    rme_ptr_t Count;
+    rme_ptr_t Slot_Num;
+    
+    Slot_Num=RME_RV32P_Vct_Byp_Map[Vct_Num];
+    
+    if(Addr==0U)
+    {
+        if(Slot_Num==0U)
+            return RME_ERR_KFN_FAIL;
+        
+        RME_RV32P_Vct_Byp_Map[Vct_Num]=0U;
+        RME_RV32P_Vct_Byp[Slot_Num-1U].Vct=0U;
+        return 0;
+    }
+    
+    /* Copy the top-half in before checking it, so it cannot change under us */
+    Pgt=_RME_Thd_Pgt(RME_RV32P_Local.Thd_Cur);
+    for(Count=0U;Count<sizeof(struct RME_RV32P_Vct_Byp);Count+=RME_WORD_BYTE)
+    {
+        if(__RME_RV32P_Vct_Byp_Check(Pgt,Addr+Count,RME_PGT_READ)!=0)
+            return RME_ERR_KFN_FAIL;
+    }
+    _RME_Memcpy(&Byp,(void*)Addr,sizeof(struct RME_RV32P_Vct_Byp));
+    
+    if(Byp.Op_Num>RME_RV32P_VCT_BYP_OP_NUM)
+        return RME_ERR_KFN_FAIL;
+    
+    for(Count=0U;Count<Byp.Op_Num;Count++)
+    {
+        if(Byp.Op[Count].Type>RME_RV32P_VCT_BYP_OP_TEST)
+            return RME_ERR_KFN_FAIL;
+        if(__RME_RV32P_Vct_Byp_Check(Pgt,Byp.Op[Count].Addr,RME_PGT_READ|RME_PGT_WRITE)!=0)
+            return RME_ERR_KFN_FAIL;
+    }
+    
+    /* Reuse the slot of the vector if there is one, or find a free one */
+    if(Slot_Num==0U)
+    {
+        for(Count=0U;Count<RME_RV32P_VCT_BYP_NUM;Count++)
+        {
+            if(RME_RV32P_Vct_Byp[Count].Vct==0U)
+                break;
+        }
+        
+        if(Count>=RME_RV32P_VCT_BYP_NUM)
+            return RME_ERR_KFN_FAIL;
+        
+        Slot_Num=Count+1U;
+    }
+    
+    /* Take the vector off the top-half while copying, so a hit never sees half of it */
+    RME_RV32P_Vct_Byp_Map[Vct_Num]=0U;
+    Slot=&(RME_RV32P_Vct_Byp[Slot_Num-1U]);
+    Slot->Vct=Vct_Num+1U;
+    Slot->Hit=0U;
+    Slot->Pend=0U;
+    _RME_Memcpy(&(Slot->Byp),&Byp,sizeof(struct RME_RV32P_Vct_Byp));
+    RME_RV32P_Vct_Byp_Map[Vct_Num]=(rme_u8_t)Slot_Num;
+    
+    return 0;
+}
+/* End Function:__RME_RV32P_Vct_Byp_Set **************************************/
+
+/* Function:__RME_RV32P_Vct_Byp_Drop ******************************************
+Description : Remove the bypass top-halves that touch any register in a range
+              that is being unmapped or deleted, so that the kernel never
+              reaches memory that the driver no longer has. The top-halves of
+              other processes that touch the same range are removed as well,
+              and their drivers need to register them again.
+Input       : rme_ptr_t Start - The first address of the range.
+              rme_ptr_t Order - The size order of the range.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_RV32P_Vct_Byp_Drop(rme_ptr_t Start,
+                            rme_ptr_t Order)
+{
+    struct __RME_RV32P_Vct_Byp_Slot* Slot;
+    rme_ptr_t Count;
+    rme_ptr_t Op;
+    
+    for(Count=0U;Count<RME_RV32P_VCT_BYP_NUM;Count++)
+    {
+        Slot=&(RME_RV32P_Vct_Byp[Count]);
+        if(Slot->Vct==0U)
+            continue;
+        
+        for(Op=0U;Op<Slot->Byp.Op_Num;Op++)
+        {
+            if((Order>=RME_WORD_BIT)||(((Slot->Byp.Op[Op].Addr-Start)>>Order)==0U))
+                break;
+        }
+        
+        /* Take the vector off first, so that a hit never runs a dropped top-half */
+        if(Op<Slot->Byp.Op_Num)
+        {
+            RME_RV32P_Vct_Byp_Map[Slot->Vct-1U]=0U;
+            Slot->Vct=0U;
+        }
+    }
+}
+/* End Function:__RME_RV32P_Vct_Byp_Drop *************************************/
+#endif
+
 /* Function:_RME_RV32P_Handler ************************************************
 Description : The generic interrupt handler of RME for RV32P, in C.
 Input       : struct RME_Reg_Struct* Reg - The register set.
@@ -251,6 +479,7 @@ Return      : None.
 void _RME_RV32P_Handler(struct RME_Reg_Struct* Reg)
 {
     rme_ptr_t Mcause;
+    struct RME_Cap_Sig* Sig;
 
     Mcause=___RME_RV32P_MCAUSE_Get();
 
@@ -270,20 +499,48 @@ void _RME_RV32P_Handler(struct RME_Reg_Struct* Reg)
     {
         Mcause&=0x7FFFFFFFU;
 
-#if(RME_RVM_GEN_ENABLE!=0U)
-        /* If the user wants to bypass, we skip the flag marshalling & sending process */
-        if(RME_Boot_Vct_Handler(Reg,Mcause)!=0U)
+#if((RME_RV32P_VCT_BYP_ENABLE!=0U)&&(RME_PGT_RAW_ENABLE==0U))
+        /* A bypass top-half that has handled the hit on its own needs no signal */
+        if((Mcause<RME_RVM_PHYS_VCT_NUM)&&(RME_RV32P_Vct_Byp_Map[Mcause]!=0U))
         {
-            /* Set the vector flag */
-            __RME_RV32P_Flag_Slow(RME_RVM_PHYS_VCTF_BASE,RME_RVM_PHYS_VCTF_SIZE,Mcause);
+            if(__RME_RV32P_Vct_Byp(Mcause)==0U)
+            {
+                RME_RV32P_MSTATUS_FIX(Reg);
+                return;
+            }
+        }
 #endif
-            /* Send to the kernel endpoint */
-            _RME_Kern_Snd(RME_RV32P_Local.Sig_Vct,1U);
-            /* Pick the highest priority thread after we did all sends */
+
+        /* If the vector has its own endpoint, wake the driver in one hop. The
+         * vector is masked until the driver has serviced it and enables it again */
+        if(Mcause<RME_RVM_PHYS_VCT_NUM)
+            Sig=RME_RV32P_Vct_Sig[Mcause];
+        else
+            Sig=RME_NULL;
+        
+        if(Sig!=RME_NULL)
+        {
+            RME_RV32P_INT_STATE_DISABLE(Mcause);
+            _RME_Kern_Snd(Sig,1U);
             _RME_Kern_High(Reg,&RME_RV32P_Local);
-#if(RME_RVM_GEN_ENABLE!=0U)
         }
+        else
+        {
+#if(RME_RVM_GEN_ENABLE!=0U)
+            /* If the user wants to bypass, we skip the flag marshalling & sending process */
+            if(RME_Boot_Vct_Handler(Reg,Mcause)!=0U)
+            {
+                /* Set the vector flag */
+                __RME_RV32P_Flag_Slow(RME_RVM_PHYS_VCTF_BASE,RME_RVM_PHYS_VCTF_SIZE,Mcause);
 #endif
+                /* Send to the kernel endpoint */
+                _RME_Kern_Snd(RME_RV32P_Local.Sig_Vct,1U);
+                /* Pick the highest priority thread after we did all sends */
+                _RME_Kern_High(Reg,&RME_RV32P_Local);
+#if(RME_RVM_GEN_ENABLE!=0U)
+            }
+#endif
+        }
     }
     /* System call handler */
     else if(Mcause==RME_RV32P_MCAUSE_U_ECALL)
@@ -308,7 +565,8 @@ void _RME_RV32P_Handler(struct RME_Reg_Struct* Reg)
 /* Function:__RME_RV32P_Pgt_Entry_Mod *****************************************
 Description : Consult or modify the page table attributes. RV32P only allows
               consulting page table attributes but does not allow modifying them,
-              because there are no architecture-specific flags.
+              because there are no architecture-specific flags. The PMP miss
+              counter of a process can be read or cleared via its top-level.
 Input       : struct RME_Cap_Cpt* Cpt - The current capability table.
               rme_cid_t Cap_Pgt - The capability to the top-level page table to consult.
               rme_tid_t Vaddr - The virtual address to consult.
@@ -323,6 +581,7 @@ rme_ret_t __RME_RV32P_Pgt_Entry_Mod(struct RME_Cap_Cpt* Cpt,
                                     rme_ptr_t Type)
 {
     struct RME_Cap_Pgt* Pgt_Op;
+    struct __RME_RV32P_PMP_Data* Top_Data;
     rme_ptr_t Type_Stat;
     rme_ptr_t Size_Order;
     rme_ptr_t Num_Order;
@@ -332,6 +591,21 @@ rme_ret_t __RME_RV32P_Pgt_Entry_Mod(struct RME_Cap_Cpt* Cpt,
     RME_CPT_GETCAP(Cpt,Cap_Pgt,RME_CAP_TYPE_PGT,
                    struct RME_Cap_Pgt*,Pgt_Op,Type_Stat);
     
+    /* PMP miss counters are per-process, and live in the top-level */
+    if((Type==RME_RV32P_KFN_PGT_ENTRY_MOD_MISS_GET)||
+       (Type==RME_RV32P_KFN_PGT_ENTRY_MOD_MISS_CLR))
+    {
+        if(((Pgt_Op->Base)&RME_PGT_TOP)==0U)
+            return RME_ERR_KFN_FAIL;
+        
+        Top_Data=RME_RV32P_PGT_PMP(RME_CAP_GETOBJ(Pgt_Op,rme_ptr_t));
+        Flags=Top_Data->Miss;
+        if(Type==RME_RV32P_KFN_PGT_ENTRY_MOD_MISS_CLR)
+            Top_Data->Miss=0U;
+        
+        return (rme_ret_t)Flags;
+    }
+    
     Size_Order=0U;
     Num_Order=0U;
     Flags=0U;
@@ -353,16 +627,30 @@ rme_ret_t __RME_RV32P_Pgt_Entry_Mod(struct RME_Cap_Cpt* Cpt,
 
 /* Function:__RME_RV32P_Int_Local_Mod *****************************************
 Description : Consult or modify the local interrupt controller's vector state.
-Input       : rme_tid_t Int_Num - The interrupt number to consult or modify.
+              A vector can also be bound to its own signal endpoint, so that
+              its driver is woken directly rather than through Sig_Vct, and be
+              given a bypass top-half, which acknowledges the device and counts
+              hits in the handler, and only signals when it decides to.
+Input       : struct RME_Cap_Cpt* Cpt - The current capability table.
+              rme_tid_t Int_Num - The interrupt number to consult or modify.
               rme_tid_t Operation - The operation to conduct.
-              rme_tid_t Param - The parameter, could be state or priority.
+              rme_tid_t Param - The parameter, could be state, priority, or
+                                signal endpoint capability; RME_CID_NULL
+                                unbinds the endpoint. For the bypass top-half,
+                                the address of it in the caller's memory, with
+                                0 removing it.
 Output      : None.
 Return      : rme_ret_t - If successful, 0 or the desired value; else RME_ERR_KFN_FAIL.
 ******************************************************************************/
-rme_ret_t __RME_RV32P_Int_Local_Mod(rme_ptr_t Int_Num,
+rme_ret_t __RME_RV32P_Int_Local_Mod(struct RME_Cap_Cpt* Cpt,
+                                    rme_ptr_t Int_Num,
                                     rme_ptr_t Operation,
                                     rme_ptr_t Param)
 {
+#if((RME_RV32P_VCT_BYP_ENABLE!=0U)&&(RME_PGT_RAW_ENABLE==0U))
+    rme_ptr_t Hit;
+    
+#endif
     if(Int_Num>=RME_RVM_PHYS_VCT_NUM)
         return RME_ERR_KFN_FAIL;
     
@@ -391,6 +679,28 @@ rme_ret_t __RME_RV32P_Int_Local_Mod(rme_ptr_t Int_Num,
             RME_RV32P_INT_PRIO_SET(Int_Num,Param);
             break;
         }
+        case RME_RV32P_KFN_INT_LOCAL_MOD_SIG_SET:
+        {
+            return _RME_Kern_Sig_Bind(Cpt,
+                                      (rme_cid_t)Param,
+                                      &(RME_RV32P_Vct_Sig[Int_Num]));
+        }
+#if((RME_RV32P_VCT_BYP_ENABLE!=0U)&&(RME_PGT_RAW_ENABLE==0U))
+        case RME_RV32P_KFN_INT_LOCAL_MOD_BYP_SET:
+        {
+            return __RME_RV32P_Vct_Byp_Set(Int_Num,Param);
+        }
+        case RME_RV32P_KFN_INT_LOCAL_MOD_BYP_ACK:
+        {
+            if(RME_RV32P_Vct_Byp_Map[Int_Num]==0U)
+                return RME_ERR_KFN_FAIL;
+            
+            /* The kernel runs with interrupts off, so no hit can come in between */
+            Hit=RME_RV32P_Vct_Byp[RME_RV32P_Vct_Byp_Map[Int_Num]-1U].Hit;
+            RME_RV32P_Vct_Byp[RME_RV32P_Vct_Byp_Map[Int_Num]-1U].Hit=0U;
+            return (rme_ret_t)Hit;
+        }
+#endif
         default:return RME_ERR_KFN_FAIL;
     }
 
@@ -780,7 +1090,8 @@ rme_ret_t __RME_Kfn_Handler(struct RME_Cap_Cpt* Cpt,
 /* Interrupt controller operations *******************************************/
         case RME_KFN_INT_LOCAL_MOD:
         {
-            Retval=__RME_RV32P_Int_Local_Mod(Sub_ID,
+            Retval=__RME_RV32P_Int_Local_Mod(Cpt,
+                                             Sub_ID,
                                              Param1,
                                              Param2);
             break;
@@ -975,6 +1286,9 @@ Return      : None.
 void __RME_Lowlvl_Init(void)
 {
     RME_RV32P_LOWLVL_INIT();
+    
+    /* Let user mode read the cycle counter */
+    ___RME_RV32P_MCOUNTEREN_Set(RME_RV32P_MCOUNTEREN_INIT);
 
     /* Initialize CPU-local data structures */
     _RME_CPU_Local_Init(&RME_RV32P_Local,__RME_CPUID_Get());
@@ -1192,6 +1506,26 @@ void __RME_Svc_Retval_Set(struct RME_Reg_Struct* Reg,
 }
 /* End Function:__RME_Svc_Retval_Set *****************************************/
 
+/* Function:__RME_Svc_Pgr_Set *************************************************
+Description : Set the fault information for a pager thread that is woken up
+              by a fault. A0 carries the signal number as usual; A3 carries
+              MTVAL, which is the fault address for access faults.
+Input       : rme_ptr_t TID - The thread ID of the faulting thread.
+              struct RME_Exc_Struct* Exc - The fault information.
+Output      : struct RME_Reg_Struct* Reg - The register set of the pager.
+Return      : None.
+******************************************************************************/
+void __RME_Svc_Pgr_Set(struct RME_Reg_Struct* Reg,
+                       rme_ptr_t TID,
+                       struct RME_Exc_Struct* Exc)
+{
+    Reg->X11_A1=TID;
+    Reg->X12_A2=Exc->Cause;
+    Reg->X13_A3=Exc->Value;
+    Reg->X14_A4=Exc->Addr;
+}
+/* End Function:__RME_Svc_Pgr_Set ********************************************/
+
 /* Function:__RME_Thd_Reg_Init ************************************************
 Description : Initialize the register set for the thread.
 Input       : rme_ptr_t Attr - The context attributes.
@@ -1823,6 +2157,8 @@ rme_ret_t __RME_Pgt_Init(struct RME_Cap_Pgt* Pgt_Op)
     if(((Pgt_Op->Base)&RME_PGT_TOP)!=0U)
     {
         ((struct __RME_RV32P_PMP_Data*)Ptr)->Static=0U;
+        ((struct __RME_RV32P_PMP_Data*)Ptr)->Hand=0U;
+        ((struct __RME_RV32P_PMP_Data*)Ptr)->Miss=0U;
         for(Count=0U;Count<RME_RV32P_PMPCFG_NUM;Count++)
             ((struct __RME_RV32P_PMP_Data*)Ptr)->Raw.Cfg[Count]=0U;
         for(Count=0U;Count<RME_RV32P_REGION_NUM;Count++)
@@ -1833,13 +2169,23 @@ rme_ret_t __RME_Pgt_Init(struct RME_Cap_Pgt* Pgt_Op)
         for(Count=RME_RV32P_REGION_NUM;Count<RME_RV32P_PMPCFG_NUM*sizeof(rme_ptr_t);Count++)
             Cfg[Count]=0x18U;
 
+#if(RME_PGT_WALK_CACHE_NUM!=0U)
+        ((struct __RME_RV32P_PMP_Data*)Ptr)->Cache_Hand=0U;
+        for(Count=0U;Count<RME_PGT_WALK_CACHE_NUM;Count++)
+            ((struct __RME_RV32P_PMP_Data*)Ptr)->Cache[Count].Meta=RME_NULL;
+#endif
+
         Ptr+=sizeof(struct __RME_RV32P_PMP_Data)/sizeof(rme_ptr_t);
     }
 
     /* Clean up the table itself - This is could be virtually unbounded if the user
-     * pass in some very large length value. Need to restrict this. */
-    for(Count=0U;Count<RME_POW2(RME_PGT_NMORD(Pgt_Op->Order));Count++)
-        Ptr[Count]=0U;
+     * pass in some very large length value. Need to restrict this.
+     * This is skipped if the table was zeroed in advance. */
+    if(RME_KOT_CLEAN_CHK(Ptr,RME_POW2(RME_PGT_NMORD(Pgt_Op->Order))*RME_WORD_BYTE)==0U)
+    {
+        for(Count=0U;Count<RME_POW2(RME_PGT_NMORD(Pgt_Op->Order));Count++)
+            Ptr[Count]=0U;
+    }
 
     return 0;
 }
@@ -1885,6 +2231,11 @@ Return      : rme_ret_t - If can be deleted, 0; else RME_ERR_HAL_FAIL.
 rme_ret_t __RME_Pgt_Del_Check(struct RME_Cap_Pgt* Pgt_Op)
 {
     /* No special property to check */
+#if((RME_RV32P_VCT_BYP_ENABLE!=0U)&&(RME_PGT_RAW_ENABLE==0U))
+    /* The pages in it go away with it */
+    __RME_RV32P_Vct_Byp_Drop((Pgt_Op->Base)&(~RME_PGT_TOP),
+                             RME_PGT_SZORD(Pgt_Op->Order)+RME_PGT_NMORD(Pgt_Op->Order));
+#endif
     return 0;
 }
 /* End Function:__RME_Pgt_Del_Check ******************************************/
@@ -1896,6 +2247,7 @@ Input       : None.
 Output      : None.
 Return      : rme_ptr_t - The random number returned.
 ******************************************************************************/
+#if(RME_RV32P_PMP_REPL!=RME_RV32P_PMP_REPL_FIFO)
 rme_ptr_t __RME_RV32P_Rand(void)
 {   
     static rme_ptr_t LFSR=0xACE1ACE1U;
@@ -1910,10 +2262,14 @@ rme_ptr_t __RME_RV32P_Rand(void)
     
     return LFSR;
 }
+#endif
 /* End Function:__RME_RV32P_Rand *********************************************/
 
 /* Function:___RME_RV32P_PMP_Decode *******************************************
-Description : Decode PMP register data into stuff easier for processing.
+Description : Decode PMP register data into stuff easier for processing. A TOR
+              range either takes a disabled entry holding its start address and
+              the TOR entry, or only the TOR entry when its start address is the
+              end address of the TOR range before it, or zero for the first entry.
 Input       : struct __RME_RV32P_PMP_Data* Top_Data - The PMP data.
 Output      : struct __RME_RV32P_PMP_Range* Range - The decoded ranges.
 Return      : rme_ptr_t - The number of regions that are present.
@@ -1931,10 +2287,9 @@ rme_ptr_t ___RME_RV32P_PMP_Decode(struct __RME_RV32P_PMP_Data* Top_Data,
 
     while(Data_Cnt<RME_RV32P_REGION_NUM)
     {
-        /* This region itself contains data - NA4 won't be used */
-        if(Cfg[Data_Cnt]!=0U)
+        /* This region is a NAPOT range itself - NA4 won't be used */
+        if(RME_RV32P_PMP_MODE(Cfg[Data_Cnt])==RME_RV32P_PMP_NAPOT)
         {
-            RME_ASSERT(RME_RV32P_PMP_MODE(Cfg[Data_Cnt])==RME_RV32P_PMP_NAPOT);
             Range[Range_Cnt].Flag=RME_RV32P_PMP_PERM(Cfg[Data_Cnt]);
             Range[Range_Cnt].Order_Div4=_RME_LSB_Generic(~Top_Data->Raw.Addr[Data_Cnt])+1U;
             Range[Range_Cnt].Start_Div4=Top_Data->Raw.Addr[Data_Cnt]&RME_MASK_BEGIN(Range[Range_Cnt].Order_Div4);
@@ -1943,6 +2298,19 @@ rme_ptr_t ___RME_RV32P_PMP_Decode(struct __RME_RV32P_PMP_Data* Top_Data,
             Range_Cnt++;
             Data_Cnt++;
         }
+        /* This region is a TOR range that starts where the last entry ends */
+        else if(RME_RV32P_PMP_MODE(Cfg[Data_Cnt])==RME_RV32P_PMP_TOR)
+        {
+            Range[Range_Cnt].Flag=RME_RV32P_PMP_PERM(Cfg[Data_Cnt]);
+            if(Data_Cnt==0U)
+                Range[Range_Cnt].Start_Div4=0U;
+            else
+                Range[Range_Cnt].Start_Div4=Top_Data->Raw.Addr[Data_Cnt-1U];
+            Range[Range_Cnt].End_Div4=Top_Data->Raw.Addr[Data_Cnt];
+            Range[Range_Cnt].Order_Div4=0U;
+            Range_Cnt++;
+            Data_Cnt++;
+        }
         /* The region itself is empty, but what it follows may contain data in TOR mode */
         else
         {
@@ -2007,33 +2375,168 @@ void ___RME_RV32P_PMP_Range_Del(struct __RME_RV32P_PMP_Range* Range,
 }
 /* End Function:___RME_RV32P_PMP_Range_Del ***********************************/
 
+/* Function:___RME_RV32P_PMP_Range_Merge **************************************
+Description : Merge neighboring ranges that have the same permissions and are at
+              most a certain distance apart. A nonzero distance makes the memory
+              between the two ranges accessible as well, so this is only used
+              when the ranges would not fit otherwise.
+Input       : struct __RME_RV32P_PMP_Range* Range - The memory ranges.
+              rme_ptr_t Number - The number of memory ranges.
+              rme_ptr_t Gap_Div4 - The maximum distance between two ranges.
+              rme_ptr_t* Add - The position of entry just added.
+Output      : struct __RME_RV32P_PMP_Range* Range - The changed ranges.
+              rme_ptr_t* Add - The new position of entry just added.
+Return      : rme_ptr_t - The number of memory ranges after merging.
+******************************************************************************/
+rme_ptr_t ___RME_RV32P_PMP_Range_Merge(struct __RME_RV32P_PMP_Range* Range,
+                                       rme_ptr_t Number,
+                                       rme_ptr_t Gap_Div4,
+                                       rme_ptr_t* Add)
+{
+    rme_ptr_t Count;
+
+    Count=1U;
+    while(Count<Number)
+    {
+        if(((Range[Count].Start_Div4-Range[Count-1U].End_Div4)<=Gap_Div4)&&
+           (RME_RV32P_PGT_MERGE(Range[Count-1U].Flag)==RME_RV32P_PGT_MERGE(Range[Count].Flag)))
+        {
+            /* Concatenate the ranges, and use aggregated flags from both sides */
+            Range[Count-1U].End_Div4=Range[Count].End_Div4;
+            Range[Count-1U].Flag|=Range[Count].Flag;
+            ___RME_RV32P_PMP_Range_Del(Range,Number,Count);
+            Number--;
+
+            if(*Add>=Count)
+                (*Add)--;
+        }
+        else
+            Count++;
+    }
+
+    return Number;
+}
+/* End Function:___RME_RV32P_PMP_Range_Merge *********************************/
+
 /* Function:___RME_RV32P_PMP_Range_Entry **************************************
-Description : Check the number of entries used with the regions.
+Description : Decide whether each range uses NAPOT or TOR, and check the number of
+              entries used with the regions. A NAPOT range uses one entry but must
+              be naturally aligned. A TOR range uses two entries, or only one if
+              the range before it is also TOR and ends exactly where it starts,
+              because the TOR entry takes the address of the entry before it as
+              its start; for the first range, this start is zero. Finding the
+              cheapest choice is a walk over the ranges that remembers the best
+              cost with the last range in either mode, so it takes linear time.
 Input       : struct __RME_RV32P_PMP_Range* Range - The memory ranges.
               rme_ptr_t Number - The number of memory ranges.
-Output      : None.
+Output      : struct __RME_RV32P_PMP_Range* Range - The changed ranges.
 Return      : rme_ptr_t - The number of entries used.
 ******************************************************************************/
 rme_ptr_t ___RME_RV32P_PMP_Range_Entry(struct __RME_RV32P_PMP_Range* Range,
                                        rme_ptr_t Number)
 {
     rme_ptr_t Count;
+    rme_ptr_t Size_Div4;
+    rme_ptr_t Napot_Cost;
+    rme_ptr_t Tor_Cost;
+    rme_ptr_t Napot_Last;
+    rme_ptr_t Tor_Last;
+    rme_ptr_t Tor;
     rme_ptr_t Total;
+    /* Whether the best choice for each range in each mode follows a TOR range */
+    rme_u8_t Napot_From_Tor[RME_RV32P_REGION_NUM+1U];
+    rme_u8_t Tor_From_Tor[RME_RV32P_REGION_NUM+1U];
 
-    Total=0U;
+    if(Number==0U)
+        return 0U;
+
+    /* Unreachable cost - never more entries than twice the ranges */
+    Napot_Last=RME_MASK_FULL>>1;
+    Tor_Last=RME_MASK_FULL>>1;
 
     for(Count=0U;Count<Number;Count++)
     {
-        /* TOR ranges use two entries */
-        if(Range[Count].Order_Div4==0U)
+        /* NAPOT takes one entry, and needs a naturally aligned size of at least 16 bytes */
+        Size_Div4=Range[Count].End_Div4-Range[Count].Start_Div4;
+        if((Size_Div4>=4U)&&((Size_Div4&(Size_Div4-1U))==0U)&&
+           ((Range[Count].Start_Div4&(Size_Div4-1U))==0U))
+        {
+            Range[Count].Order_Div4=RME_MSB_GET(Size_Div4);
+            if(Count==0U)
+            {
+                Napot_Cost=1U;
+                Napot_From_Tor[Count]=0U;
+            }
+            else if(Tor_Last<Napot_Last)
+            {
+                Napot_Cost=Tor_Last+1U;
+                Napot_From_Tor[Count]=1U;
+            }
+            else
+            {
+                Napot_Cost=Napot_Last+1U;
+                Napot_From_Tor[Count]=0U;
+            }
+        }
+        else
+        {
+            Range[Count].Order_Div4=0U;
+            Napot_Cost=RME_MASK_FULL>>1;
+            Napot_From_Tor[Count]=0U;
+        }
+
+        /* TOR takes one entry if the start address is already there, two otherwise */
+        if(Count==0U)
         {
-            Total+=2U;
+            if(Range[Count].Start_Div4==0U)
+                Tor_Cost=1U;
+            else
+                Tor_Cost=2U;
+            Tor_From_Tor[Count]=0U;
         }
-        /* NAPOT ranges use one entry */
         else
         {
-            Total++;
+            if(Range[Count-1U].End_Div4==Range[Count].Start_Div4)
+                Tor_Cost=Tor_Last+1U;
+            else
+                Tor_Cost=Tor_Last+2U;
+
+            if((Napot_Last+2U)<=Tor_Cost)
+            {
+                Tor_Cost=Napot_Last+2U;
+                Tor_From_Tor[Count]=0U;
+            }
+            else
+                Tor_From_Tor[Count]=1U;
+        }
+
+        Napot_Last=Napot_Cost;
+        Tor_Last=Tor_Cost;
+    }
+
+    /* Trace back the choices, preferring NAPOT on ties */
+    if(Tor_Last<Napot_Last)
+    {
+        Tor=1U;
+        Total=Tor_Last;
+    }
+    else
+    {
+        Tor=0U;
+        Total=Napot_Last;
+    }
+
+    Count=Number;
+    while(Count>0U)
+    {
+        Count--;
+        if(Tor!=0U)
+        {
+            Range[Count].Order_Div4=0U;
+            Tor=Tor_From_Tor[Count];
         }
+        else
+            Tor=Napot_From_Tor[Count];
     }
 
     return Total;
@@ -2042,21 +2545,46 @@ rme_ptr_t ___RME_RV32P_PMP_Range_Entry(struct __RME_RV32P_PMP_Range* Range,
 
 /* Function:___RME_RV32P_PMP_Range_Kick ***************************************
 Description : Find an entry that could be kicked out, except for the entry we
-              just added.
+              just added. With the FIFO policy, the hand sweeps the ranges and
+              takes the next dynamic one, so ranges roughly leave in the order
+              they came in; merging and kicking shift the ranges around, so the
+              order is not exact. The PMP keeps no record of accesses, so there
+              is nothing better than load order to go by here. A cyclic working
+              set larger than the PMP thus misses on every access under FIFO,
+              which is why the random policy is the default.
 Input       : struct __RME_RV32P_PMP_Range* Range - The memory ranges.
               rme_ptr_t Number - The number of memory ranges.
               rme_ptr_t Add - The position of entry just added.
-Output      : None.
+              rme_ptr_t* Hand - The FIFO hand.
+Output      : rme_ptr_t* Hand - The updated FIFO hand.
 Return      : rme_ptr_t - The position to kick out.
 ******************************************************************************/
 rme_ptr_t ___RME_RV32P_PMP_Range_Kick(struct __RME_RV32P_PMP_Range* Range,
                                       rme_ptr_t Number,
-                                      rme_ptr_t Add)
+                                      rme_ptr_t Add,
+                                      rme_ptr_t* Hand)
 {
     rme_ptr_t Rand;
     rme_ptr_t Count;
     rme_ptr_t Entry;
 
+#if(RME_RV32P_PMP_REPL==RME_RV32P_PMP_REPL_FIFO)
+    /* Try to kick the next dynamic range */
+    Rand=*Hand;
+    for(Count=0U;Count<Number;Count++)
+    {
+        Entry=(Rand+Count)%Number;
+        if(Entry==Add)
+        {
+            continue;
+        }
+        else if((Range[Entry].Flag&RME_PGT_STATIC)==0U)
+        {
+            *Hand=Entry+1U;
+            return Entry;
+        }
+    }
+#else
     /* Try to kick a dynamic range */
     Rand=__RME_RV32P_Rand();
     for(Count=0U;Count<Number;Count++)
@@ -2071,6 +2599,7 @@ rme_ptr_t ___RME_RV32P_PMP_Range_Kick(struct __RME_RV32P_PMP_Range* Range,
             return Entry;
         }
     }
+#endif
 
     /* Cannot find a dynamic one, kick a static range */
     Entry=Rand%Number;
@@ -2082,18 +2611,25 @@ rme_ptr_t ___RME_RV32P_PMP_Range_Kick(struct __RME_RV32P_PMP_Range* Range,
 /* End Function:___RME_RV32P_PMP_Range_Kick **********************************/
 
 /* Function:___RME_RV32P_PMP_Add **********************************************
-Description : Add an entry into the ranges.
+Description : Add an entry into the ranges. The ranges are packed after this:
+              neighboring ranges with the same permissions are merged, and each
+              range is encoded in the way that uses the least entries. If they
+              still do not fit, ranges closer than RME_RV32P_PMP_COAL_TOL are
+              merged as well, and at last some ranges are kicked out.
 Input       : struct __RME_RV32P_PMP_Range* Range - The memory ranges.
               rme_ptr_t Number - The number of memory ranges.
+              rme_ptr_t* Hand - The FIFO hand.
               rme_ptr_t Paddr - The physical address of the page to add.
               rme_ptr_t Size_Order - The page size order.
               rme_ptr_t Flag - The flags.
 Output      : struct __RME_RV32P_PMP_Range* Range - The changed ranges.
+              rme_ptr_t* Hand - The updated FIFO hand.
 Return      : rme_ret_t - If successful, the current number of ranges; else
                           RME_ERR_HAL_FAIL.
 ******************************************************************************/
 rme_ret_t ___RME_RV32P_PMP_Add(struct __RME_RV32P_PMP_Range* Range,
                                rme_ptr_t Number,
+                               rme_ptr_t* Hand,
                                rme_ptr_t Paddr,
                                rme_ptr_t Size_Order,
                                rme_ptr_t Flag)
@@ -2101,127 +2637,65 @@ rme_ret_t ___RME_RV32P_PMP_Add(struct __RME_RV32P_PMP_Range* Range,
     rme_ptr_t Count;
     rme_ptr_t Start_Div4;
     rme_ptr_t End_Div4;
-    rme_ptr_t Size_Div4;
-    rme_ptr_t Order_Div4;
-    rme_ptr_t Left;
-    rme_ptr_t Right;
-    rme_ptr_t Number_New;
+    rme_ptr_t Add;
 
     /* All PMP addresses are [33:2], thus no UB */
     Start_Div4=Paddr>>2U;
-    Order_Div4=Size_Order-2U;
-    End_Div4=Start_Div4+RME_POW2(Order_Div4);
+    End_Div4=Start_Div4+RME_POW2(Size_Order-2U);
 
     /* There are existing entries, look them up */
-    Left=0U;
-    Right=0U;
+    Count=0U;
     if(Number!=0U)
     {
         /* Mapping in a 4GiB page. nothing must be existent, or we have a fault */
         if(Size_Order>=RME_WORD_BIT)
             return RME_ERR_HAL_FAIL;
-        /* Mapping in a page smaller than 4GiB */
-        else
-        {
-            /* Is this ever in the ranges? If yes, then there must be a permission conflict */
-            for(Count=0U;Count<Number;Count++)
-            {
-                if(((Start_Div4>=Range[Number].Start_Div4)&&(Start_Div4<Range[Number].End_Div4))||
-                   ((End_Div4>=Range[Number].Start_Div4)&&(End_Div4<Range[Number].End_Div4)))
-                {
-                    return RME_ERR_HAL_FAIL;
-                }
-            }
 
-            /* No. Find the possible position of this page between the ranges */
-            for(Count=0U;Count<Number;Count++)
-            {
-                if(Start_Div4<Range[Number].Start_Div4)
-                {
-                    break;
-                }
-            }
+        /* Is this ever in the ranges? If yes, then there must be a permission conflict */
+        for(Count=0U;Count<Number;Count++)
+        {
+            if((Start_Div4<Range[Count].End_Div4)&&(End_Div4>Range[Count].Start_Div4))
+                return RME_ERR_HAL_FAIL;
+        }
 
-            /* Check possible adjacent ranges for possible mergers */
-            if((Count>0U)&&
-               (Range[Count-1U].End_Div4==Start_Div4)&&
-               (RME_RV32P_PGT_MERGE(Range[Count-1U].Flag)==RME_RV32P_PGT_MERGE(Flag)))
-            {
-                Left=1U;
-            }
-            else if((Count<Number)&&
-                    (Range[Count].Start_Div4==End_Div4)&&
-                    (RME_RV32P_PGT_MERGE(Range[Count].Flag)==RME_RV32P_PGT_MERGE(Flag)))
-            {
-                Right=1U;
-            }
+        /* No. Find the possible position of this page between the ranges */
+        for(Count=0U;Count<Number;Count++)
+        {
+            if(Start_Div4<Range[Count].Start_Div4)
+                break;
         }
     }
-    /* If there are no existing ranges, Don't bother */
-    else
-    {
-        Count=0U;
-    }
 
-    /* Merge with both sides */
-    if((Left!=0U)&&(Right!=0U))
-    {
-        /* Concatenate all ranges */
-        Range[Count-1U].End_Div4=Range[Count].End_Div4;
-        /* Should we use NAPOT or TOR? */
-        RME_RV32P_PGT_MODE(Range[Count-1U]);
-        /* Use aggregated flags from both sides */
-        Range[Count-1U].Flag|=Flag|Range[Count].Flag;
-        /* Clear the region that follow, range # decreases */
-        ___RME_RV32P_PMP_Range_Del(Range,Number,Count);
-        Number_New=Number-1U;
-        Count--;
-    }
-    /* Merge with left side only */
-    else if(Left!=0U)
-    {
-        Range[Count-1U].End_Div4=End_Div4;
-        /* Should we use NAPOT or TOR? */
-        RME_RV32P_PGT_MODE(Range[Count-1U]);
-        /* Use aggregated flags from left */
-        Range[Count-1U].Flag|=Flag;
-        /* Range # doesn't change */
-        Number_New=Number;
-        Count--;
-    }
-    /* Merge with right side only, range # may increase */
-    else if(Right!=0U)
-    {
-        Range[Count].Start_Div4=Start_Div4;
-        /* Should we use NAPOT or TOR? */
-        RME_RV32P_PGT_MODE(Range[Count]);
-        /* Use aggregated flags from right */
-        Range[Count].Flag|=Flag;
-        /* Range # doesn't change */
-        Number_New=Number;
-    }
-    /* Consider adding a new entry, range # will increase */
-    else
-    {
-        /* Make room for the new entry, with NAPOT */
-        ___RME_RV32P_PMP_Range_Ins(Range,Number,Count);
-        Range[Count].Start_Div4=Start_Div4;
-        Range[Count].End_Div4=End_Div4;
-        Range[Count].Order_Div4=Order_Div4;
-        Range[Count].Flag=Flag;
-        /* Range # increases */
-        Number_New=Number+1U;
-    }
+    /* Make room for the new entry */
+    ___RME_RV32P_PMP_Range_Ins(Range,Number,Count);
+    Range[Count].Start_Div4=Start_Div4;
+    Range[Count].End_Div4=End_Div4;
+    Range[Count].Order_Div4=0U;
+    Range[Count].Flag=Flag;
+    Number++;
+    Add=Count;
+
+    /* Merge with adjacent ranges that have the same permissions */
+    Number=___RME_RV32P_PMP_Range_Merge(Range,Number,0U,&Add);
+
+#if(RME_RV32P_PMP_COAL_TOL!=0U)
+    /* Bridge small gaps between ranges, if this makes them fit */
+    if(___RME_RV32P_PMP_Range_Entry(Range,Number)>RME_RV32P_REGION_NUM)
+        Number=___RME_RV32P_PMP_Range_Merge(Range,Number,RME_RV32P_PMP_COAL_TOL>>2,&Add);
+#endif
 
     /* We've exceeded the PMP entry capacity, need to kick someone out */
-    if(___RME_RV32P_PMP_Range_Entry(Range,Number_New)>RME_RV32P_REGION_NUM)
+    while(___RME_RV32P_PMP_Range_Entry(Range,Number)>RME_RV32P_REGION_NUM)
     {
-        Count=___RME_RV32P_PMP_Range_Kick(Range,Number_New,Count);
-        ___RME_RV32P_PMP_Range_Del(Range,Number_New,Count);
-        Number_New--;
+        Count=___RME_RV32P_PMP_Range_Kick(Range,Number,Add,Hand);
+        ___RME_RV32P_PMP_Range_Del(Range,Number,Count);
+        Number--;
+
+        if(Add>Count)
+            Add--;
     }
 
-    return (rme_ret_t)Number_New;
+    return (rme_ret_t)Number;
 }
 /* End Function:___RME_RV32P_PMP_Add *****************************************/
 
@@ -2258,14 +2732,26 @@ void ___RME_RV32P_PMP_Encode(struct __RME_RV32P_PMP_Data* Top_Data,
     /* Decide best use of the entries */
     for(Range_Cnt=0U;Range_Cnt<Number;Range_Cnt++)
     {
-        /* Using TOR - using 2 entries */
+        /* Using TOR - using 1 entry if the last TOR entry ends where we start */
         if(Range[Range_Cnt].Order_Div4==0U)
         {
-            Cfg[Data_Cnt]=0U;
-            Top_Data->Raw.Addr[Data_Cnt]=Range[Range_Cnt].Start_Div4;
-            Cfg[Data_Cnt+1U]=RME_RV32P_PGT_MERGE(Range[Range_Cnt].Flag)|RME_RV32P_PMP_TOR;
-            Top_Data->Raw.Addr[Data_Cnt+1U]=Range[Range_Cnt].End_Div4;
-            Data_Cnt+=2;
+            if(((Range_Cnt==0U)&&(Range[Range_Cnt].Start_Div4==0U))||
+               ((Range_Cnt!=0U)&&(Range[Range_Cnt-1U].Order_Div4==0U)&&
+                (Range[Range_Cnt-1U].End_Div4==Range[Range_Cnt].Start_Div4)))
+            {
+                Cfg[Data_Cnt]=RME_RV32P_PGT_MERGE(Range[Range_Cnt].Flag)|RME_RV32P_PMP_TOR;
+                Top_Data->Raw.Addr[Data_Cnt]=Range[Range_Cnt].End_Div4;
+                Data_Cnt++;
+            }
+            /* Using TOR - using 2 entries */
+            else
+            {
+                Cfg[Data_Cnt]=0U;
+                Top_Data->Raw.Addr[Data_Cnt]=Range[Range_Cnt].Start_Div4;
+                Cfg[Data_Cnt+1U]=RME_RV32P_PGT_MERGE(Range[Range_Cnt].Flag)|RME_RV32P_PMP_TOR;
+                Top_Data->Raw.Addr[Data_Cnt+1U]=Range[Range_Cnt].End_Div4;
+                Data_Cnt+=2U;
+            }
         }
         /* Using NAPOT - using 1 entry */
         else
@@ -2313,12 +2799,13 @@ rme_ret_t ___RME_RV32P_PMP_Update(struct __RME_RV32P_Pgt_Meta* Top_Meta,
     Number=___RME_RV32P_PMP_Decode(Top_Data,Range);
 
     /* Try to add the page into these ranges */
-    Number=___RME_RV32P_PMP_Add(Range,Number,Paddr,Size_Order,Flag);
+    Number=___RME_RV32P_PMP_Add(Range,Number,&(Top_Data->Hand),Paddr,Size_Order,Flag);
     if(Number<0)
         return RME_ERR_HAL_FAIL;
 
     /* Encode things back, kicking out */
     ___RME_RV32P_PMP_Encode(Top_Data,Range,Number);
+    Top_Data->Miss++;
 
     return 0;
 }
@@ -2398,8 +2885,17 @@ rme_ret_t __RME_Pgt_Page_Unmap(struct RME_Cap_Pgt* Pgt_Op,
        ((Table[Pos]&RME_RV32P_PGT_TERMINAL)==0U))
         return RME_ERR_HAL_FAIL;
 
+#if(RME_RV32P_VCT_BYP_ENABLE!=0U)
+    /* No top-half may touch the page once it is gone */
+    __RME_RV32P_Vct_Byp_Drop(((Pgt_Op->Base)&(~RME_PGT_TOP))+(Pos<<RME_PGT_SZORD(Pgt_Op->Order)),
+                             RME_PGT_SZORD(Pgt_Op->Order));
+#endif
     /* We don't update the PMP: if mapping removal is needed, do a manual flush */
     Table[Pos]=0U;
+#if(RME_PGT_WALK_CACHE_NUM!=0U)
+    /* Invalidate all walk cache entries */
+    RME_RV32P_Pgt_Gen++;
+#endif
 
     return 0;
 }
@@ -2488,8 +2984,17 @@ rme_ret_t __RME_Pgt_Pgdir_Unmap(struct RME_Cap_Pgt* Pgt_Parent,
     if(Child_Meta!=RME_CAP_GETOBJ(Pgt_Child,struct __RME_RV32P_Pgt_Meta*))
         return RME_ERR_HAL_FAIL;
 
+#if(RME_RV32P_VCT_BYP_ENABLE!=0U)
+    /* No top-half may touch the pages of the directory once it is gone */
+    __RME_RV32P_Vct_Byp_Drop((Pgt_Child->Base)&(~RME_PGT_TOP),
+                             RME_PGT_SZORD(Pgt_Child->Order)+RME_PGT_NMORD(Pgt_Child->Order));
+#endif
     /* We don't update the PMP: if mapping removal is needed, do a manual flush */
     Table[Pos]=0U;
+#if(RME_PGT_WALK_CACHE_NUM!=0U)
+    /* Invalidate all walk cache entries */
+    RME_RV32P_Pgt_Gen++;
+#endif
 
     return 0;
 }
@@ -2537,6 +3042,73 @@ rme_ret_t __RME_Pgt_Lookup(struct RME_Cap_Pgt* Pgt_Op,
 }
 /* End Function:__RME_Pgt_Lookup *********************************************/
 
+/* Function:___RME_RV32P_Pgt_Cache_Find ***************************************
+Description : Look up a virtual address in the walk cache of a top-level page
+              table. Entries filled in before the last unmapping are stale.
+Input       : struct __RME_RV32P_Pgt_Meta* Top - The top-level page table.
+              rme_ptr_t Vaddr - The virtual address to look up.
+Output      : None.
+Return      : struct __RME_RV32P_Pgt_Cache* - The cache entry, or RME_NULL if missed.
+******************************************************************************/
+#if((RME_PGT_RAW_ENABLE==0U)&&(RME_PGT_WALK_CACHE_NUM!=0U))
+struct __RME_RV32P_Pgt_Cache* ___RME_RV32P_Pgt_Cache_Find(struct __RME_RV32P_Pgt_Meta* Top,
+                                                          rme_ptr_t Vaddr)
+{
+    rme_ptr_t Count;
+    struct __RME_RV32P_Pgt_Cache* Cache;
+
+    for(Count=0U;Count<RME_PGT_WALK_CACHE_NUM;Count++)
+    {
+        Cache=&(RME_RV32P_PGT_PMP(Top)->Cache[Count]);
+        if((Cache->Meta!=RME_NULL)&&(Cache->Gen==RME_RV32P_Pgt_Gen)&&
+           (Vaddr>=Cache->Start)&&(Vaddr<=Cache->End))
+            return Cache;
+    }
+
+    return RME_NULL;
+}
+#endif
+/* End Function:___RME_RV32P_Pgt_Cache_Find **********************************/
+
+/* Function:___RME_RV32P_Pgt_Cache_Fill ***************************************
+Description : Remember a page found by a walk in the walk cache of a top-level
+              page table. The entries are replaced in a round-robin fashion.
+Input       : struct __RME_RV32P_Pgt_Meta* Top - The top-level page table.
+              struct __RME_RV32P_Pgt_Meta* Meta - The page directory of the page.
+              rme_ptr_t Start - The start address of the page.
+              rme_ptr_t Flag - The RME standard flags of the page.
+Output      : None.
+Return      : None.
+******************************************************************************/
+#if((RME_PGT_RAW_ENABLE==0U)&&(RME_PGT_WALK_CACHE_NUM!=0U))
+void ___RME_RV32P_Pgt_Cache_Fill(struct __RME_RV32P_Pgt_Meta* Top,
+                                 struct __RME_RV32P_Pgt_Meta* Meta,
+                                 rme_ptr_t Start,
+                                 rme_ptr_t Flag)
+{
+    struct __RME_RV32P_PMP_Data* Top_Data;
+    struct __RME_RV32P_Pgt_Cache* Cache;
+
+    Top_Data=RME_RV32P_PGT_PMP(Top);
+    Cache=&(Top_Data->Cache[Top_Data->Cache_Hand]);
+
+    Cache->Gen=RME_RV32P_Pgt_Gen;
+    Cache->Start=Start;
+    /* Shifting by RME_WORD_BIT or more is UB */
+    if(RME_PGT_SZORD(Meta->Order)>=RME_WORD_BIT)
+        Cache->End=RME_MASK_FULL;
+    else
+        Cache->End=Start+RME_POW2(RME_PGT_SZORD(Meta->Order))-1U;
+    Cache->Flag=Flag;
+    Cache->Meta=Meta;
+
+    Top_Data->Cache_Hand++;
+    if(Top_Data->Cache_Hand>=RME_PGT_WALK_CACHE_NUM)
+        Top_Data->Cache_Hand=0U;
+}
+#endif
+/* End Function:___RME_RV32P_Pgt_Cache_Fill **********************************/
+
 /* Function:__RME_Pgt_Walk ****************************************************
 Description : Walking function for the page table. This function just does page
               table lookups. The page table that is being walked must be the top-
@@ -2562,81 +3134,99 @@ rme_ret_t __RME_Pgt_Walk(struct RME_Cap_Pgt* Pgt_Op,
                          rme_ptr_t* Flag)
 {
     struct __RME_RV32P_Pgt_Meta* Meta;
+    struct __RME_RV32P_Pgt_Cache* Cache;
     rme_ptr_t* Table;
     rme_u8_t* Flagtbl;
     rme_ptr_t Pos;
     rme_ptr_t Shift;
+    rme_ptr_t Start;
     rme_ptr_t Num;
+    rme_ptr_t Page_Flag;
     rme_u8_t Flag_Final;
+#if(RME_PGT_WALK_CACHE_NUM!=0U)
+    struct __RME_RV32P_Pgt_Meta* Top;
+#endif
 
     /* This must the top-level page table */
     RME_ASSERT(((Pgt_Op->Base)&RME_PGT_TOP)!=0U);
 
-    /* Get the table and start lookup */
+    /* Get the table and see if the page was walked to recently */
     Meta=RME_CAP_GETOBJ(Pgt_Op,struct __RME_RV32P_Pgt_Meta*);
-    Table=RME_RV32P_PGT_TBL_TOP(Meta);
+#if(RME_PGT_WALK_CACHE_NUM!=0U)
+    Top=Meta;
+    Cache=___RME_RV32P_Pgt_Cache_Find(Top,Vaddr);
+#else
+    Cache=RME_NULL;
+#endif
 
-    /* Do lookup recursively */
-    Flag_Final=RME_PGT_ALL_PERM;
-    while(1)
+    if(Cache!=RME_NULL)
     {
-        /* Check if the virtual address is in our range */
-        if(Vaddr<RME_PGT_BASE(Meta->Base))
-            return RME_ERR_HAL_FAIL;
-        /* Calculate entry position - shifting by RME_WORD_BIT or more is UB */
-        Shift=RME_PGT_SZORD(Meta->Order);
-        if(Shift>=RME_WORD_BIT)
-            Pos=0U;
-        else
-            Pos=(Vaddr-RME_PGT_BASE(Meta->Base))>>Shift;
-        /* See if the entry is overrange */
-        Num=RME_POW2(RME_PGT_NMORD(Meta->Order));
-        if(Pos>=Num)
-            return RME_ERR_HAL_FAIL;
-        /* See if the entry exists */
-        if((Table[Pos]&RME_RV32P_PGT_PRESENT)==0U)
-            return RME_ERR_HAL_FAIL;
-        /* Find the position of the entry - Is there a page, a directory, or nothing? */
-        Flagtbl=(rme_u8_t*)(&Table[Num]);
-        if((Table[Pos]&RME_RV32P_PGT_TERMINAL)!=0U)
-        {
-            /* This is a page - we found it */
-            if(Pgt!=RME_NULL)
-                *Pgt=(rme_ptr_t)Meta;
-            if(Map_Vaddr!=RME_NULL)
+        Meta=Cache->Meta;
+        Start=Cache->Start;
+        Page_Flag=Cache->Flag;
+    }
+    else
+    {
+        Table=RME_RV32P_PGT_TBL_TOP(Meta);
+        /* Do lookup recursively */
+        Flag_Final=RME_PGT_ALL_PERM;
+        while(1)
+        {
+            /* Check if the virtual address is in our range */
+            if(Vaddr<RME_PGT_BASE(Meta->Base))
+                return RME_ERR_HAL_FAIL;
+            /* Calculate entry position - shifting by RME_WORD_BIT or more is UB */
+            Shift=RME_PGT_SZORD(Meta->Order);
+            if(Shift>=RME_WORD_BIT)
+                Pos=0U;
+            else
+                Pos=(Vaddr-RME_PGT_BASE(Meta->Base))>>Shift;
+            /* See if the entry is overrange */
+            Num=RME_POW2(RME_PGT_NMORD(Meta->Order));
+            if(Pos>=Num)
+                return RME_ERR_HAL_FAIL;
+            /* See if the entry exists */
+            if((Table[Pos]&RME_RV32P_PGT_PRESENT)==0U)
+                return RME_ERR_HAL_FAIL;
+            /* Find the position of the entry - Is there a page, a directory, or nothing? */
+            Flagtbl=(rme_u8_t*)(&Table[Num]);
+            if((Table[Pos]&RME_RV32P_PGT_TERMINAL)!=0U)
             {
+                /* This is a page - we found it */
                 if(Shift>=RME_WORD_BIT)
-                    *Map_Vaddr=RME_PGT_BASE(Meta->Base);
+                    Start=RME_PGT_BASE(Meta->Base);
                 else
-                    *Map_Vaddr=RME_PGT_BASE(Meta->Base)+(Pos<<Shift);
+                    Start=RME_PGT_BASE(Meta->Base)+(Pos<<Shift);
+                Page_Flag=Flag_Final&Flagtbl[Pos];
+                break;
             }
-            if(Paddr!=RME_NULL)
+            else
             {
-                if(Shift>=RME_WORD_BIT)
-                    *Paddr=RME_PGT_BASE(Meta->Base);
-                else
-                    *Paddr=RME_PGT_BASE(Meta->Base)+(Pos<<Shift);
-            }
-            if(Size_Order!=RME_NULL)
-                *Size_Order=RME_PGT_SZORD(Meta->Order);
-            if(Num_Order!=RME_NULL)
-                *Num_Order=RME_PGT_NMORD(Meta->Order);
-            if(Flag!=RME_NULL)
-                *Flag=Flag_Final&Flagtbl[Pos];
-
-            break;
-        }
-        else
-        {
-            /* Accumulate flags on the way, if needed */
-            if(Flag!=RME_NULL)
+                /* Accumulate flags on the way - the walk cache needs them too */
                 Flag_Final&=Flagtbl[Pos];
-            /* This is a directory, we goto that directory to continue walking */
-            Meta=(struct __RME_RV32P_Pgt_Meta*)RME_RV32P_PGT_PGD_ADDR(Table[Pos]);
-            Table=RME_RV32P_PGT_TBL_NOM(Meta);
+                /* This is a directory, we goto that directory to continue walking */
+                Meta=(struct __RME_RV32P_Pgt_Meta*)RME_RV32P_PGT_PGD_ADDR(Table[Pos]);
+                Table=RME_RV32P_PGT_TBL_NOM(Meta);
+            }
         }
+#if(RME_PGT_WALK_CACHE_NUM!=0U)
+        ___RME_RV32P_Pgt_Cache_Fill(Top,Meta,Start,Page_Flag);
+#endif
     }
 
+    if(Pgt!=RME_NULL)
+        *Pgt=(rme_ptr_t)Meta;
+    if(Map_Vaddr!=RME_NULL)
+        *Map_Vaddr=Start;
+    if(Paddr!=RME_NULL)
+        *Paddr=Start;
+    if(Size_Order!=RME_NULL)
+        *Size_Order=RME_PGT_SZORD(Meta->Order);
+    if(Num_Order!=RME_NULL)
+        *Num_Order=RME_PGT_NMORD(Meta->Order);
+    if(Flag!=RME_NULL)
+        *Flag=Page_Flag;
+
     return 0;
 }
 #endif
@@ -120,6 +120,7 @@ F31    $ft11      temporary (caller-save)
     .global             ___RME_RV32P_MISA_Get
     .global             ___RME_RV32P_MSTATUS_Get
     .global             ___RME_RV32P_MSTATUS_Set
+    .global             ___RME_RV32P_MCOUNTEREN_Set
     /* Handler for everything */
     .global             __RME_RV32P_Handler
     /* Coprocessor save/load */
@@ -330,6 +331,20 @@ ___RME_RV32P_MSTATUS_Set:
     RET
 /* End Function:___RME_RV32P_MSTATUS_Set *************************************/
 
+/* Function:___RME_RV32P_MCOUNTEREN_Set ***************************************
+Description : Set the MCOUNTEREN register content.
+Input       : $a0 - MCOUNTEREN value.
+Output      : None.
+Return      : None.
+******************************************************************************/
+    .section            .text.___rme_rv32p_mcounteren_set
+    .align              3
+
+___RME_RV32P_MCOUNTEREN_Set:
+    CSRW                mcounteren, a0
+    RET
+/* End Function:___RME_RV32P_MCOUNTEREN_Set **********************************/
+
 /* Function:__RME_User_Enter **************************************************
 Description : Entering of the user mode, after the system finish its preliminary
               booting. The function shall never return. This function should only
@@ -70,6 +70,16 @@ in this function , we output user-mode data to screen
 rme_ret_t __RME_Kfn_Handler(struct RME_Cap_Cpt* Cpt, struct RME_Reg_Struct* Reg,rme_ptr_t FuncID, rme_ptr_t SubID,rme_ptr_t Param1, rme_ptr_t Param2)
 {
     char Char = (char)Param1;
+
+    /* Large page promotion and splitting */
+    if(FuncID==RME_KFN_PGT_ENTRY_MOD)
+        return __RME_X64_Pgt_Entry_Mod(Cpt,(rme_cid_t)SubID,Param1,Param2);
+    /* Interrupt routing and per-vector endpoints */
+    if(FuncID==RME_KFN_INT_LOCAL_MOD)
+        return __RME_X64_Int_Local_Mod(Cpt,SubID,Param1,Param2);
+    if(FuncID==RME_KFN_INT_GLOBAL_MOD)
+        return __RME_X64_Int_Global_Mod(Cpt,SubID,Param1,Param2);
+
     if (Char=='\n')
     {
         if (vga_row+1>=RME_X64_VGA_ROW_MAX)
@@ -232,6 +242,7 @@ Return      : rme_ret_t - If successful, 0; else -1.
 rme_ret_t __RME_X64_SMP_Detect(struct RME_X64_ACPI_MADT_Hdr* MADT)
 {
     struct RME_X64_ACPI_MADT_LAPIC_Record* LAPIC;
+    struct RME_X64_ACPI_MADT_X2APIC_Record* X2APIC;
     struct RME_X64_ACPI_MADT_IOAPIC_Record* IOAPIC;
     struct RME_X64_ACPI_MADT_SRC_OVERRIDE_Record* OVERRIDE;
     rme_ptr_t Length;
@@ -285,6 +296,35 @@ rme_ret_t __RME_X64_SMP_Detect(struct RME_X64_ACPI_MADT_Hdr* MADT)
                 /* Log this CPU into our per-CPU data structure */
                 RME_X64_CPU_Info[RME_X64_Num_CPU].LAPIC_ID=LAPIC->APIC_ID;
                 RME_X64_CPU_Info[RME_X64_Num_CPU].Boot_Done=0;
+                RME_X64_CPU_Info[RME_X64_Num_CPU].Pgt_Cur=0;
+                RME_X64_CPU_Info[RME_X64_Num_CPU].TLB_Req=0;
+                RME_X64_CPU_Info[RME_X64_Num_CPU].TLB_Ack=0;
+                RME_X64_Num_CPU++;
+                RME_ASSERT(RME_X64_Num_CPU<=RME_X64_CPU_NUM);
+                break;
+            }
+            /* This is a LAPIC that can only be reached in x2APIC mode */
+            case RME_X64_MADT_X2APIC:
+            {
+                X2APIC=(struct RME_X64_ACPI_MADT_X2APIC_Record*)Ptr;
+                /* Is the length correct? */
+                if(Length<sizeof(struct RME_X64_ACPI_MADT_X2APIC_Record))
+                    break;
+                /* Is this LAPIC enabled? */
+                if((X2APIC->Flags&RME_X64_APIC_LAPIC_ENABLED)==0)
+                    break;
+
+                RME_DBG_S("\n\rACPI: CPU ");
+                RME_DBG_I((rme_cnt_t)RME_X64_Num_CPU);
+                RME_DBG_S(", x2APIC ID ");
+                RME_DBG_I(X2APIC->X2APIC_ID);
+
+                /* Log this CPU into our per-CPU data structure */
+                RME_X64_CPU_Info[RME_X64_Num_CPU].LAPIC_ID=X2APIC->X2APIC_ID;
+                RME_X64_CPU_Info[RME_X64_Num_CPU].Boot_Done=0;
+                RME_X64_CPU_Info[RME_X64_Num_CPU].Pgt_Cur=0;
+                RME_X64_CPU_Info[RME_X64_Num_CPU].TLB_Req=0;
+                RME_X64_CPU_Info[RME_X64_Num_CPU].TLB_Ack=0;
                 RME_X64_Num_CPU++;
                 RME_ASSERT(RME_X64_Num_CPU<=RME_X64_CPU_NUM);
                 break;
@@ -475,6 +515,13 @@ void __RME_X64_Feature_Get(void)
                                                           (rme_ptr_t*)&(RME_X64_Feature.Ext[Count][3]));
     }
 
+    /* Use the x2APIC when there is one, so that IPIs and EOIs are single MSR
+     * writes, and LAPIC IDs beyond 255 can be reached */
+    if((RME_X64_FUNC(RME_X64_CPUID_1_INFO_FEATURE,2)&RME_X64_1_ECX_X2APIC)!=0)
+        RME_X64_X2APIC=1;
+    else
+        RME_X64_X2APIC=0;
+
     /* TODO: Check these flags. If not satisfied, we hang immediately. */
 }
 /* End Function:__RME_X64_Feature_Get ****************************************/
@@ -876,6 +923,28 @@ void __RME_X64_LAPIC_Ack(void)
 }
 /* End Function:__RME_X64_LAPIC_Ack ******************************************/
 
+/* Function:__RME_X64_LAPIC_IPI ***********************************************
+Description : Send an IPI. In x2APIC mode the ICR is one 64-bit MSR holding a
+              32-bit destination, so this is a single write; otherwise the
+              destination and the command are written to the ICR separately.
+Input       : rme_ptr_t LAPIC_ID - The LAPIC ID of the destination. Ignored if
+                                   the command has a destination shorthand.
+              rme_ptr_t Cmd - The lower half of the ICR.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_X64_LAPIC_IPI(rme_ptr_t LAPIC_ID, rme_ptr_t Cmd)
+{
+    if(RME_X64_X2APIC!=0)
+        __RME_X64_Write_MSR(RME_X64_MSR_X2APIC(RME_X64_LAPIC_ICRLO),(LAPIC_ID<<32)|Cmd);
+    else
+    {
+        RME_X64_LAPIC_WRITE(RME_X64_LAPIC_ICRHI, LAPIC_ID<<24);
+        RME_X64_LAPIC_WRITE(RME_X64_LAPIC_ICRLO, Cmd);
+    }
+}
+/* End Function:__RME_X64_LAPIC_IPI ******************************************/
+
 /* Function:__RME_X64_LAPIC_Init **********************************************
 Description : Initialize LAPIC controllers - this will be run once on everycore.
 Input       : None.
@@ -887,6 +956,15 @@ void __RME_X64_LAPIC_Init(void)
     /* LAPIC initialization - Check if there is any LAPIC */
     RME_ASSERT(RME_X64_LAPIC_Addr!=0);
 
+    /* Switch to x2APIC mode if we have it; this has to be done on every core */
+    if(RME_X64_X2APIC!=0)
+    {
+        __RME_X64_Write_MSR(RME_X64_MSR_IA32_APIC_BASE,
+                            __RME_X64_Read_MSR(RME_X64_MSR_IA32_APIC_BASE)|
+                            RME_X64_MSR_IA32_APIC_BASE_EN|
+                            RME_X64_MSR_IA32_APIC_BASE_EXTD);
+    }
+
     /* Enable local APIC; set spurious interrupt vector to 32 */
     RME_X64_LAPIC_WRITE(RME_X64_LAPIC_SVR, RME_X64_LAPIC_SVR_ENABLE|RME_X64_INT_SPUR);
 
@@ -908,12 +986,15 @@ void __RME_X64_LAPIC_Init(void)
     /* Acknowledge any outstanding interrupts */
     __RME_X64_LAPIC_Ack();
 
-    /* Send an Init Level De-Assert to synchronise arbitration IDs */
-    RME_X64_LAPIC_WRITE(RME_X64_LAPIC_ICRHI, 0);
-    RME_X64_LAPIC_WRITE(RME_X64_LAPIC_ICRLO, RME_X64_LAPIC_ICRLO_BCAST|
-                                             RME_X64_LAPIC_ICRLO_INIT|
-                                             RME_X64_LAPIC_ICRLO_LEVEL);
-    while(RME_X64_LAPIC_READ(RME_X64_LAPIC_ICRLO)&RME_X64_LAPIC_ICRLO_DELIVS);
+    /* Send an Init Level De-Assert to synchronise arbitration IDs. The x2APIC
+     * has no arbitration IDs and does not support this */
+    if(RME_X64_X2APIC==0)
+    {
+        __RME_X64_LAPIC_IPI(0, RME_X64_LAPIC_ICRLO_BCAST|
+                               RME_X64_LAPIC_ICRLO_INIT|
+                               RME_X64_LAPIC_ICRLO_LEVEL);
+        while(RME_X64_LAPIC_READ(RME_X64_LAPIC_ICRLO)&RME_X64_LAPIC_ICRLO_DELIVS);
+    }
 
     /* Enable interrupts on the APIC */
     RME_X64_LAPIC_WRITE(RME_X64_LAPIC_TPR, 0);
@@ -956,6 +1037,32 @@ void __RME_X64_PIC_Init(void)
 }
 /* End Function:__RME_X64_PIC_Init *******************************************/
 
+/* Function:__RME_X64_IOAPIC_Lock *********************************************
+Description : Take the IOAPIC lock. The IOAPIC is accessed by selecting a register
+              then reading or writing the data window, and another CPU selecting
+              a register in between would redirect the access.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_X64_IOAPIC_Lock(void)
+{
+    while(RME_COMP_SWAP((rme_ptr_t*)&RME_X64_IOAPIC_Lock_Word,0U,1U)==RME_CASFAIL);
+}
+/* End Function:__RME_X64_IOAPIC_Lock ****************************************/
+
+/* Function:__RME_X64_IOAPIC_Unlock *******************************************
+Description : Release the IOAPIC lock.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_X64_IOAPIC_Unlock(void)
+{
+    RME_WRITE_RELEASE(&RME_X64_IOAPIC_Lock_Word,0U);
+}
+/* End Function:__RME_X64_IOAPIC_Unlock **************************************/
+
 /* Function:__RME_X64_IOAPIC_Int_Enable ***************************************
 Description : Enable a specific vector on one CPU.
 Input       : rme_ptr_t IRQ - The user vector to enable.
@@ -967,8 +1074,10 @@ void __RME_X64_IOAPIC_Int_Enable(rme_ptr_t IRQ, rme_ptr_t CPUID)
 {
     /* Mark interrupt edge-triggered, active high, enabled, and routed to the
      * given cpunum, which happens to be that cpu's APIC ID. */
+    __RME_X64_IOAPIC_Lock();
     RME_X64_IOAPIC_WRITE(RME_X64_IOAPIC_REG_TABLE+(IRQ<<1),RME_X64_INT_USER(IRQ));
     RME_X64_IOAPIC_WRITE(RME_X64_IOAPIC_REG_TABLE+(IRQ<<1)+1,CPUID<<24);
+    __RME_X64_IOAPIC_Unlock();
 }
 /* End Function:__RME_X64_IOAPIC_Int_Enable **********************************/
 
@@ -982,11 +1091,287 @@ void __RME_X64_IOAPIC_Int_Disable(rme_ptr_t IRQ)
 {
     /* Mark interrupt edge-triggered, active high, enabled, and routed to the
      * given cpunum, which happens to be that cpu's APIC ID. */
+    __RME_X64_IOAPIC_Lock();
     RME_X64_IOAPIC_WRITE(RME_X64_IOAPIC_REG_TABLE+(IRQ<<1),RME_X64_IOAPIC_INT_DISABLED|RME_X64_INT_USER(IRQ));
     RME_X64_IOAPIC_WRITE(RME_X64_IOAPIC_REG_TABLE+(IRQ<<1)+1,0);
+    __RME_X64_IOAPIC_Unlock();
 }
 /* End Function:__RME_X64_IOAPIC_Int_Disable *********************************/
 
+/* Function:__RME_X64_Flag_Or *************************************************
+Description : Atomically set bits in a word of a flag set. The user-level
+              consumer clears bits of the same words from another CPU, so a
+              plain read-modify-write could lose either side's update.
+Input       : volatile rme_ptr_t* Word - The word to modify.
+              rme_ptr_t Mask - The bits to set.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_X64_Flag_Or(volatile rme_ptr_t* Word, rme_ptr_t Mask)
+{
+    rme_ptr_t Old;
+    
+    do
+    {
+        Old=*Word;
+    }
+    while(RME_COMP_SWAP((rme_ptr_t*)Word,Old,Old|Mask)==RME_CASFAIL);
+}
+/* End Function:__RME_X64_Flag_Or ********************************************/
+
+/* Function:__RME_X64_Flag_Set ************************************************
+Description : Set a user interrupt's flag in the flag set of a CPU, so that the
+              user-level handler knows which source fired. The flag sets are
+              only populated when RME_X64_INT_FLAG_ADDR is configured. The
+              flag goes in before its group bit, so a consumer that sees the
+              group bit always finds the flag.
+Input       : rme_ptr_t CPUID - The CPU that received the interrupt.
+              rme_ptr_t IRQ - The user interrupt number.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_X64_Flag_Set(rme_ptr_t CPUID, rme_ptr_t IRQ)
+{
+    volatile struct __RME_X64_Flag* Set;
+
+    /* Write to the buffer that the consumer is not draining at the moment */
+    Set=RME_X64_FLAG_SET(CPUID,RME_X64_FLAG_CUR(CPUID)&1);
+
+    /* Set the flags for this interrupt source */
+    __RME_X64_Flag_Or(&(Set->Flag[IRQ>>RME_WORD_ORDER]),RME_POW2(IRQ&RME_MASK_WORD));
+    __RME_X64_Flag_Or(&(Set->Group),RME_POW2(IRQ>>RME_WORD_ORDER));
+}
+/* End Function:__RME_X64_Flag_Set *******************************************/
+
+/* Function:__RME_X64_Int_Local_Mod *******************************************
+Description : Consult or modify the routing of a user interrupt. An IOAPIC input
+              can be routed to the current CPU or disabled, and a vector can be
+              bound to its own signal endpoint so that the driver thread waits
+              on it directly instead of on the CPU's shared vector endpoint.
+Input       : struct RME_Cap_Cpt* Cpt - The current capability table.
+              rme_ptr_t IRQ - The user interrupt number. For IOAPIC inputs, this
+                              is the input pin number as well.
+              rme_ptr_t Operation - The operation to conduct.
+              rme_ptr_t Param - The parameter, could be state or signal endpoint
+                                capability; RME_CID_NULL unbinds the endpoint.
+Output      : None.
+Return      : rme_ret_t - If successful, 0 or the desired value; else an error code.
+******************************************************************************/
+rme_ret_t __RME_X64_Int_Local_Mod(struct RME_Cap_Cpt* Cpt, rme_ptr_t IRQ,
+                                  rme_ptr_t Operation, rme_ptr_t Param)
+{
+    rme_ptr_t Entry;
+    rme_ptr_t CPUID;
+
+    if(IRQ>=RME_X64_INT_USER_NUM)
+        return RME_ERR_KFN_FAIL;
+
+    /* Binding does not involve the IOAPIC at all, and works for any vector */
+    if(Operation==RME_X64_KFN_INT_LOCAL_MOD_SIG_SET)
+        return _RME_Kern_Sig_Bind(Cpt,(rme_cid_t)Param,&(RME_X64_Vct_Sig[IRQ]));
+
+    /* The timer input is reserved by the kernel */
+    if((IRQ>RME_X64_IOAPIC_Max_Int)||(RME_X64_INT_USER(IRQ)==RME_X64_INT_SYSTICK))
+        return RME_ERR_KFN_FAIL;
+
+    switch(Operation)
+    {
+        case RME_X64_KFN_INT_LOCAL_MOD_STATE_GET:
+        {
+            __RME_X64_IOAPIC_Lock();
+            RME_X64_IOAPIC_READ(RME_X64_IOAPIC_REG_TABLE+(IRQ<<1),Entry);
+            __RME_X64_IOAPIC_Unlock();
+            if((Entry&RME_X64_IOAPIC_INT_DISABLED)!=0)
+                return 0;
+            else
+                return 1;
+        }
+        case RME_X64_KFN_INT_LOCAL_MOD_STATE_SET:
+        {
+            if(Param==0)
+                __RME_X64_IOAPIC_Int_Disable(IRQ);
+            else
+            {
+                CPUID=RME_CPU_LOCAL()->CPUID;
+                /* The IOAPIC can only address 8-bit LAPIC IDs */
+                if(RME_X64_CPU_Info[CPUID].LAPIC_ID>0xFF)
+                    return RME_ERR_KFN_FAIL;
+                __RME_X64_IOAPIC_Int_Enable(IRQ,RME_X64_CPU_Info[CPUID].LAPIC_ID);
+            }
+            return 0;
+        }
+        default:break;
+    }
+
+    return RME_ERR_KFN_FAIL;
+}
+/* End Function:__RME_X64_Int_Local_Mod **************************************/
+
+/* Function:__RME_X64_MSI_Alloc ***********************************************
+Description : Allocate a user interrupt that is not an IOAPIC input for MSI, and
+              bind it to a signal endpoint. The returned message sends the
+              vector straight to the LAPIC of the chosen CPU, and the handler
+              sends to the endpoint, so no demultiplexing is needed. The user
+              level driver programs the message into the MSI or MSI-X capability
+              of the device; the user interrupt number is the vector minus 32.
+Input       : struct RME_Cap_Cpt* Cpt - The current capability table.
+              rme_ptr_t Param - D1: the CPUID of the destination CPU;
+                                D0: the capability to the signal endpoint.
+Output      : None.
+Return      : rme_ret_t - If successful, the MSI address in bits 47:16 and the
+                          MSI data in bits 15:0; else an error code.
+******************************************************************************/
+rme_ret_t __RME_X64_MSI_Alloc(struct RME_Cap_Cpt* Cpt, rme_ptr_t Param)
+{
+    rme_ptr_t CPUID;
+    rme_ptr_t IRQ;
+    rme_ptr_t Word;
+    rme_ret_t Retval;
+
+    /* The MSI address can only hold 8-bit LAPIC IDs */
+    CPUID=RME_PARAM_D1(Param);
+    if(CPUID>=RME_X64_Num_CPU)
+        return RME_ERR_KFN_FAIL;
+    if(RME_X64_CPU_Info[CPUID].LAPIC_ID>0xFF)
+        return RME_ERR_KFN_FAIL;
+
+    /* The user interrupts beyond the IOAPIC inputs are ours to hand out */
+    IRQ=RME_X64_IOAPIC_Max_Int+1;
+    while(IRQ<RME_X64_INT_USER_NUM)
+    {
+        Word=RME_X64_MSI_Alloc[IRQ>>RME_WORD_ORDER];
+        if((Word&RME_POW2(IRQ&RME_MASK_WORD))!=0)
+            IRQ++;
+        else if(RME_COMP_SWAP((rme_ptr_t*)&(RME_X64_MSI_Alloc[IRQ>>RME_WORD_ORDER]),
+                              Word,Word|RME_POW2(IRQ&RME_MASK_WORD))!=RME_CASFAIL)
+            break;
+    }
+    if(IRQ>=RME_X64_INT_USER_NUM)
+        return RME_ERR_KFN_FAIL;
+
+    Retval=_RME_Kern_Sig_Bind(Cpt,(rme_cid_t)RME_PARAM_D0(Param),&(RME_X64_Vct_Sig[IRQ]));
+    if(Retval<0)
+    {
+        RME_FETCH_AND((rme_ptr_t*)&(RME_X64_MSI_Alloc[IRQ>>RME_WORD_ORDER]),
+                      ~RME_POW2(IRQ&RME_MASK_WORD));
+        return Retval;
+    }
+
+    /* Physical destination, fixed delivery, edge triggered */
+    return (rme_ret_t)(((RME_X64_MSI_ADDR_BASE|(RME_X64_CPU_Info[CPUID].LAPIC_ID<<12))<<16)|
+                       RME_X64_INT_USER(IRQ));
+}
+/* End Function:__RME_X64_MSI_Alloc ******************************************/
+
+/* Function:__RME_X64_MSI_Free ************************************************
+Description : Free a user interrupt allocated for MSI, and unbind its endpoint.
+              The device must have stopped sending the message before this.
+Input       : struct RME_Cap_Cpt* Cpt - The current capability table.
+              rme_ptr_t IRQ - The user interrupt number.
+              rme_ptr_t Max_Int - The last IOAPIC input.
+Output      : None.
+Return      : rme_ret_t - If successful, 0; else an error code.
+******************************************************************************/
+rme_ret_t __RME_X64_MSI_Free(struct RME_Cap_Cpt* Cpt, rme_ptr_t IRQ, rme_ptr_t Max_Int)
+{
+    rme_ret_t Retval;
+
+    if((IRQ<=Max_Int)||(IRQ>=RME_X64_INT_USER_NUM))
+        return RME_ERR_KFN_FAIL;
+    if((RME_X64_MSI_Alloc[IRQ>>RME_WORD_ORDER]&RME_POW2(IRQ&RME_MASK_WORD))==0)
+        return RME_ERR_KFN_FAIL;
+
+    Retval=_RME_Kern_Sig_Bind(Cpt,RME_CID_NULL,&(RME_X64_Vct_Sig[IRQ]));
+    if(Retval<0)
+        return Retval;
+
+    RME_FETCH_AND((rme_ptr_t*)&(RME_X64_MSI_Alloc[IRQ>>RME_WORD_ORDER]),
+                  ~RME_POW2(IRQ&RME_MASK_WORD));
+    return 0;
+}
+/* End Function:__RME_X64_MSI_Free *******************************************/
+
+/* Function:__RME_X64_Int_Global_Mod ******************************************
+Description : Consult or modify which CPU an IOAPIC input is routed to, or read
+              how many user interrupts a CPU has taken. Each CPU sends what it
+              takes to its own vector endpoint, so routing an input to a CPU lets
+              the driver follow the CPU that its thread is pinned on, and the
+              counters tell where the load is. The user interrupts beyond the
+              IOAPIC inputs can be allocated for MSI as well.
+Input       : struct RME_Cap_Cpt* Cpt - The current capability table.
+              rme_ptr_t IRQ - The user interrupt number. For IOAPIC inputs, this
+                              is the input pin number as well. Unused when
+                              reading the counters or allocating for MSI.
+              rme_ptr_t Operation - The operation to conduct.
+              rme_ptr_t Param - The CPUID to route to, or to read the counter of.
+                                For MSI allocation, see __RME_X64_MSI_Alloc.
+Output      : None.
+Return      : rme_ret_t - If successful, 0 or the desired value; else an error code.
+******************************************************************************/
+rme_ret_t __RME_X64_Int_Global_Mod(struct RME_Cap_Cpt* Cpt, rme_ptr_t IRQ,
+                                   rme_ptr_t Operation, rme_ptr_t Param)
+{
+    rme_ptr_t Max_Int;
+    rme_ptr_t Entry;
+    rme_ptr_t CPUID;
+
+    if(Operation==RME_X64_KFN_INT_GLOBAL_MOD_CNT_GET)
+    {
+        if(Param>=RME_X64_Num_CPU)
+            return RME_ERR_KFN_FAIL;
+        /* Drop the top bit so that a wrapped counter never looks like an error */
+        return (rme_ret_t)(RME_X64_CPU_Info[Param].Int_Cnt&(RME_MASK_FULL>>1));
+    }
+    if(Operation==RME_X64_KFN_INT_GLOBAL_MOD_MSI_ALLOC)
+        return __RME_X64_MSI_Alloc(Cpt,Param);
+
+    if(IRQ>=RME_X64_INT_USER_NUM)
+        return RME_ERR_KFN_FAIL;
+
+    Max_Int=RME_X64_IOAPIC_Max_Int;
+    if(Operation==RME_X64_KFN_INT_GLOBAL_MOD_MSI_FREE)
+        return __RME_X64_MSI_Free(Cpt,IRQ,Max_Int);
+
+    /* The timer input is reserved by the kernel */
+    if((IRQ>Max_Int)||(RME_X64_INT_USER(IRQ)==RME_X64_INT_SYSTICK))
+        return RME_ERR_KFN_FAIL;
+
+    switch(Operation)
+    {
+        case RME_X64_KFN_INT_GLOBAL_MOD_AFF_GET:
+        {
+            __RME_X64_IOAPIC_Lock();
+            RME_X64_IOAPIC_READ(RME_X64_IOAPIC_REG_TABLE+(IRQ<<1)+1,Entry);
+            __RME_X64_IOAPIC_Unlock();
+            Entry>>=24;
+            for(CPUID=0;CPUID<RME_X64_Num_CPU;CPUID++)
+            {
+                if(RME_X64_CPU_Info[CPUID].LAPIC_ID==Entry)
+                    return (rme_ret_t)CPUID;
+            }
+            return RME_ERR_KFN_FAIL;
+        }
+        case RME_X64_KFN_INT_GLOBAL_MOD_AFF_SET:
+        {
+            if(Param>=RME_X64_Num_CPU)
+                return RME_ERR_KFN_FAIL;
+            /* The IOAPIC can only address 8-bit LAPIC IDs */
+            if(RME_X64_CPU_Info[Param].LAPIC_ID>0xFF)
+                return RME_ERR_KFN_FAIL;
+            /* Only the destination changes; the enable state is left alone */
+            __RME_X64_IOAPIC_Lock();
+            RME_X64_IOAPIC_WRITE(RME_X64_IOAPIC_REG_TABLE+(IRQ<<1)+1,
+                                 RME_X64_CPU_Info[Param].LAPIC_ID<<24);
+            __RME_X64_IOAPIC_Unlock();
+            return 0;
+        }
+        default:break;
+    }
+
+    return RME_ERR_KFN_FAIL;
+}
+/* End Function:__RME_X64_Int_Global_Mod *************************************/
+
 /* Function:__RME_X64_IOAPIC_Init *********************************************
 Description : Initialize IOAPIC controllers - this will be run once only.
 Input       : None.
@@ -1001,6 +1386,8 @@ void __RME_X64_IOAPIC_Init(void)
     /* IOAPIC initialization */
     RME_X64_IOAPIC_READ(RME_X64_IOAPIC_REG_VER,Max_Int);
     Max_Int=((Max_Int>>16)&0xFF);
+    /* Never changes, so the runtime paths need not touch the IOAPIC for it */
+    RME_X64_IOAPIC_Max_Int=Max_Int;
     RME_DBG_S("\n\rMax interupt number is: ");
     RME_DBG_I(Max_Int);
     RME_X64_IOAPIC_READ(RME_X64_IOAPIC_REG_ID,IOAPIC_ID);
@@ -1053,22 +1440,23 @@ void __RME_X64_SMP_Init(void)
         Warm_Reset[0]=0;
         Warm_Reset[1]=0x7000>>4;
 
-        /* Send INIT (level-triggered) interrupt to reset other CPU */
-        RME_X64_LAPIC_WRITE(RME_X64_LAPIC_ICRHI, RME_X64_CPU_Info[Count].LAPIC_ID<<24);
-        RME_X64_LAPIC_WRITE(RME_X64_LAPIC_ICRLO, RME_X64_LAPIC_ICRLO_INIT|
-                                                 RME_X64_LAPIC_ICRLO_LEVEL|
-                                                 RME_X64_LAPIC_ICRLO_ASSERT);
+        /* Send INIT (level-triggered) interrupt to reset other CPU. The x2APIC
+         * does not support the de-assert */
+        __RME_X64_LAPIC_IPI(RME_X64_CPU_Info[Count].LAPIC_ID, RME_X64_LAPIC_ICRLO_INIT|
+                                                              RME_X64_LAPIC_ICRLO_LEVEL|
+                                                              RME_X64_LAPIC_ICRLO_ASSERT);
         RME_X64_UDELAY(200);
-        RME_X64_LAPIC_WRITE(RME_X64_LAPIC_ICRLO, RME_X64_LAPIC_ICRLO_INIT|
-                                                 RME_X64_LAPIC_ICRLO_LEVEL);
+        if(RME_X64_X2APIC==0)
+        {
+            __RME_X64_LAPIC_IPI(RME_X64_CPU_Info[Count].LAPIC_ID, RME_X64_LAPIC_ICRLO_INIT|
+                                                                  RME_X64_LAPIC_ICRLO_LEVEL);
+        }
         RME_X64_UDELAY(10000);
 
         /* Send startup IPI twice according to Intel manuals */
-        RME_X64_LAPIC_WRITE(RME_X64_LAPIC_ICRHI, RME_X64_CPU_Info[Count].LAPIC_ID<<24);
-        RME_X64_LAPIC_WRITE(RME_X64_LAPIC_ICRLO, RME_X64_LAPIC_ICRLO_STARTUP|(0x7000>>12));
+        __RME_X64_LAPIC_IPI(RME_X64_CPU_Info[Count].LAPIC_ID, RME_X64_LAPIC_ICRLO_STARTUP|(0x7000>>12));
         RME_X64_UDELAY(200);
-        RME_X64_LAPIC_WRITE(RME_X64_LAPIC_ICRHI, RME_X64_CPU_Info[Count].LAPIC_ID<<24);
-        RME_X64_LAPIC_WRITE(RME_X64_LAPIC_ICRLO, RME_X64_LAPIC_ICRLO_STARTUP|(0x7000>>12));
+        __RME_X64_LAPIC_IPI(RME_X64_CPU_Info[Count].LAPIC_ID, RME_X64_LAPIC_ICRLO_STARTUP|(0x7000>>12));
         RME_X64_UDELAY(200);
 
         /* Wait for CPU to finish its own initialization */
@@ -1089,10 +1477,9 @@ void __RME_X64_SMP_Tick(void)
     /* Is this a SMP? */
     if(RME_X64_Num_CPU>1)
     {
-        RME_X64_LAPIC_WRITE(RME_X64_LAPIC_ICRHI, 0xFFULL<<24);
-        RME_X64_LAPIC_WRITE(RME_X64_LAPIC_ICRLO, RME_X64_LAPIC_ICRLO_EXC_SELF|
-                                                 RME_X64_LAPIC_ICRLO_FIXED|
-                                                 RME_X64_INT_SMP_SYSTICK);
+        __RME_X64_LAPIC_IPI(0, RME_X64_LAPIC_ICRLO_EXC_SELF|
+                               RME_X64_LAPIC_ICRLO_FIXED|
+                               RME_X64_INT_SMP_SYSTICK);
     }
 }
 /* End Function:__RME_X64_SMP_Tick *******************************************/
@@ -1860,7 +2247,9 @@ rme_ret_t __RME_Kern_Func_Handler(struct RME_Cap_Cpt* Cpt, struct RME_Reg_Struct
 
 /* Function:__RME_X64_Fault_Handler *******************************************
 Description : The fault handler of RME. In x64, this is used to handle multiple
-              faults.
+              faults. Page faults, protection faults, divide errors and invalid
+              opcodes from user level are handed to _RME_Thd_Fatal; all other
+              faults are considered fatal to the kernel.
 Input       : struct RME_Reg_Struct* Reg - The register set when entering the handler.
               rme_ptr_t Reason - The fault source.
 Output      : struct RME_Reg_Struct* Reg - The register set when exiting the handler.
@@ -1868,6 +2257,30 @@ Return      : None.
 ******************************************************************************/
 void __RME_X64_Fault_Handler(struct RME_Reg_Struct* Reg, rme_ptr_t Reason)
 {
+    struct RME_Exc_Struct* Exc;
+    
+    /* Synchronous faults from user level go to the pager or the scheduler */
+    if(((Reg->CS&0x03U)==0x03U)&&
+       ((Reason==RME_X64_FAULT_PF)||(Reason==RME_X64_FAULT_GP)||
+        (Reason==RME_X64_FAULT_DE)||(Reason==RME_X64_FAULT_UD)))
+    {
+        Exc=&(RME_CPU_LOCAL()->Thd_Cur->Ctx.Reg->Exc);
+        Exc->INT_NUM=Reg->INT_NUM;
+        Exc->ERROR_CODE=Reg->ERROR_CODE;
+        Exc->RIP=Reg->RIP;
+        Exc->CS=Reg->CS;
+        Exc->RFLAGS=Reg->RFLAGS;
+        Exc->RSP=Reg->RSP;
+        Exc->SS=Reg->SS;
+        if(Reason==RME_X64_FAULT_PF)
+            Exc->CR2=__RME_X64_CR2_Get();
+        else
+            Exc->CR2=0U;
+        
+        _RME_Thd_Fatal(Reg);
+        return;
+    }
+    
     /* Not handling faults */
     RME_DBG_S("\n\r\n\r*** Fault: ");RME_DBG_I(Reason);RME_DBG_S(" - ");
     /* When handling debug exceptions, note CVE 2018-8897, we may get something at
@@ -1927,7 +2340,8 @@ void __RME_X64_Fault_Handler(struct RME_Reg_Struct* Reg, rme_ptr_t Reason)
 /* End Function:__RME_X64_Fault_Handler **************************************/
 
 /* Function:__RME_X64_Generic_Handler *****************************************
-Description : The generic interrupt handler of RME for x64.
+Description : The generic interrupt handler of RME for x64. Device interrupts
+              are delivered to user level through signal endpoints.
 Input       : struct RME_Reg_Struct* Reg - The register set when entering the handler.
               rme_ptr_t Int_Num - The interrupt number.
 Output      : struct RME_Reg_Struct* Reg - The register set when exiting the handler.
@@ -1935,17 +2349,45 @@ Return      : None.
 ******************************************************************************/
 void __RME_X64_Generic_Handler(struct RME_Reg_Struct* Reg, rme_ptr_t Int_Num)
 {
-    /* Not handling interrupts */
-    RME_DBG_S("\r\nGeneral int:");
-    RME_DBG_I(Int_Num);
+    struct RME_CPU_Local* CPU_Local;
+    struct RME_Cap_Sig* Sig;
+    rme_ptr_t IRQ;
 
     switch(Int_Num)
     {
         /* Is this a generic IPI from other processors? */
 
+        /* Is this a TLB shootdown from other processors? */
+        case RME_X64_INT_TLB:__RME_X64_TLB_Handler();return;
         default:break;
     }
-    /* Remember to perform context switch after any kernel sends */
+
+    /* Anything above the user interrupts is reserved by the kernel */
+    if((Int_Num<RME_X64_INT_USER(0))||(Int_Num>=RME_X64_INT_USER(RME_X64_INT_USER_NUM)))
+    {
+        RME_DBG_S("\r\nGeneral int:");
+        RME_DBG_I(Int_Num);
+        return;
+    }
+
+    IRQ=Int_Num-RME_X64_INT_USER(0);
+    CPU_Local=RME_CPU_LOCAL();
+    RME_X64_CPU_Info[CPU_Local->CPUID].Int_Cnt++;
+
+    /* Wake the driver directly if it has its own endpoint, or go through the
+     * shared vector endpoint and let the user-level dispatcher look at flags */
+    Sig=RME_X64_Vct_Sig[IRQ];
+    if(Sig!=0)
+        _RME_Kern_Snd(Sig,1);
+    else
+    {
+        if(RME_X64_INT_FLAG_ADDR!=0)
+            __RME_X64_Flag_Set(CPU_Local->CPUID,IRQ);
+        _RME_Kern_Snd(CPU_Local->Sig_Vct,1);
+    }
+
+    /* Pick the highest priority thread after we did all sends */
+    _RME_Kern_High(Reg,CPU_Local);
 }
 /* End Function:__RME_X64_Generic_Handler ************************************/
 
@@ -1957,10 +2399,104 @@ Return      : None.
 ******************************************************************************/
 void __RME_Pgt_Set(struct RME_Cap_Pgt* Pgt)
 {
+    /* Log it before loading, so that any unmap that misses us happens before
+     * the load and thus cannot leave stale entries behind */
+    RME_X64_CPU_Info[RME_CPU_LOCAL()->CPUID].Pgt_Cur=RME_CAP_GETOBJ(Pgt,rme_ptr_t);
     __RME_X64_Pgt_Set(RME_X64_VA2PA(RME_CAP_GETOBJ(Pgt,rme_ptr_t)));
 }
 /* End Function:__RME_Pgt_Set **********************************************/
 
+/* Function:__RME_X64_TLB_Handler *********************************************
+Description : Do all TLB shootdowns requested to this CPU so far. As we do not
+              use PCID or global user pages, reloading CR3 drops all user TLB
+              entries, so requests that come in together only cost one flush.
+              This may be called from the IPI handler, or when this CPU itself
+              is waiting for a shootdown to complete.
+Input       : None.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_X64_TLB_Handler(void)
+{
+    rme_ptr_t Gen;
+    rme_ptr_t Ack;
+    volatile struct RME_X64_CPU_Info* Info;
+
+    Info=&RME_X64_CPU_Info[RME_CPU_LOCAL()->CPUID];
+
+    while(1)
+    {
+        Gen=Info->TLB_Req;
+        Ack=Info->TLB_Ack;
+        if(Gen==Ack)
+            return;
+
+        if(Info->Pgt_Cur!=0)
+            __RME_X64_Pgt_Set(RME_X64_VA2PA(Info->Pgt_Cur));
+
+        /* Locked so that the next read of the request cannot pass it; whoever
+         * requests after this will see that we are idle and send an IPI */
+        RME_COMP_SWAP((rme_ptr_t*)&(Info->TLB_Ack),Ack,Gen);
+    }
+}
+/* End Function:__RME_X64_TLB_Handler ****************************************/
+
+/* Function:__RME_X64_TLB_Shootdown *******************************************
+Description : Invalidate the TLB entries of an address space on all CPUs that
+              have loaded it, and wait for them to finish. Called after an entry
+              is removed, so that the memory it mapped can be reused as soon as
+              the unmap returns. A page directory below the top level may be
+              shared between address spaces, so in that case all CPUs that run
+              any user address space are targeted. Each target CPU is sent at
+              most one IPI; requests that arrive while one is still pending are
+              merged into it.
+Input       : rme_ptr_t Pgt - The top-level page table affected, or 0 if unknown.
+Output      : None.
+Return      : None.
+******************************************************************************/
+void __RME_X64_TLB_Shootdown(rme_ptr_t Pgt)
+{
+    rme_ptr_t CPUID;
+    rme_ptr_t Count;
+    rme_ptr_t Cur;
+    rme_ptr_t Gen;
+    volatile struct RME_X64_CPU_Info* Info;
+
+    CPUID=RME_CPU_LOCAL()->CPUID;
+
+    /* Local CPU - we do not know the virtual address, so do a full flush */
+    Cur=RME_X64_CPU_Info[CPUID].Pgt_Cur;
+    if((Cur!=0)&&((Pgt==0)||(Pgt==Cur)))
+        __RME_X64_Pgt_Set(RME_X64_VA2PA(Cur));
+
+    /* Post the requests, and kick those CPUs that are not already working */
+    for(Count=0;Count<RME_X64_Num_CPU;Count++)
+    {
+        Info=&RME_X64_CPU_Info[Count];
+        Cur=Info->Pgt_Cur;
+        if((Count==CPUID)||(Cur==0)||((Pgt!=0)&&(Pgt!=Cur)))
+            continue;
+
+        Gen=RME_FETCH_ADD((rme_ptr_t*)&(Info->TLB_Req),1);
+        if(Gen==Info->TLB_Ack)
+        {
+            __RME_X64_LAPIC_IPI(Info->LAPIC_ID, RME_X64_LAPIC_ICRLO_FIXED|
+                                                RME_X64_INT_TLB);
+        }
+    }
+
+    /* Wait for all of them. While waiting, serve the requests to ourselves,
+     * or two CPUs shooting down each other would deadlock */
+    for(Count=0;Count<RME_X64_Num_CPU;Count++)
+    {
+        Info=&RME_X64_CPU_Info[Count];
+        Gen=Info->TLB_Req;
+        while(((rme_cnt_t)(Info->TLB_Ack-Gen))<0)
+            __RME_X64_TLB_Handler();
+    }
+}
+/* End Function:__RME_X64_TLB_Shootdown **************************************/
+
 /* Function:__RME_Pgt_Check *************************************************
 Description : Check if the page table parameters are feasible, according to the
               parameters. This is only used in page table creation.
@@ -2006,23 +2542,29 @@ rme_ptr_t __RME_Pgt_Init(struct RME_Cap_Pgt* Pgt_Op)
 {
     rme_cnt_t Count;
     rme_ptr_t* Ptr;
+    rme_ptr_t Clean;
     
     /* Get the actual table */
     Ptr=RME_CAP_GETOBJ(Pgt_Op,rme_ptr_t*);
+    /* The clearing is skipped if the table was zeroed in advance */
+    Clean=RME_KOT_CLEAN_CHK(Ptr,512U*RME_WORD_BYTE);
 
     /* Hopefully the compiler optimize this to rep stos */
-    for(Count=0;Count<256;Count++)
-        Ptr[Count]=0;
+    if(Clean==0U)
+    {
+        for(Count=0;Count<256;Count++)
+            Ptr[Count]=0;
+    }
 
     /* Hopefully the compiler optimize this to rep movs */
     if((Pgt_Op->Base&RME_PGT_TOP)!=0)
     {
-        for(;Count<512;Count++)
+        for(Count=256;Count<512;Count++)
             Ptr[Count]=RME_X64_Kpgt.PML4[Count-256];
     }
-    else
+    else if(Clean==0U)
     {
-        for(;Count<512;Count++)
+        for(Count=256;Count<512;Count++)
             Ptr[Count]=0;
     }
 
@@ -2116,6 +2658,12 @@ rme_ptr_t __RME_Pgt_Page_Unmap(struct RME_Cap_Pgt* Pgt_Op, rme_ptr_t Pos)
     if(RME_COMP_SWAP(&(Table[Pos]),Temp,0)==0)
         return RME_ERR_HAL_FAIL;
 
+    /* Make sure no CPU can still access the page */
+    if((Pgt_Op->Base&RME_PGT_TOP)!=0)
+        __RME_X64_TLB_Shootdown((rme_ptr_t)Table);
+    else
+        __RME_X64_TLB_Shootdown(0);
+
     return 0;
 }
 /* End Function:__RME_Pgt_Page_Unmap ***************************************/
@@ -2190,16 +2738,20 @@ rme_ptr_t __RME_Pgt_Pgdir_Unmap(struct RME_Cap_Pgt* Pgt_Parent, rme_ptr_t Pos,
     if((RME_PGT_SZORD(Pgt_Parent->Order)==RME_PGT_SIZE_4K)||((Temp&RME_X64_MMU_PDE_SUP)!=0))
         return RME_ERR_HAL_FAIL;
 
-    /* Is this child table mapped here? - check that in the future */
-
-    Child_Table=(rme_ptr_t*)Temp;
-    rme_ptr_t* Expected_Child_Table = RME_CAP_GETOBJ(Pgt_Child, rme_ptr_t*);
-    if (Child_Table != Expected_Child_Table)
+    /* Is this child table mapped here? The entry holds its physical address */
+    Child_Table=RME_CAP_GETOBJ(Pgt_Child,rme_ptr_t*);
+    if(RME_X64_MMU_ADDR(Temp)!=RME_X64_VA2PA(Child_Table))
         return RME_ERR_HAL_FAIL;
     /* Try to unmap it. Use CAS just in case */
     if(RME_COMP_SWAP(&(Parent_Table[Pos]),Temp,0)==0)
         return RME_ERR_HAL_FAIL;
 
+    /* Make sure no CPU can still access the directory */
+    if((Pgt_Parent->Base&RME_PGT_TOP)!=0)
+        __RME_X64_TLB_Shootdown((rme_ptr_t)Parent_Table);
+    else
+        __RME_X64_TLB_Shootdown(0);
+
     return 0;
 }
 /* End Function:__RME_Pgt_Pgdir_Unmap **************************************/
@@ -2334,6 +2886,209 @@ rme_ptr_t __RME_Pgt_Walk(struct RME_Cap_Pgt* Pgt_Op, rme_ptr_t Vaddr, rme_ptr_t*
     return 0;
 }
 
+/* Function:__RME_X64_Pgt_Entry_Mod *******************************************
+Description : Promote a page directory to a large page, or split a large page
+              into a page directory. Promotion requires that all 512 entries of
+              the child are pages with the same attributes that map contiguous
+              physical memory aligned to the size of the large page; the parent
+              entry is then atomically replaced with one 2M or 1G page. Splitting
+              requires a child directory that is empty or already holds exactly
+              the pages that the large page covers; it is filled in and then
+              atomically replaces the large page. In both cases the child must be
+              reachable only through the root capability passed in, which the
+              caller must have frozen, and which must be quiescent, as for a
+              deletion; this guarantees that no operation on the child is still
+              in progress. The capability is owned for the duration of the
+              operation. A promoted child is consumed: its capability stays
+              frozen and can only be deleted, and splitting needs another
+              directory. A split child, or one that failed any check after the
+              quiescence check, is live again. The TLBs are invalidated
+              afterwards in both cases.
+Input       : struct RME_Cap_Cpt* Cpt - The current capability table.
+              rme_cid_t Cap_Pgt - The capability to the parent page directory.
+              rme_ptr_t Param - D1: the frozen capability to the child page
+                                    directory;
+                                D0: the position in the parent page directory.
+              rme_ptr_t Type - The operation, promote or split.
+Output      : None.
+Return      : rme_ret_t - If successful, 0; else an error code.
+******************************************************************************/
+rme_ret_t __RME_X64_Pgt_Entry_Mod(struct RME_Cap_Cpt* Cpt, rme_cid_t Cap_Pgt,
+                                  rme_ptr_t Param, rme_ptr_t Type)
+{
+    struct RME_Cap_Pgt* Pgt_Parent;
+    struct RME_Cap_Pgt* Pgt_Child;
+    rme_ptr_t* Parent_Table;
+    rme_ptr_t* Child_Table;
+    rme_ptr_t Pos;
+    rme_ptr_t Size_Order;
+    rme_ptr_t Child_Order;
+    rme_ptr_t Child_Sup;
+    rme_ptr_t Dir;
+    rme_ptr_t Page;
+    rme_ptr_t Attr;
+    rme_ptr_t Count;
+    rme_ptr_t Type_Stat;
+    rme_ptr_t Vld_Stat;
+    rme_cid_t Cap_Child;
+
+    /* Get the capability slots - the child is frozen, so only get its slot */
+    RME_CPT_GETCAP(Cpt,Cap_Pgt,RME_CAP_TYPE_PGT,
+                   struct RME_Cap_Pgt*,Pgt_Parent,Type_Stat);
+    Cap_Child=(rme_cid_t)RME_PARAM_D1(Param);
+    if((((rme_ptr_t)Cap_Child)&RME_CID_2L)==0U)
+        RME_CPT_GETSLOT(Cpt,Cap_Child,struct RME_Cap_Pgt*,Pgt_Child);
+    else
+        RME_CPT_GETSLOT_2L(Cpt,Cap_Child,struct RME_Cap_Pgt*,Pgt_Child,Type_Stat);
+
+    /* The child must be frozen and quiescent, as for a deletion. It must also
+     * be an unreferenced root; frozen caps can't be delegated, so the refcnt
+     * check is stable */
+    Type_Stat=RME_READ_ACQUIRE(&(Pgt_Child->Head.Type_Stat));
+    if(RME_CAP_STAT(Type_Stat)!=RME_CAP_STAT_FROZEN)
+        return RME_ERR_CPT_FROZEN;
+    if(RME_CAP_TYPE(Type_Stat)!=RME_CAP_TYPE_PGT)
+        return RME_ERR_CPT_TYPE;
+    if(RME_CAP_QUIE(Pgt_Child->Head.Timestamp)==0U)
+        return RME_ERR_CPT_QUIE;
+    if((RME_CAP_ATTR(Type_Stat)!=RME_CAP_ATTR_ROOT)||(Pgt_Child->Head.Root_Ref!=0U))
+        return RME_ERR_CPT_REFCNT;
+
+    /* Restructuring is like constructing, so the same permissions are needed */
+    RME_CAP_CHECK(Pgt_Parent,RME_PGT_FLAG_CON_PARENT);
+    RME_CAP_CHECK(Pgt_Child,RME_PGT_FLAG_CHILD);
+
+    Pos=RME_PARAM_D0(Param);
+    if((Pos>RME_PGT_FLAG_HIGH(Pgt_Parent->Head.Flag))||
+       (Pos<RME_PGT_FLAG_LOW(Pgt_Parent->Head.Flag))||(Pos>=512))
+        return RME_ERR_KFN_FAIL;
+
+    /* Only 2M and 1G large pages exist, and the child must be the level below */
+    Size_Order=RME_PGT_SZORD(Pgt_Parent->Order);
+    if(Size_Order==RME_PGT_SIZE_2M)
+        Child_Sup=0;
+    else if(Size_Order==RME_PGT_SIZE_1G)
+    {
+        if((RME_X64_Feature.Ext[1][3]&RME_X64_E1_EDX_PDPE1GB)==0)
+            return RME_ERR_KFN_FAIL;
+        Child_Sup=RME_X64_MMU_PDE_SUP;
+    }
+    else
+        return RME_ERR_KFN_FAIL;
+
+    Child_Order=Size_Order-RME_PGT_NUM_512;
+    if((RME_PGT_SZORD(Pgt_Child->Order)!=Child_Order)||
+       (RME_PGT_NMORD(Pgt_Child->Order)!=RME_PGT_NUM_512))
+        return RME_ERR_KFN_FAIL;
+
+    if((Type!=RME_X64_KFN_PGT_ENTRY_MOD_PROMOTE)&&(Type!=RME_X64_KFN_PGT_ENTRY_MOD_SPLIT))
+        return RME_ERR_KFN_FAIL;
+
+    /* Own the child by marking it as creating, so that a racing removal,
+     * deletion or restructuring of the frozen slot fails; the type is cleared
+     * so that no lookup can take it for a usable cap meanwhile */
+    if(RME_COMP_SWAP(&(Pgt_Child->Head.Type_Stat),Type_Stat,
+                     RME_CAP_TYPE_STAT(RME_CAP_TYPE_NOP,
+                                       RME_CAP_STAT_CREATING,
+                                       RME_CAP_ATTR_ROOT))==RME_CASFAIL)
+        return RME_ERR_KFN_FAIL;
+    Vld_Stat=RME_CAP_TYPE_STAT(RME_CAP_TYPE_PGT,RME_CAP_STAT_VALID,RME_CAP_ATTR_ROOT);
+
+    Parent_Table=RME_CAP_GETOBJ(Pgt_Parent,rme_ptr_t*);
+    Child_Table=RME_CAP_GETOBJ(Pgt_Child,rme_ptr_t*);
+
+    if(Type==RME_X64_KFN_PGT_ENTRY_MOD_PROMOTE)
+    {
+        /* The parent entry must be the child directory */
+        Dir=Parent_Table[Pos];
+        if(((Dir&RME_X64_MMU_P)==0)||((Dir&RME_X64_MMU_PDE_SUP)!=0)||
+           (RME_X64_MMU_ADDR(Dir)!=RME_X64_VA2PA(Child_Table)))
+        {
+            RME_WRITE_RELEASE(&(Pgt_Child->Head.Type_Stat),Vld_Stat);
+            return RME_ERR_KFN_FAIL;
+        }
+
+        /* The first page decides the address and attributes of the large page */
+        Page=Child_Table[0];
+        if(((Page&RME_X64_MMU_P)==0)||((Page&RME_X64_MMU_PDE_SUP)!=Child_Sup)||
+           ((RME_X64_MMU_ADDR(Page)&(RME_POW2(Size_Order)-1U))!=0))
+        {
+            RME_WRITE_RELEASE(&(Pgt_Child->Head.Type_Stat),Vld_Stat);
+            return RME_ERR_KFN_FAIL;
+        }
+        Attr=RME_X64_MMU_ATTR(Page);
+
+        for(Count=1;Count<512;Count++)
+        {
+            if((RME_X64_MMU_ADDR(Child_Table[Count])!=(RME_X64_MMU_ADDR(Page)+(Count<<Child_Order)))||
+               (RME_X64_MMU_ATTR(Child_Table[Count])!=Attr))
+            {
+                RME_WRITE_RELEASE(&(Pgt_Child->Head.Type_Stat),Vld_Stat);
+                return RME_ERR_KFN_FAIL;
+            }
+        }
+
+        /* Replace the directory with the large page */
+        if(RME_COMP_SWAP(&(Parent_Table[Pos]),Dir,
+                         RME_X64_MMU_ADDR(Page)|(Attr&(~Child_Sup))|RME_X64_MMU_PDE_SUP)==RME_CASFAIL)
+        {
+            RME_WRITE_RELEASE(&(Pgt_Child->Head.Type_Stat),Vld_Stat);
+            return RME_ERR_KFN_FAIL;
+        }
+        /* The child is consumed and goes back to frozen, so it can only be
+         * deleted; nothing can have used it since the quiescence check */
+        RME_WRITE_RELEASE(&(Pgt_Child->Head.Type_Stat),Type_Stat);
+    }
+    else
+    {
+        /* The parent entry must be a large page */
+        Page=Parent_Table[Pos];
+        if(((Page&RME_X64_MMU_P)==0)||((Page&RME_X64_MMU_PDE_SUP)==0))
+        {
+            RME_WRITE_RELEASE(&(Pgt_Child->Head.Type_Stat),Vld_Stat);
+            return RME_ERR_KFN_FAIL;
+        }
+        Attr=(RME_X64_MMU_ATTR(Page)&(~RME_X64_MMU_PDE_SUP))|Child_Sup;
+
+        /* Check everything before filling anything in */
+        for(Count=0;Count<512;Count++)
+        {
+            Dir=Child_Table[Count];
+            if(Dir==0)
+                continue;
+            if((RME_X64_MMU_ADDR(Dir)!=(RME_X64_MMU_ADDR(Page)+(Count<<Child_Order)))||
+               (RME_X64_MMU_ATTR(Dir)!=Attr))
+            {
+                RME_WRITE_RELEASE(&(Pgt_Child->Head.Type_Stat),Vld_Stat);
+                return RME_ERR_KFN_FAIL;
+            }
+        }
+        for(Count=0;Count<512;Count++)
+        {
+            if(Child_Table[Count]==0)
+                Child_Table[Count]=(RME_X64_MMU_ADDR(Page)+(Count<<Child_Order))|Attr;
+        }
+
+        /* Replace the large page with the directory, which is live again */
+        if(RME_COMP_SWAP(&(Parent_Table[Pos]),Page,
+                         RME_X64_MMU_ADDR(RME_X64_VA2PA(Child_Table))|(Attr&(~Child_Sup)))==RME_CASFAIL)
+        {
+            RME_WRITE_RELEASE(&(Pgt_Child->Head.Type_Stat),Vld_Stat);
+            return RME_ERR_KFN_FAIL;
+        }
+        RME_WRITE_RELEASE(&(Pgt_Child->Head.Type_Stat),Vld_Stat);
+    }
+
+    /* The same addresses are now translated with a different page size */
+    if((Pgt_Parent->Base&RME_PGT_TOP)!=0)
+        __RME_X64_TLB_Shootdown((rme_ptr_t)Parent_Table);
+    else
+        __RME_X64_TLB_Shootdown(0);
+
+    return 0;
+}
+/* End Function:__RME_X64_Pgt_Entry_Mod **************************************/
+
 /*Function:__RME_Svc_Param_Get**************************************************
 Description:Get system call Params from Regs.
 ********************************************************************************/
@@ -2357,6 +3112,18 @@ void __RME_Svc_Retval_Set(struct RME_Reg_Struct* Reg,rme_ret_t Retval)
 }
 /*End Function:__RME_Svc_Retval_Set********************************************/
 
+/*Function:__RME_Svc_Pgr_Set****************************************************
+Description:Set fault information for a pager thread woken up by a fault.
+********************************************************************************/
+void __RME_Svc_Pgr_Set(struct RME_Reg_Struct* Reg,rme_ptr_t TID,struct RME_Exc_Struct* Exc)
+{
+    Reg->RSI=TID;
+    Reg->RDX=Exc->INT_NUM;
+    Reg->R8=Exc->ERROR_CODE;
+    Reg->R9=Exc->CR2;
+}
+/*End Function:__RME_Svc_Pgr_Set***********************************************/
+
 /*Function:__RME_Inv_Retval_Set**************************************************
 Description:Set invocation return values.
 ********************************************************************************/
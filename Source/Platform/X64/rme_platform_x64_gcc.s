@@ -117,6 +117,8 @@ AVX-512 registers:
     .global             __RME_X64_Halt
     /* Load page table */
     .global             __RME_X64_Pgt_Set
+    /* Get page fault linear address */
+    .global             __RME_X64_CR2_Get
     /* Acknowledge LAPIC interrupt */
     .global             __RME_X64_LAPIC_Ack
 
@@ -541,6 +543,17 @@ __RME_X64_Pgt_Set:
     RETQ
 /* End Function:__RME_X64_Pgt_Set ******************************************/
 
+/* Function:__RME_X64_CR2_Get *************************************************
+Description : Get the linear address that caused the last page fault.
+Input       : None.
+Output      : None.
+Return      : ptr_t - The content of CR2.
+******************************************************************************/
+__RME_X64_CR2_Get:
+    MOV                 %CR2,%RAX
+    RETQ
+/* End Function:__RME_X64_CR2_Get ********************************************/
+
 /* Function:__RME_Disable_Int *************************************************
 Description : The function for disabling all interrupts.
 Input       : None.